@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/checked_coroutine_test.dir/src/CheckedCoroutineTest.cpp.o"
+  "CMakeFiles/checked_coroutine_test.dir/src/CheckedCoroutineTest.cpp.o.d"
+  "checked_coroutine_test"
+  "checked_coroutine_test.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/checked_coroutine_test.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/checked_local_ptr_owner_test.dir/src/CheckedLocalPtrOwnerTest.cpp.o"
+  "CMakeFiles/checked_local_ptr_owner_test.dir/src/CheckedLocalPtrOwnerTest.cpp.o.d"
+  "checked_local_ptr_owner_test"
+  "checked_local_ptr_owner_test.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/checked_local_ptr_owner_test.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/checked_refcount_profiler_test.dir/src/CheckedRefcountProfilerTest.cpp.o"
+  "CMakeFiles/checked_refcount_profiler_test.dir/src/CheckedRefcountProfilerTest.cpp.o.d"
+  "checked_refcount_profiler_test"
+  "checked_refcount_profiler_test.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/checked_refcount_profiler_test.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,38 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/test/src/AtomicCheckedSharedPtrTest.cpp" "test/CMakeFiles/checked_shared_ptr_test.dir/src/AtomicCheckedSharedPtrTest.cpp.o" "gcc" "test/CMakeFiles/checked_shared_ptr_test.dir/src/AtomicCheckedSharedPtrTest.cpp.o.d"
+  "/root/repo/test/src/CheckedArrayTest.cpp" "test/CMakeFiles/checked_shared_ptr_test.dir/src/CheckedArrayTest.cpp.o" "gcc" "test/CMakeFiles/checked_shared_ptr_test.dir/src/CheckedArrayTest.cpp.o.d"
+  "/root/repo/test/src/CheckedBiasedRefCounterTest.cpp" "test/CMakeFiles/checked_shared_ptr_test.dir/src/CheckedBiasedRefCounterTest.cpp.o" "gcc" "test/CMakeFiles/checked_shared_ptr_test.dir/src/CheckedBiasedRefCounterTest.cpp.o.d"
+  "/root/repo/test/src/CheckedBlockResourceTest.cpp" "test/CMakeFiles/checked_shared_ptr_test.dir/src/CheckedBlockResourceTest.cpp.o" "gcc" "test/CMakeFiles/checked_shared_ptr_test.dir/src/CheckedBlockResourceTest.cpp.o.d"
+  "/root/repo/test/src/CheckedBulkTest.cpp" "test/CMakeFiles/checked_shared_ptr_test.dir/src/CheckedBulkTest.cpp.o" "gcc" "test/CMakeFiles/checked_shared_ptr_test.dir/src/CheckedBulkTest.cpp.o.d"
+  "/root/repo/test/src/CheckedDeferredReclaimTest.cpp" "test/CMakeFiles/checked_shared_ptr_test.dir/src/CheckedDeferredReclaimTest.cpp.o" "gcc" "test/CMakeFiles/checked_shared_ptr_test.dir/src/CheckedDeferredReclaimTest.cpp.o.d"
+  "/root/repo/test/src/CheckedHashTest.cpp" "test/CMakeFiles/checked_shared_ptr_test.dir/src/CheckedHashTest.cpp.o" "gcc" "test/CMakeFiles/checked_shared_ptr_test.dir/src/CheckedHashTest.cpp.o.d"
+  "/root/repo/test/src/CheckedIntrusivePtrTest.cpp" "test/CMakeFiles/checked_shared_ptr_test.dir/src/CheckedIntrusivePtrTest.cpp.o" "gcc" "test/CMakeFiles/checked_shared_ptr_test.dir/src/CheckedIntrusivePtrTest.cpp.o.d"
+  "/root/repo/test/src/CheckedLocalPtrTest.cpp" "test/CMakeFiles/checked_shared_ptr_test.dir/src/CheckedLocalPtrTest.cpp.o" "gcc" "test/CMakeFiles/checked_shared_ptr_test.dir/src/CheckedLocalPtrTest.cpp.o.d"
+  "/root/repo/test/src/CheckedLockFreeTest.cpp" "test/CMakeFiles/checked_shared_ptr_test.dir/src/CheckedLockFreeTest.cpp.o" "gcc" "test/CMakeFiles/checked_shared_ptr_test.dir/src/CheckedLockFreeTest.cpp.o.d"
+  "/root/repo/test/src/CheckedNullTelemetryTest.cpp" "test/CMakeFiles/checked_shared_ptr_test.dir/src/CheckedNullTelemetryTest.cpp.o" "gcc" "test/CMakeFiles/checked_shared_ptr_test.dir/src/CheckedNullTelemetryTest.cpp.o.d"
+  "/root/repo/test/src/CheckedObjectPoolTest.cpp" "test/CMakeFiles/checked_shared_ptr_test.dir/src/CheckedObjectPoolTest.cpp.o" "gcc" "test/CMakeFiles/checked_shared_ptr_test.dir/src/CheckedObjectPoolTest.cpp.o.d"
+  "/root/repo/test/src/CheckedPointerCastTest.cpp" "test/CMakeFiles/checked_shared_ptr_test.dir/src/CheckedPointerCastTest.cpp.o" "gcc" "test/CMakeFiles/checked_shared_ptr_test.dir/src/CheckedPointerCastTest.cpp.o.d"
+  "/root/repo/test/src/CheckedRcuTest.cpp" "test/CMakeFiles/checked_shared_ptr_test.dir/src/CheckedRcuTest.cpp.o" "gcc" "test/CMakeFiles/checked_shared_ptr_test.dir/src/CheckedRcuTest.cpp.o.d"
+  "/root/repo/test/src/CheckedSharedFromThisTest.cpp" "test/CMakeFiles/checked_shared_ptr_test.dir/src/CheckedSharedFromThisTest.cpp.o" "gcc" "test/CMakeFiles/checked_shared_ptr_test.dir/src/CheckedSharedFromThisTest.cpp.o.d"
+  "/root/repo/test/src/CheckedSharedPtrTest.cpp" "test/CMakeFiles/checked_shared_ptr_test.dir/src/CheckedSharedPtrTest.cpp.o" "gcc" "test/CMakeFiles/checked_shared_ptr_test.dir/src/CheckedSharedPtrTest.cpp.o.d"
+  "/root/repo/test/src/CheckedTaggedPtrTest.cpp" "test/CMakeFiles/checked_shared_ptr_test.dir/src/CheckedTaggedPtrTest.cpp.o" "gcc" "test/CMakeFiles/checked_shared_ptr_test.dir/src/CheckedTaggedPtrTest.cpp.o.d"
+  "/root/repo/test/src/CheckedViewTest.cpp" "test/CMakeFiles/checked_shared_ptr_test.dir/src/CheckedViewTest.cpp.o" "gcc" "test/CMakeFiles/checked_shared_ptr_test.dir/src/CheckedViewTest.cpp.o.d"
+  "/root/repo/test/src/CheckedWeakPtrTest.cpp" "test/CMakeFiles/checked_shared_ptr_test.dir/src/CheckedWeakPtrTest.cpp.o" "gcc" "test/CMakeFiles/checked_shared_ptr_test.dir/src/CheckedWeakPtrTest.cpp.o.d"
+  "/root/repo/test/src/NotNullCheckedSharedPtrTest.cpp" "test/CMakeFiles/checked_shared_ptr_test.dir/src/NotNullCheckedSharedPtrTest.cpp.o" "gcc" "test/CMakeFiles/checked_shared_ptr_test.dir/src/NotNullCheckedSharedPtrTest.cpp.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
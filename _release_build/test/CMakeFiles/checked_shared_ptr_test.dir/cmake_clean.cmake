@@ -0,0 +1,49 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/checked_shared_ptr_test.dir/src/AtomicCheckedSharedPtrTest.cpp.o"
+  "CMakeFiles/checked_shared_ptr_test.dir/src/AtomicCheckedSharedPtrTest.cpp.o.d"
+  "CMakeFiles/checked_shared_ptr_test.dir/src/CheckedArrayTest.cpp.o"
+  "CMakeFiles/checked_shared_ptr_test.dir/src/CheckedArrayTest.cpp.o.d"
+  "CMakeFiles/checked_shared_ptr_test.dir/src/CheckedBiasedRefCounterTest.cpp.o"
+  "CMakeFiles/checked_shared_ptr_test.dir/src/CheckedBiasedRefCounterTest.cpp.o.d"
+  "CMakeFiles/checked_shared_ptr_test.dir/src/CheckedBlockResourceTest.cpp.o"
+  "CMakeFiles/checked_shared_ptr_test.dir/src/CheckedBlockResourceTest.cpp.o.d"
+  "CMakeFiles/checked_shared_ptr_test.dir/src/CheckedBulkTest.cpp.o"
+  "CMakeFiles/checked_shared_ptr_test.dir/src/CheckedBulkTest.cpp.o.d"
+  "CMakeFiles/checked_shared_ptr_test.dir/src/CheckedDeferredReclaimTest.cpp.o"
+  "CMakeFiles/checked_shared_ptr_test.dir/src/CheckedDeferredReclaimTest.cpp.o.d"
+  "CMakeFiles/checked_shared_ptr_test.dir/src/CheckedHashTest.cpp.o"
+  "CMakeFiles/checked_shared_ptr_test.dir/src/CheckedHashTest.cpp.o.d"
+  "CMakeFiles/checked_shared_ptr_test.dir/src/CheckedIntrusivePtrTest.cpp.o"
+  "CMakeFiles/checked_shared_ptr_test.dir/src/CheckedIntrusivePtrTest.cpp.o.d"
+  "CMakeFiles/checked_shared_ptr_test.dir/src/CheckedLocalPtrTest.cpp.o"
+  "CMakeFiles/checked_shared_ptr_test.dir/src/CheckedLocalPtrTest.cpp.o.d"
+  "CMakeFiles/checked_shared_ptr_test.dir/src/CheckedLockFreeTest.cpp.o"
+  "CMakeFiles/checked_shared_ptr_test.dir/src/CheckedLockFreeTest.cpp.o.d"
+  "CMakeFiles/checked_shared_ptr_test.dir/src/CheckedNullTelemetryTest.cpp.o"
+  "CMakeFiles/checked_shared_ptr_test.dir/src/CheckedNullTelemetryTest.cpp.o.d"
+  "CMakeFiles/checked_shared_ptr_test.dir/src/CheckedObjectPoolTest.cpp.o"
+  "CMakeFiles/checked_shared_ptr_test.dir/src/CheckedObjectPoolTest.cpp.o.d"
+  "CMakeFiles/checked_shared_ptr_test.dir/src/CheckedPointerCastTest.cpp.o"
+  "CMakeFiles/checked_shared_ptr_test.dir/src/CheckedPointerCastTest.cpp.o.d"
+  "CMakeFiles/checked_shared_ptr_test.dir/src/CheckedRcuTest.cpp.o"
+  "CMakeFiles/checked_shared_ptr_test.dir/src/CheckedRcuTest.cpp.o.d"
+  "CMakeFiles/checked_shared_ptr_test.dir/src/CheckedSharedFromThisTest.cpp.o"
+  "CMakeFiles/checked_shared_ptr_test.dir/src/CheckedSharedFromThisTest.cpp.o.d"
+  "CMakeFiles/checked_shared_ptr_test.dir/src/CheckedSharedPtrTest.cpp.o"
+  "CMakeFiles/checked_shared_ptr_test.dir/src/CheckedSharedPtrTest.cpp.o.d"
+  "CMakeFiles/checked_shared_ptr_test.dir/src/CheckedTaggedPtrTest.cpp.o"
+  "CMakeFiles/checked_shared_ptr_test.dir/src/CheckedTaggedPtrTest.cpp.o.d"
+  "CMakeFiles/checked_shared_ptr_test.dir/src/CheckedViewTest.cpp.o"
+  "CMakeFiles/checked_shared_ptr_test.dir/src/CheckedViewTest.cpp.o.d"
+  "CMakeFiles/checked_shared_ptr_test.dir/src/CheckedWeakPtrTest.cpp.o"
+  "CMakeFiles/checked_shared_ptr_test.dir/src/CheckedWeakPtrTest.cpp.o.d"
+  "CMakeFiles/checked_shared_ptr_test.dir/src/NotNullCheckedSharedPtrTest.cpp.o"
+  "CMakeFiles/checked_shared_ptr_test.dir/src/NotNullCheckedSharedPtrTest.cpp.o.d"
+  "checked_shared_ptr_test"
+  "checked_shared_ptr_test.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/checked_shared_ptr_test.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
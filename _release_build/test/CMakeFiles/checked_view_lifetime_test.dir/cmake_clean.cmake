@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/checked_view_lifetime_test.dir/src/CheckedViewLifetimeTest.cpp.o"
+  "CMakeFiles/checked_view_lifetime_test.dir/src/CheckedViewLifetimeTest.cpp.o.d"
+  "checked_view_lifetime_test"
+  "checked_view_lifetime_test.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/checked_view_lifetime_test.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
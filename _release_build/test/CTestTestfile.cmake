@@ -0,0 +1,18 @@
+# CMake generated Testfile for 
+# Source directory: /root/repo/test
+# Build directory: /root/repo/_release_build/test
+# 
+# This file includes the relevant testing commands required for 
+# testing this directory and lists subdirectories to be tested as well.
+add_test(checked_shared_ptr_test "/root/repo/_release_build/test/checked_shared_ptr_test")
+set_tests_properties(checked_shared_ptr_test PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/test/CMakeLists.txt;28;add_test;/root/repo/test/CMakeLists.txt;0;")
+add_test(checked_coroutine_test "/root/repo/_release_build/test/checked_coroutine_test")
+set_tests_properties(checked_coroutine_test PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/test/CMakeLists.txt;38;add_test;/root/repo/test/CMakeLists.txt;0;")
+add_test(checked_view_lifetime_test "/root/repo/_release_build/test/checked_view_lifetime_test")
+set_tests_properties(checked_view_lifetime_test PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/test/CMakeLists.txt;48;add_test;/root/repo/test/CMakeLists.txt;0;")
+add_test(checked_local_ptr_owner_test "/root/repo/_release_build/test/checked_local_ptr_owner_test")
+set_tests_properties(checked_local_ptr_owner_test PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/test/CMakeLists.txt;56;add_test;/root/repo/test/CMakeLists.txt;0;")
+add_test(checked_refcount_profiler_test "/root/repo/_release_build/test/checked_refcount_profiler_test")
+set_tests_properties(checked_refcount_profiler_test PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/test/CMakeLists.txt;65;add_test;/root/repo/test/CMakeLists.txt;0;")
+add_test(not_null_codegen "/usr/bin/cmake" "-DCOMPILER=/usr/bin/c++" "-DINCLUDE_DIR=/root/repo/include" "-DSOURCE=/root/repo/test/codegen/NotNullCodegen.cpp" "-DPROCESSOR=x86_64" "-P" "/root/repo/test/codegen/CheckCodegen.cmake")
+set_tests_properties(not_null_codegen PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/test/CMakeLists.txt;70;add_test;/root/repo/test/CMakeLists.txt;0;")
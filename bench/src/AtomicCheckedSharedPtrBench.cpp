@@ -0,0 +1,120 @@
+#include "atomic_checked_shared_ptr.hpp"
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <mutex>
+#include <thread>
+
+// Many readers and one writer publishing configuration snapshots. Thread 0 keeps replacing the snapshot, all other
+// threads load it and read a field. Only reader throughput is reported.
+//
+
+namespace
+{
+
+struct Config
+{
+    explicit Config(std::int64_t version) : m_version(version)
+    {
+    }
+
+    std::int64_t m_version{};
+};
+
+struct AtomicSlot
+{
+    sia::atomic_checked_shared_ptr<Config> m_slot{sia::make_checked_shared<Config>(0)};
+
+    sia::checked_shared_ptr<Config> load()
+    {
+        return m_slot.load();
+    }
+
+    void store(sia::checked_shared_ptr<Config> config)
+    {
+        m_slot.store(std::move(config));
+    }
+};
+
+// std::atomic_load/std::atomic_store for std::shared_ptr, which libstdc++ implements with a pool of mutexes.
+//
+struct StdAtomicSlot
+{
+    std::shared_ptr<Config> m_slot{std::make_shared<Config>(0)};
+
+    sia::checked_shared_ptr<Config> load()
+    {
+        return std::atomic_load(&m_slot);
+    }
+
+    void store(sia::checked_shared_ptr<Config> config)
+    {
+        std::atomic_store(&m_slot, config.managedSharedPointer());
+    }
+};
+
+struct MutexSlot
+{
+    std::mutex m_mutex{};
+    sia::checked_shared_ptr<Config> m_slot{sia::make_checked_shared<Config>(0)};
+
+    sia::checked_shared_ptr<Config> load()
+    {
+        std::lock_guard<std::mutex> lock{m_mutex};
+        return m_slot;
+    }
+
+    void store(sia::checked_shared_ptr<Config> config)
+    {
+        std::lock_guard<std::mutex> lock{m_mutex};
+        m_slot.swap(config);
+    }
+};
+
+}  // namespace
+
+template <typename Slot>
+void BM_PublishReaders(benchmark::State &state)
+{
+    static Slot slot{};
+
+    if (state.thread_index() == 0)
+    {
+        std::int64_t version{};
+        for (auto _ : state)
+            slot.store(sia::make_checked_shared<Config>(++version));
+
+        return;
+    }
+
+    std::int64_t loads{};
+    for (auto _ : state)
+    {
+        auto config = slot.load();
+        benchmark::DoNotOptimize(config->m_version);
+        ++loads;
+    }
+
+    state.SetItemsProcessed(loads);
+}
+
+static const int kMaxPublishThreads = static_cast<int>(std::max(2U, std::thread::hardware_concurrency()));
+
+BENCHMARK_TEMPLATE(BM_PublishReaders, AtomicSlot)->ThreadRange(2, kMaxPublishThreads)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_PublishReaders, StdAtomicSlot)->ThreadRange(2, kMaxPublishThreads)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_PublishReaders, MutexSlot)->ThreadRange(2, kMaxPublishThreads)->UseRealTime();
+
+template <typename Slot>
+void BM_LoadUncontended(benchmark::State &state)
+{
+    Slot slot{};
+
+    for (auto _ : state)
+    {
+        auto config = slot.load();
+        benchmark::DoNotOptimize(config->m_version);
+    }
+}
+
+BENCHMARK_TEMPLATE(BM_LoadUncontended, AtomicSlot);
+BENCHMARK_TEMPLATE(BM_LoadUncontended, StdAtomicSlot);
+BENCHMARK_TEMPLATE(BM_LoadUncontended, MutexSlot);
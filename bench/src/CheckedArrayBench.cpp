@@ -0,0 +1,108 @@
+#include "checked_shared_ptr.hpp"
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+// Creating and dropping a message buffer: a header and a payload of state.range(0) bytes. With a separate payload it
+// takes two allocations, or three with a std::vector in a shared header. with_trailing puts the control block, the
+// header and the payload into one.
+//
+
+namespace
+{
+
+struct Header
+{
+    std::uint64_t m_sequence{};
+    std::uint32_t m_topic{};
+};
+
+struct VectorMessage
+{
+    Header m_header{};
+    std::vector<std::uint8_t> m_payload;
+};
+
+struct SplitMessage
+{
+    Header m_header{};
+    std::shared_ptr<std::uint8_t[]> m_payload; //NOLINT(modernize-avoid-c-arrays)
+};
+
+}  // namespace
+
+static void BM_MessageVector(benchmark::State &state)
+{
+    const auto size = static_cast<std::size_t>(state.range(0));
+
+    for (auto _ : state)
+    {
+        auto message = sia::make_checked_shared<VectorMessage>();
+        message->m_payload.resize(size);
+        std::memset(message->m_payload.data(), 1, size);
+        benchmark::DoNotOptimize(message);
+    }
+}
+
+static void BM_MessageSplit(benchmark::State &state)
+{
+    const auto size = static_cast<std::size_t>(state.range(0));
+
+    for (auto _ : state)
+    {
+        auto message = sia::make_checked_shared<SplitMessage>();
+        message->m_payload.reset(new std::uint8_t[size]); //NOLINT(cppcoreguidelines-owning-memory)
+        std::memset(message->m_payload.get(), 1, size);
+        benchmark::DoNotOptimize(message);
+    }
+}
+
+static void BM_MessageTrailing(benchmark::State &state)
+{
+    const auto size = static_cast<std::size_t>(state.range(0));
+
+    for (auto _ : state)
+    {
+        auto message = sia::make_checked_shared<sia::with_trailing<Header, std::uint8_t>>(size);
+        std::memset(message->trailingData(), 1, size);
+        benchmark::DoNotOptimize(message);
+    }
+}
+
+static void BM_ArrayIndexUnchecked(benchmark::State &state)
+{
+    const auto size = static_cast<std::size_t>(state.range(0));
+    std::shared_ptr<std::uint32_t[]> values(new std::uint32_t[size]()); //NOLINT(modernize-avoid-c-arrays)
+
+    for (auto _ : state)
+    {
+        std::uint32_t sum = 0;
+        for (std::ptrdiff_t i = 0; i < state.range(0); ++i)
+            sum += values[i];
+        benchmark::DoNotOptimize(sum);
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void BM_ArrayIndexChecked(benchmark::State &state)
+{
+    auto values = sia::make_checked_shared<std::uint32_t[]>(static_cast<std::size_t>(state.range(0)));
+
+    for (auto _ : state)
+    {
+        std::uint32_t sum = 0;
+        for (std::ptrdiff_t i = 0; i < state.range(0); ++i)
+            sum += values[i];
+        benchmark::DoNotOptimize(sum);
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(BM_MessageVector)->Arg(64)->Arg(512)->Arg(4096);
+BENCHMARK(BM_MessageSplit)->Arg(64)->Arg(512)->Arg(4096);
+BENCHMARK(BM_MessageTrailing)->Arg(64)->Arg(512)->Arg(4096);
+BENCHMARK(BM_ArrayIndexUnchecked)->Arg(1024);
+BENCHMARK(BM_ArrayIndexChecked)->Arg(1024);
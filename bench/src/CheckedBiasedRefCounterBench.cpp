@@ -0,0 +1,110 @@
+#include "checked_biased_ref_counter.hpp"
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+// Copies and releases of one object, biased against plain atomic counting and checked_shared_ptr:
+//  - owner only: the thread which created the object is the only one to copy it,
+//  - mixed: the creating thread and other threads copy it at the same time,
+//  - shared: the object comes from a thread which has exited, every copy is a foreign one.
+//
+
+struct SharedDocument
+{
+    std::int64_t m_value{1};
+};
+
+struct IntrusiveDocument : sia::checked_intrusive_ref_counter<IntrusiveDocument>
+{
+    std::int64_t m_value{1};
+};
+
+struct BiasedDocument : sia::checked_biased_ref_counter<BiasedDocument>
+{
+    std::int64_t m_value{1};
+};
+
+template <typename Document>
+struct DocumentTraits
+{
+    using Ptr = sia::checked_intrusive_ptr<Document>;
+
+    static Ptr make()
+    {
+        return sia::make_checked_intrusive<Document>();
+    }
+};
+
+template <>
+struct DocumentTraits<SharedDocument>
+{
+    using Ptr = sia::checked_shared_ptr<SharedDocument>;
+
+    static Ptr make()
+    {
+        return sia::make_checked_shared<SharedDocument>();
+    }
+};
+
+static constexpr std::size_t kCopies = 16;
+
+template <typename Ptr>
+void copyAndRelease(benchmark::State &state, const Ptr &document)
+{
+    std::vector<Ptr> copies(kCopies);
+
+    for (auto _ : state)
+    {
+        for (auto &copy : copies)
+            copy = document;
+
+        benchmark::DoNotOptimize(copies.data());
+
+        for (auto &copy : copies)
+            copy = nullptr;
+    }
+
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * kCopies));
+}
+
+template <typename Document>
+void BM_OwnerOnly(benchmark::State &state)
+{
+    auto document = DocumentTraits<Document>::make();
+    copyAndRelease(state, document);
+}
+
+// The document belongs to the thread which gets here first, usually the main thread which runs benchmark thread 0.
+//
+template <typename Document>
+void BM_Mixed(benchmark::State &state)
+{
+    static const auto document = DocumentTraits<Document>::make();
+    copyAndRelease(state, document);
+}
+
+template <typename Document>
+void BM_Shared(benchmark::State &state)
+{
+    static const auto document = []
+    {
+        typename DocumentTraits<Document>::Ptr made{};
+        std::thread([&made] { made = DocumentTraits<Document>::make(); }).join();
+        return made;
+    }();
+
+    copyAndRelease(state, document);
+}
+
+static const int kMaxThreads = static_cast<int>(std::max(4U, std::thread::hardware_concurrency()));
+
+BENCHMARK_TEMPLATE(BM_OwnerOnly, SharedDocument);
+BENCHMARK_TEMPLATE(BM_OwnerOnly, IntrusiveDocument);
+BENCHMARK_TEMPLATE(BM_OwnerOnly, BiasedDocument);
+BENCHMARK_TEMPLATE(BM_Mixed, SharedDocument)->ThreadRange(2, kMaxThreads)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_Mixed, IntrusiveDocument)->ThreadRange(2, kMaxThreads)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_Mixed, BiasedDocument)->ThreadRange(2, kMaxThreads)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_Shared, SharedDocument)->ThreadRange(1, kMaxThreads)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_Shared, IntrusiveDocument)->ThreadRange(1, kMaxThreads)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_Shared, BiasedDocument)->ThreadRange(1, kMaxThreads)->UseRealTime();
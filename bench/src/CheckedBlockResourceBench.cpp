@@ -0,0 +1,152 @@
+#include "checked_block_resource.hpp"
+#include "checked_shared_ptr.hpp"
+#include <benchmark/benchmark.h>
+#include <array>
+#include <vector>
+
+// A request-scoped workload: create range(0) objects, use them and drop them all when the request ends. The global
+// heap path is compared with a monotonic arena and with fixed_block_resource. Every path goes through a counting
+// resource so that the report shows how many allocations reach the upstream per request.
+//
+
+namespace
+{
+
+class CountingResource : public std::pmr::memory_resource
+{
+    public:
+    std::int64_t m_allocations{};
+
+    protected:
+    void *do_allocate(std::size_t bytes, std::size_t alignment) override
+    {
+        ++m_allocations;
+        return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+    }
+
+    void do_deallocate(void *ptr, std::size_t bytes, std::size_t alignment) override
+    {
+        std::pmr::new_delete_resource()->deallocate(ptr, bytes, alignment);
+    }
+
+    [[nodiscard]] bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override
+    {
+        return this == &other;
+    }
+};
+
+struct RequestObject
+{
+    std::int64_t m_id{};
+    std::array<char, 48> m_payload{};
+};
+
+void reportAllocations(benchmark::State &state, const CountingResource &upstream)
+{
+    state.counters["upstream_allocs"] =
+        benchmark::Counter(static_cast<double>(upstream.m_allocations), benchmark::Counter::kAvgIterations);
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+}  // namespace
+
+static void BM_RequestGlobalHeap(benchmark::State &state)
+{
+    CountingResource upstream{};
+    std::pmr::polymorphic_allocator<RequestObject> alloc{&upstream};
+    std::vector<sia::checked_shared_ptr<RequestObject>> objects(static_cast<std::size_t>(state.range(0)));
+
+    for (auto _ : state)
+    {
+        for (auto &object : objects)
+            object = sia::allocate_checked_shared<RequestObject>(alloc);
+
+        benchmark::DoNotOptimize(objects.data());
+        std::fill(objects.begin(), objects.end(), nullptr);
+    }
+
+    reportAllocations(state, upstream);
+}
+
+static void BM_RequestMakeCheckedShared(benchmark::State &state)
+{
+    std::vector<sia::checked_shared_ptr<RequestObject>> objects(static_cast<std::size_t>(state.range(0)));
+
+    for (auto _ : state)
+    {
+        for (auto &object : objects)
+            object = sia::make_checked_shared<RequestObject>();
+
+        benchmark::DoNotOptimize(objects.data());
+        std::fill(objects.begin(), objects.end(), nullptr);
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void BM_RequestMonotonicArena(benchmark::State &state)
+{
+    CountingResource upstream{};
+    std::vector<sia::checked_shared_ptr<RequestObject>> objects(static_cast<std::size_t>(state.range(0)));
+
+    for (auto _ : state)
+    {
+        std::pmr::monotonic_buffer_resource arena{&upstream};
+        std::pmr::polymorphic_allocator<RequestObject> alloc{&arena};
+
+        for (auto &object : objects)
+            object = sia::allocate_checked_shared<RequestObject>(alloc);
+
+        benchmark::DoNotOptimize(objects.data());
+        std::fill(objects.begin(), objects.end(), nullptr);
+    }
+
+    reportAllocations(state, upstream);
+}
+
+static void BM_RequestFixedBlockResource(benchmark::State &state)
+{
+    CountingResource upstream{};
+    std::vector<sia::checked_shared_ptr<RequestObject>> objects(static_cast<std::size_t>(state.range(0)));
+
+    for (auto _ : state)
+    {
+        sia::fixed_block_resource resource{static_cast<std::size_t>(state.range(0)), &upstream};
+        std::pmr::polymorphic_allocator<RequestObject> alloc{&resource};
+
+        for (auto &object : objects)
+            object = sia::allocate_checked_shared<RequestObject>(alloc);
+
+        benchmark::DoNotOptimize(objects.data());
+        std::fill(objects.begin(), objects.end(), nullptr);
+    }
+
+    reportAllocations(state, upstream);
+}
+
+// A long living pool which recycles blocks across requests, no upstream traffic at all after warm-up.
+//
+static void BM_RequestFixedBlockResourceReused(benchmark::State &state)
+{
+    CountingResource upstream{};
+    sia::fixed_block_resource resource{static_cast<std::size_t>(state.range(0)), &upstream};
+    std::pmr::polymorphic_allocator<RequestObject> alloc{&resource};
+    std::vector<sia::checked_shared_ptr<RequestObject>> objects(static_cast<std::size_t>(state.range(0)));
+
+    for (auto _ : state)
+    {
+        for (auto &object : objects)
+            object = sia::allocate_checked_shared<RequestObject>(alloc);
+
+        benchmark::DoNotOptimize(objects.data());
+        std::fill(objects.begin(), objects.end(), nullptr);
+    }
+
+    reportAllocations(state, upstream);
+}
+
+BENCHMARK(BM_RequestMakeCheckedShared)->Range(1 << 4, 1 << 12);
+BENCHMARK(BM_RequestGlobalHeap)->Range(1 << 4, 1 << 12);
+BENCHMARK(BM_RequestMonotonicArena)->Range(1 << 4, 1 << 12);
+BENCHMARK(BM_RequestFixedBlockResource)->Range(1 << 4, 1 << 12);
+BENCHMARK(BM_RequestFixedBlockResourceReused)->Range(1 << 4, 1 << 12);
@@ -0,0 +1,149 @@
+#include "checked_bulk.hpp"
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// Bulk operations over state.range(0) handles: copying and destroying handles which share one object, scanning for
+// nulls and moving the handles into a larger buffer as a growing container does.
+//
+
+namespace
+{
+
+struct Node : sia::checked_intrusive_ref_counter<Node>
+{
+    std::int64_t m_value{};
+};
+
+template <typename T>
+struct Storage
+{
+    explicit Storage(std::size_t n) : m_bytes(std::make_unique<std::byte[]>(n * sizeof(T))) //NOLINT(modernize-avoid-c-arrays)
+    {
+    }
+
+    T *data() noexcept
+    {
+        return reinterpret_cast<T *>(m_bytes.get());
+    }
+
+    std::unique_ptr<std::byte[]> m_bytes; //NOLINT(modernize-avoid-c-arrays)
+};
+
+}  // namespace
+
+static void BM_CopyDestroyOneByOne(benchmark::State &state)
+{
+    const auto count = static_cast<std::size_t>(state.range(0));
+    std::vector<sia::checked_intrusive_ptr<Node>> nodes(count, sia::make_checked_intrusive<Node>());
+    Storage<sia::checked_intrusive_ptr<Node>> copies{count};
+
+    for (auto _ : state)
+    {
+        auto *end = std::uninitialized_copy(nodes.data(), nodes.data() + count, copies.data());
+        benchmark::DoNotOptimize(copies.data());
+        std::destroy(copies.data(), end);
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void BM_CopyDestroyCoalesced(benchmark::State &state)
+{
+    const auto count = static_cast<std::size_t>(state.range(0));
+    std::vector<sia::checked_intrusive_ptr<Node>> nodes(count, sia::make_checked_intrusive<Node>());
+    Storage<sia::checked_intrusive_ptr<Node>> copies{count};
+
+    for (auto _ : state)
+    {
+        auto *end = sia::uninitialized_copy_coalesced(nodes.data(), nodes.data() + count, copies.data());
+        benchmark::DoNotOptimize(copies.data());
+        sia::destroy_coalesced(copies.data(), end);
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void BM_NullScanOneByOne(benchmark::State &state)
+{
+    const auto count = static_cast<std::size_t>(state.range(0));
+    std::vector<sia::checked_shared_ptr<std::int64_t>> values(count, sia::make_checked_shared<std::int64_t>(1));
+
+    for (auto _ : state)
+    {
+        bool all = true;
+        for (const auto &value : values)
+        {
+            if (!value)
+            {
+                all = false;
+                break;
+            }
+        }
+        benchmark::DoNotOptimize(all);
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void BM_NullScanBlocked(benchmark::State &state)
+{
+    const auto count = static_cast<std::size_t>(state.range(0));
+    std::vector<sia::checked_shared_ptr<std::int64_t>> values(count, sia::make_checked_shared<std::int64_t>(1));
+
+    for (auto _ : state)
+    {
+        bool all = sia::all_non_null(values.data(), values.data() + count);
+        benchmark::DoNotOptimize(all);
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void BM_GrowMoveDestroy(benchmark::State &state)
+{
+    const auto count = static_cast<std::size_t>(state.range(0));
+    Storage<sia::checked_shared_ptr<std::int64_t>> from{count};
+    Storage<sia::checked_shared_ptr<std::int64_t>> to{count};
+    std::uninitialized_fill_n(from.data(), count, sia::make_checked_shared<std::int64_t>(1));
+
+    for (auto _ : state)
+    {
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            ::new (static_cast<void *>(to.data() + i)) sia::checked_shared_ptr<std::int64_t>(std::move(from.data()[i]));
+            std::destroy_at(from.data() + i);
+        }
+        benchmark::DoNotOptimize(to.data());
+        std::swap(from, to);
+    }
+
+    std::destroy(from.data(), from.data() + count);
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void BM_GrowRelocate(benchmark::State &state)
+{
+    const auto count = static_cast<std::size_t>(state.range(0));
+    Storage<sia::checked_shared_ptr<std::int64_t>> from{count};
+    Storage<sia::checked_shared_ptr<std::int64_t>> to{count};
+    std::uninitialized_fill_n(from.data(), count, sia::make_checked_shared<std::int64_t>(1));
+
+    for (auto _ : state)
+    {
+        sia::uninitialized_relocate(from.data(), from.data() + count, to.data());
+        benchmark::DoNotOptimize(to.data());
+        std::swap(from, to);
+    }
+
+    std::destroy(from.data(), from.data() + count);
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(BM_CopyDestroyOneByOne)->Arg(1024);
+BENCHMARK(BM_CopyDestroyCoalesced)->Arg(1024);
+BENCHMARK(BM_NullScanOneByOne)->Arg(1024);
+BENCHMARK(BM_NullScanBlocked)->Arg(1024);
+BENCHMARK(BM_GrowMoveDestroy)->Arg(1024);
+BENCHMARK(BM_GrowRelocate)->Arg(1024);
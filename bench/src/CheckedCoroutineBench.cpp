@@ -0,0 +1,125 @@
+#include "checked_coroutine.hpp"
+#include <benchmark/benchmark.h>
+
+// Built as C++20, see bench/CMakeLists.txt.
+//
+#if defined(__cpp_impl_coroutine) && __has_include(<coroutine>)
+
+#include <cstdint>
+#include <memory_resource>
+
+// Starting and finishing a request handler coroutine which keeps its request alive, with the frame from the global
+// operator new or from the pool the request comes from, and with the request pinned by a parameter copy or by
+// keep_alive(this).
+//
+
+namespace
+{
+
+struct Task
+{
+    struct promise_type : sia::checked_frame_allocation //NOLINT(readability-identifier-naming)
+    {
+        Task get_return_object() noexcept //NOLINT(readability-identifier-naming)
+        {
+            return {};
+        }
+
+        std::suspend_never initial_suspend() noexcept //NOLINT(readability-identifier-naming)
+        {
+            return {};
+        }
+
+        std::suspend_never final_suspend() noexcept //NOLINT(readability-identifier-naming)
+        {
+            return {};
+        }
+
+        void return_void() noexcept //NOLINT(readability-identifier-naming)
+        {
+        }
+
+        void unhandled_exception() noexcept //NOLINT(readability-identifier-naming)
+        {
+        }
+    };
+};
+
+// GCC 12 pairs the templated operator new of checked_frame_allocation with its usual operator delete and warns at
+// every coroutine below.
+//
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+struct Request : std::enable_shared_from_this<Request>
+{
+    Task handle(std::int64_t &sum)
+    {
+        auto self = co_await sia::keep_alive(this);
+        co_await std::suspend_never{};
+        sum += self->m_id;
+    }
+
+    std::int64_t m_id{1};
+};
+
+Task handleByCopy(sia::checked_shared_ptr<Request> request, std::int64_t &sum)
+{
+    co_await std::suspend_never{};
+    sum += request->m_id;
+}
+
+Task handleInArena(std::allocator_arg_t /*tag*/, std::pmr::memory_resource * /*resource*/,
+                   sia::checked_shared_ptr<Request> request, std::int64_t &sum)
+{
+    co_await std::suspend_never{};
+    sum += request->m_id;
+}
+
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+}  // namespace
+
+static void BM_FrameGlobalNew(benchmark::State &state)
+{
+    auto request = sia::make_checked_shared<Request>();
+    std::int64_t sum = 0;
+
+    for (auto _ : state)
+        handleByCopy(request, sum);
+
+    benchmark::DoNotOptimize(sum);
+}
+
+static void BM_FrameFromPool(benchmark::State &state)
+{
+    std::pmr::unsynchronized_pool_resource pool{};
+    auto request = sia::allocate_checked_shared<Request>(std::pmr::polymorphic_allocator<Request>{&pool});
+    std::int64_t sum = 0;
+
+    for (auto _ : state)
+        handleInArena(std::allocator_arg, &pool, request, sum);
+
+    benchmark::DoNotOptimize(sum);
+}
+
+static void BM_PinByKeepAlive(benchmark::State &state)
+{
+    auto request = sia::make_checked_shared<Request>();
+    std::int64_t sum = 0;
+
+    for (auto _ : state)
+        request->handle(sum);
+
+    benchmark::DoNotOptimize(sum);
+}
+
+BENCHMARK(BM_FrameGlobalNew);
+BENCHMARK(BM_FrameFromPool);
+BENCHMARK(BM_PinByKeepAlive);
+
+#endif
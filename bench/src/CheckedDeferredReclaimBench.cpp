@@ -0,0 +1,96 @@
+#include "checked_deferred_reclaim.hpp"
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <vector>
+
+// Latency of dropping the last reference to a deep tree on the hot thread, destroyed inline, queued to the batch of
+// the thread and flushed afterwards at a safe point, or queued to the background thread. The p50/p99/max counters
+// are the distribution of the drop itself, in microseconds.
+//
+
+namespace
+{
+
+struct BranchNode
+{
+    std::vector<sia::checked_shared_ptr<BranchNode>> m_children{};
+    std::array<char, 64> m_payload{};
+};
+
+constexpr int kFanOut = 4;
+constexpr int kDepth = 6;
+
+template <typename Make>
+sia::checked_shared_ptr<BranchNode> makeBranch(const Make &make, int depth)
+{
+    auto node = make();
+
+    if (depth > 0)
+    {
+        for (int i = 0; i < kFanOut; ++i)
+            node->m_children.push_back(makeBranch(make, depth - 1));
+    }
+
+    return node;
+}
+
+template <typename Make, typename SafePoint>
+void dropDeepTree(benchmark::State &state, const Make &make, const SafePoint &safe_point)
+{
+    std::vector<double> latencies{};
+
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        auto root = makeBranch(make, kDepth);
+        state.ResumeTiming();
+
+        const auto begin = std::chrono::steady_clock::now();
+        root = nullptr;
+        const auto end = std::chrono::steady_clock::now();
+
+        state.PauseTiming();
+        latencies.push_back(std::chrono::duration<double, std::micro>(end - begin).count());
+        safe_point();
+        state.ResumeTiming();
+    }
+
+    std::sort(latencies.begin(), latencies.end());
+
+    auto percentile = [&latencies](double p)
+    { return latencies[std::min(latencies.size() - 1, static_cast<std::size_t>(p * latencies.size()))]; };
+
+    state.counters["p50_us"] = percentile(0.50);
+    state.counters["p99_us"] = percentile(0.99);
+    state.counters["max_us"] = latencies.back();
+}
+
+}  // namespace
+
+static void BM_DropDeepTreeInline(benchmark::State &state)
+{
+    dropDeepTree(
+        state, [] { return sia::make_checked_shared<BranchNode>(); }, [] {});
+}
+
+static void BM_DropDeepTreeSafePoint(benchmark::State &state)
+{
+    dropDeepTree(
+        state, [] { return sia::make_checked_shared<BranchNode>(sia::reclaim_at_safe_point); },
+        [] { sia::reclamation_queue::threadBatch()->flush(); });
+}
+
+static void BM_DropDeepTreeBackground(benchmark::State &state)
+{
+    sia::reclamation_queue queue{};
+    queue.start();
+
+    dropDeepTree(
+        state, [&queue] { return sia::make_checked_shared<BranchNode>(sia::reclaim_on(queue)); }, [] {});
+}
+
+BENCHMARK(BM_DropDeepTreeInline)->Iterations(500);
+BENCHMARK(BM_DropDeepTreeSafePoint)->Iterations(500);
+BENCHMARK(BM_DropDeepTreeBackground)->Iterations(500);
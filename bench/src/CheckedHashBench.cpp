@@ -0,0 +1,140 @@
+#include "checked_shared_ptr.hpp"
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+// Lookups of checked_shared_ptr keys in two flat containers:
+// - an open addressing set with linear probing and a power of two capacity, which takes the slot from the low bits
+//   of the hash. With the identity hash of the address those bits are the same for all heap allocations.
+// - a sorted vector, searched either by a temporary checked_shared_ptr or by the raw pointer via checked_ptr_less.
+//
+
+namespace
+{
+
+struct IdentityHash
+{
+    std::size_t operator()(const sia::checked_shared_ptr<std::int64_t> &key) const noexcept
+    {
+        return std::hash<std::int64_t *>()(key.get());
+    }
+};
+
+template <typename Hash>
+class FlatSet
+{
+    public:
+    explicit FlatSet(std::size_t capacity) : m_slots(capacity), m_mask(capacity - 1)
+    {
+    }
+
+    void insert(const sia::checked_shared_ptr<std::int64_t> &key)
+    {
+        std::size_t slot = Hash()(key) & m_mask;
+        while (m_slots[slot] != nullptr)
+            slot = (slot + 1) & m_mask;
+
+        m_slots[slot] = key;
+    }
+
+    bool contains(const sia::checked_shared_ptr<std::int64_t> &key) const noexcept
+    {
+        for (std::size_t slot = Hash()(key) & m_mask;; slot = (slot + 1) & m_mask)
+        {
+            if (m_slots[slot] == key)
+                return true;
+
+            if (m_slots[slot] == nullptr)
+                return false;
+        }
+    }
+
+    private:
+    std::vector<sia::checked_shared_ptr<std::int64_t>> m_slots;
+    std::size_t m_mask;
+};
+
+std::vector<sia::checked_shared_ptr<std::int64_t>> makeKeys(std::size_t count)
+{
+    std::vector<sia::checked_shared_ptr<std::int64_t>> keys{};
+    for (std::size_t i = 0; i < count; ++i)
+        keys.push_back(sia::make_checked_shared<std::int64_t>(static_cast<std::int64_t>(i)));
+
+    return keys;
+}
+
+template <typename Hash>
+void flatSetLookup(benchmark::State &state)
+{
+    const auto count = static_cast<std::size_t>(state.range(0));
+    const auto keys = makeKeys(count);
+
+    FlatSet<Hash> set{count * 2};
+    for (const auto &key : keys)
+        set.insert(key);
+
+    for (auto _ : state)
+    {
+        std::size_t found = 0;
+        for (const auto &key : keys)
+            found += set.contains(key) ? 1 : 0;
+        benchmark::DoNotOptimize(found);
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+}  // namespace
+
+static void BM_FlatSetIdentityHash(benchmark::State &state)
+{
+    flatSetLookup<IdentityHash>(state);
+}
+
+static void BM_FlatSetMixingHash(benchmark::State &state)
+{
+    flatSetLookup<sia::checked_ptr_hash>(state);
+}
+
+static void BM_FlatMapLookupByTemporary(benchmark::State &state)
+{
+    const auto probes = makeKeys(static_cast<std::size_t>(state.range(0)));
+    auto keys = probes;
+    std::sort(keys.begin(), keys.end(), sia::checked_ptr_less());
+
+    for (auto _ : state)
+    {
+        std::size_t found = 0;
+        for (const auto &probe : probes)
+        {
+            const sia::checked_shared_ptr<std::int64_t> key = probe;
+            found += std::binary_search(keys.begin(), keys.end(), key, sia::checked_ptr_less()) ? 1 : 0;
+        }
+        benchmark::DoNotOptimize(found);
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void BM_FlatMapLookupByRawPointer(benchmark::State &state)
+{
+    const auto probes = makeKeys(static_cast<std::size_t>(state.range(0)));
+    auto keys = probes;
+    std::sort(keys.begin(), keys.end(), sia::checked_ptr_less());
+
+    for (auto _ : state)
+    {
+        std::size_t found = 0;
+        for (const auto &probe : probes)
+            found += std::binary_search(keys.begin(), keys.end(), probe.get(), sia::checked_ptr_less()) ? 1 : 0;
+        benchmark::DoNotOptimize(found);
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(BM_FlatSetIdentityHash)->Arg(4096);
+BENCHMARK(BM_FlatSetMixingHash)->Arg(4096);
+BENCHMARK(BM_FlatMapLookupByTemporary)->Arg(4096);
+BENCHMARK(BM_FlatMapLookupByRawPointer)->Arg(4096);
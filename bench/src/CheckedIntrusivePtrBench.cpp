@@ -0,0 +1,126 @@
+#include "checked_intrusive_ptr.hpp"
+#include <benchmark/benchmark.h>
+#include <random>
+#include <vector>
+
+// Copy heavy graph workloads, checked_intrusive_ptr against checked_shared_ptr. Every node keeps its outgoing edges
+// as owning pointers, so copying the edge lists is dominated by reference counting.
+//
+
+struct SharedNode
+{
+    std::vector<sia::checked_shared_ptr<SharedNode>> m_edges{};
+    std::int64_t m_value{1};
+};
+
+struct IntrusiveNode : sia::checked_intrusive_ref_counter<IntrusiveNode>
+{
+    std::vector<sia::checked_intrusive_ptr<IntrusiveNode>> m_edges{};
+    std::int64_t m_value{1};
+};
+
+template <typename Node>
+struct GraphTraits;
+
+template <>
+struct GraphTraits<SharedNode>
+{
+    using Ptr = sia::checked_shared_ptr<SharedNode>;
+
+    static Ptr make()
+    {
+        return sia::make_checked_shared<SharedNode>();
+    }
+};
+
+template <>
+struct GraphTraits<IntrusiveNode>
+{
+    using Ptr = sia::checked_intrusive_ptr<IntrusiveNode>;
+
+    static Ptr make()
+    {
+        return sia::make_checked_intrusive<IntrusiveNode>();
+    }
+};
+
+static constexpr std::size_t kEdgesPerNode = 8;
+
+// Builds a random graph. Edges only point to nodes created earlier so that there are no cycles to leak.
+//
+template <typename Node>
+std::vector<typename GraphTraits<Node>::Ptr> makeGraph(std::size_t num_of_nodes)
+{
+    std::vector<typename GraphTraits<Node>::Ptr> nodes{};
+    std::mt19937 gen{42};
+
+    nodes.reserve(num_of_nodes);
+    for (std::size_t i = 0; i < num_of_nodes; ++i)
+    {
+        auto node = GraphTraits<Node>::make();
+
+        for (std::size_t edge = 0; i > 0 && edge < kEdgesPerNode; ++edge)
+            node->m_edges.push_back(nodes[std::uniform_int_distribution<std::size_t>(0, i - 1)(gen)]);
+
+        nodes.push_back(std::move(node));
+    }
+
+    return nodes;
+}
+
+template <typename Node>
+void BM_GraphCopyEdges(benchmark::State &state)
+{
+    auto nodes = makeGraph<Node>(static_cast<std::size_t>(state.range(0)));
+
+    for (auto _ : state)
+    {
+        for (const auto &node : nodes)
+        {
+            auto edges = node->m_edges;
+            benchmark::DoNotOptimize(edges.data());
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0) * static_cast<std::int64_t>(kEdgesPerNode));
+}
+
+template <typename Node>
+void BM_GraphTraverse(benchmark::State &state)
+{
+    auto nodes = makeGraph<Node>(static_cast<std::size_t>(state.range(0)));
+
+    for (auto _ : state)
+    {
+        std::int64_t sum{};
+
+        for (const auto &node : nodes)
+        {
+            for (const auto &edge : node->m_edges)
+                sum += edge->m_value + edge.use_count();
+        }
+
+        benchmark::DoNotOptimize(sum);
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0) * static_cast<std::int64_t>(kEdgesPerNode));
+}
+
+template <typename Node>
+void BM_GraphBuild(benchmark::State &state)
+{
+    for (auto _ : state)
+    {
+        auto nodes = makeGraph<Node>(static_cast<std::size_t>(state.range(0)));
+        benchmark::DoNotOptimize(nodes.data());
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK_TEMPLATE(BM_GraphCopyEdges, SharedNode)->Range(1 << 10, 1 << 16);
+BENCHMARK_TEMPLATE(BM_GraphCopyEdges, IntrusiveNode)->Range(1 << 10, 1 << 16);
+BENCHMARK_TEMPLATE(BM_GraphTraverse, SharedNode)->Range(1 << 10, 1 << 16);
+BENCHMARK_TEMPLATE(BM_GraphTraverse, IntrusiveNode)->Range(1 << 10, 1 << 16);
+BENCHMARK_TEMPLATE(BM_GraphBuild, SharedNode)->Range(1 << 10, 1 << 16);
+BENCHMARK_TEMPLATE(BM_GraphBuild, IntrusiveNode)->Range(1 << 10, 1 << 16);
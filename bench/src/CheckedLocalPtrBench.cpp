@@ -0,0 +1,88 @@
+#include "checked_local_ptr.hpp"
+#include <benchmark/benchmark.h>
+#include <vector>
+
+// checked_local_ptr against checked_shared_ptr on copy heavy paths of a single thread.
+//
+
+struct LocalPayload
+{
+    std::int64_t m_value{42};
+};
+
+template <typename T>
+using SharedPtr = sia::checked_shared_ptr<T>;
+
+template <typename T>
+using LocalPtr = sia::checked_local_ptr<T>;
+
+template <template <typename> class Ptr>
+Ptr<LocalPayload> makeLocalPayload()
+{
+    if constexpr (std::is_same_v<Ptr<LocalPayload>, sia::checked_local_ptr<LocalPayload>>)
+        return sia::make_checked_local<LocalPayload>();
+    else
+        return sia::make_checked_shared<LocalPayload>();
+}
+
+template <template <typename> class Ptr>
+void BM_LocalCopyConstruct(benchmark::State &state)
+{
+    auto ptr = makeLocalPayload<Ptr>();
+
+    for (auto _ : state)
+    {
+        Ptr<LocalPayload> copy{ptr};
+        benchmark::DoNotOptimize(copy);
+    }
+}
+
+template <template <typename> class Ptr>
+void BM_LocalCopyAssign(benchmark::State &state)
+{
+    auto ptr = makeLocalPayload<Ptr>();
+    Ptr<LocalPayload> other{};
+
+    for (auto _ : state)
+    {
+        other = ptr;
+        benchmark::DoNotOptimize(other);
+        other = nullptr;
+    }
+}
+
+template <template <typename> class Ptr>
+void BM_LocalVectorCopy(benchmark::State &state)
+{
+    std::vector<Ptr<LocalPayload>> ptrs{};
+
+    for (std::int64_t i = 0; i < state.range(0); ++i)
+        ptrs.push_back(makeLocalPayload<Ptr>());
+
+    for (auto _ : state)
+    {
+        auto copy = ptrs;
+        benchmark::DoNotOptimize(copy.data());
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template <template <typename> class Ptr>
+void BM_LocalMake(benchmark::State &state)
+{
+    for (auto _ : state)
+    {
+        auto ptr = makeLocalPayload<Ptr>();
+        benchmark::DoNotOptimize(ptr);
+    }
+}
+
+BENCHMARK_TEMPLATE(BM_LocalCopyConstruct, SharedPtr);
+BENCHMARK_TEMPLATE(BM_LocalCopyConstruct, LocalPtr);
+BENCHMARK_TEMPLATE(BM_LocalCopyAssign, SharedPtr);
+BENCHMARK_TEMPLATE(BM_LocalCopyAssign, LocalPtr);
+BENCHMARK_TEMPLATE(BM_LocalVectorCopy, SharedPtr)->Range(1 << 6, 1 << 14);
+BENCHMARK_TEMPLATE(BM_LocalVectorCopy, LocalPtr)->Range(1 << 6, 1 << 14);
+BENCHMARK_TEMPLATE(BM_LocalMake, SharedPtr);
+BENCHMARK_TEMPLATE(BM_LocalMake, LocalPtr);
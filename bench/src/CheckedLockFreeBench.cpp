@@ -0,0 +1,121 @@
+#include "checked_lock_free.hpp"
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Every benchmark thread is a producer and a consumer: it pushes a batch of messages and then pops as many as it
+// pushed, which are mostly other threads' messages once there is more than one. The messages are created up front,
+// so only the hand-over is measured.
+//
+
+namespace
+{
+
+constexpr std::size_t kBatch = 64;
+constexpr std::size_t kCapacity = 4096;
+
+struct Message
+{
+    std::int64_t m_id{};
+};
+
+using Ptr = sia::checked_shared_ptr<Message>;
+
+class LockFreeQueue
+{
+    public:
+    bool push(Ptr &&message)
+    {
+        return m_queue.tryPush(std::move(message));
+    }
+
+    bool pop(Ptr &message)
+    {
+        return m_queue.tryPop(message);
+    }
+
+    private:
+    sia::checked_mpmc_queue<Message> m_queue{kCapacity};
+};
+
+class LockFreeStack
+{
+    public:
+    bool push(Ptr &&message)
+    {
+        m_stack.push(std::move(message));
+        return true;
+    }
+
+    bool pop(Ptr &message)
+    {
+        return m_stack.tryPop(message);
+    }
+
+    private:
+    sia::checked_lock_free_stack<Message> m_stack{};
+};
+
+class MutexQueue
+{
+    public:
+    bool push(Ptr &&message)
+    {
+        std::lock_guard<std::mutex> lock{m_mutex};
+        m_queue.push_back(std::move(message));
+        return true;
+    }
+
+    bool pop(Ptr &message)
+    {
+        std::lock_guard<std::mutex> lock{m_mutex};
+        if (m_queue.empty())
+            return false;
+
+        message = std::move(m_queue.front());
+        m_queue.pop_front();
+        return true;
+    }
+
+    private:
+    std::mutex m_mutex{};
+    std::deque<Ptr> m_queue{};
+};
+
+}  // namespace
+
+template <typename Container>
+void BM_ProduceConsume(benchmark::State &state)
+{
+    static Container container{};
+
+    std::vector<Ptr> messages(kBatch);
+    for (auto &message : messages)
+        message = sia::make_checked_shared<Message>();
+
+    for (auto _ : state)
+    {
+        for (auto &message : messages)
+        {
+            while (!container.push(std::move(message)))
+                std::this_thread::yield();
+        }
+
+        for (auto &message : messages)
+        {
+            while (!container.pop(message))
+                std::this_thread::yield();
+        }
+    }
+
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * kBatch));
+}
+
+static const int kMaxThreads = static_cast<int>(std::max(4U, std::thread::hardware_concurrency()));
+
+BENCHMARK_TEMPLATE(BM_ProduceConsume, LockFreeQueue)->ThreadRange(1, kMaxThreads)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_ProduceConsume, LockFreeStack)->ThreadRange(1, kMaxThreads)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_ProduceConsume, MutexQueue)->ThreadRange(1, kMaxThreads)->UseRealTime();
@@ -0,0 +1,65 @@
+#include "checked_null_telemetry.hpp"
+#include <benchmark/benchmark.h>
+#include <vector>
+
+// Dereferences which never hit a null. Recording must not cost anything as long as no check fails, so every
+// variant is expected to run as fast as the plain throw_on_null one.
+//
+
+namespace
+{
+
+struct Reading
+{
+    std::int64_t m_value{1};
+};
+
+template <typename Ptr>
+std::vector<Ptr> makeReadings(std::int64_t count)
+{
+    std::vector<Ptr> readings{};
+
+    for (std::int64_t i = 0; i < count; ++i)
+        readings.push_back(Ptr{sia::make_checked_shared<Reading>()});
+
+    return readings;
+}
+
+}  // namespace
+
+template <typename CheckPolicy>
+static void BM_TelemetryArrow(benchmark::State &state)
+{
+    auto readings = makeReadings<sia::checked_shared_ptr<Reading, CheckPolicy>>(state.range(0));
+
+    for (auto _ : state)
+    {
+        std::int64_t sum = 0;
+        for (const auto &reading : readings)
+            sum += reading->m_value;
+        benchmark::DoNotOptimize(sum);
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template <typename CheckPolicy>
+static void BM_TelemetryGetChecked(benchmark::State &state)
+{
+    auto readings = makeReadings<sia::checked_shared_ptr<Reading, CheckPolicy>>(state.range(0));
+
+    for (auto _ : state)
+    {
+        std::int64_t sum = 0;
+        for (const auto &reading : readings)
+            sum += reading.getChecked()->m_value;
+        benchmark::DoNotOptimize(sum);
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK_TEMPLATE(BM_TelemetryArrow, sia::throw_on_null)->Range(1 << 6, 1 << 12);
+BENCHMARK_TEMPLATE(BM_TelemetryArrow, sia::record_on_null<>)->Range(1 << 6, 1 << 12);
+BENCHMARK_TEMPLATE(BM_TelemetryGetChecked, sia::throw_on_null)->Range(1 << 6, 1 << 12);
+BENCHMARK_TEMPLATE(BM_TelemetryGetChecked, sia::record_on_null<>)->Range(1 << 6, 1 << 12);
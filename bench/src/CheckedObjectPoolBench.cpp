@@ -0,0 +1,137 @@
+#include "checked_object_pool.hpp"
+#include <benchmark/benchmark.h>
+#include <array>
+#include <atomic>
+#include <thread>
+
+// Producer/consumer churn: every benchmark thread creates objects and hands them over to a consumer thread of its
+// own through a ring, the consumer drops them. The last release always happens on another thread than the
+// allocation, which is the worst case for a per-thread free list and a common one for message passing.
+//
+
+namespace
+{
+
+struct Order
+{
+    explicit Order(std::int64_t id) : m_id(id)
+    {
+    }
+
+    std::int64_t m_id;
+    std::array<char, 56> m_payload{};
+};
+
+template <typename Ptr, std::size_t Capacity = 1024>
+class Ring
+{
+    public:
+    bool push(Ptr &&value)
+    {
+        const std::size_t tail = m_tail.load(std::memory_order_relaxed);
+        if (tail - m_head.load(std::memory_order_acquire) == Capacity)
+            return false;
+
+        m_slots[tail % Capacity] = std::move(value);
+        m_tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool popAndDrop()
+    {
+        const std::size_t head = m_head.load(std::memory_order_relaxed);
+        if (head == m_tail.load(std::memory_order_acquire))
+            return false;
+
+        m_slots[head % Capacity] = nullptr;
+        m_head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    private:
+    std::array<Ptr, Capacity> m_slots{};
+    alignas(64) std::atomic<std::size_t> m_head{0};
+    alignas(64) std::atomic<std::size_t> m_tail{0};
+};
+
+template <typename Ptr, typename Make>
+void churn(benchmark::State &state, Make make)
+{
+    constexpr std::int64_t kBatch = 64;
+
+    Ring<Ptr> ring{};
+    std::atomic<bool> done{false};
+
+    std::thread consumer(
+        [&ring, &done]
+        {
+            while (!done.load(std::memory_order_acquire))
+            {
+                if (!ring.popAndDrop())
+                    std::this_thread::yield();
+            }
+
+            while (ring.popAndDrop())
+            {
+            }
+        });
+
+    std::int64_t id = 0;
+    for (auto _ : state)
+    {
+        for (std::int64_t i = 0; i < kBatch; ++i)
+        {
+            Ptr order = make(id++);
+            while (!ring.push(std::move(order)))
+                std::this_thread::yield();
+        }
+    }
+
+    done.store(true, std::memory_order_release);
+    consumer.join();
+
+    state.SetItemsProcessed(state.iterations() * kBatch);
+}
+
+}  // namespace
+
+static void BM_ChurnStdMakeShared(benchmark::State &state)
+{
+    churn<std::shared_ptr<Order>>(state, [](std::int64_t id) { return std::make_shared<Order>(id); });
+}
+
+static void BM_ChurnMakeCheckedShared(benchmark::State &state)
+{
+    churn<sia::checked_shared_ptr<Order>>(state, [](std::int64_t id) { return sia::make_checked_shared<Order>(id); });
+}
+
+static void BM_ChurnPooledCheckedShared(benchmark::State &state)
+{
+    churn<sia::checked_shared_ptr<Order>>(state, [](std::int64_t id) { return sia::pooled_checked_shared<Order>(id); });
+}
+
+// Allocation and release on the same thread.
+//
+static void BM_SameThreadStdMakeShared(benchmark::State &state)
+{
+    for (auto _ : state)
+    {
+        auto order = std::make_shared<Order>(1);
+        benchmark::DoNotOptimize(order);
+    }
+}
+
+static void BM_SameThreadPooledCheckedShared(benchmark::State &state)
+{
+    for (auto _ : state)
+    {
+        auto order = sia::pooled_checked_shared<Order>(1);
+        benchmark::DoNotOptimize(order);
+    }
+}
+
+BENCHMARK(BM_ChurnStdMakeShared)->ThreadRange(1, 4)->UseRealTime();
+BENCHMARK(BM_ChurnMakeCheckedShared)->ThreadRange(1, 4)->UseRealTime();
+BENCHMARK(BM_ChurnPooledCheckedShared)->ThreadRange(1, 4)->UseRealTime();
+BENCHMARK(BM_SameThreadStdMakeShared);
+BENCHMARK(BM_SameThreadPooledCheckedShared);
@@ -0,0 +1,150 @@
+#include "checked_shared_ptr.hpp"
+#include <benchmark/benchmark.h>
+
+// Casts in a visitor style loop. The rvalue casts hand the reference over instead of copying it, the downcasts to a
+// final class or to a class with a type tag do not need dynamic_cast.
+//
+
+namespace
+{
+
+struct Node
+{
+    enum class Kind
+    {
+        leaf,
+        branch
+    };
+
+    explicit Node(Kind kind) : m_kind(kind)
+    {
+    }
+
+    virtual ~Node() = default;
+
+    Kind m_kind;
+};
+
+struct Branch : Node
+{
+    Branch() : Node(Kind::branch)
+    {
+    }
+};
+
+struct OpenLeaf : Node
+{
+    OpenLeaf() : Node(Kind::leaf)
+    {
+    }
+
+    std::int64_t m_value{1};
+};
+
+struct FinalLeaf final : Node
+{
+    FinalLeaf() : Node(Kind::leaf)
+    {
+    }
+
+    std::int64_t m_value{1};
+};
+
+struct TaggedLeaf : Node
+{
+    TaggedLeaf() : Node(Kind::leaf)
+    {
+    }
+
+    static bool classof(const Node *node)
+    {
+        return node->m_kind == Kind::leaf;
+    }
+
+    std::int64_t m_value{1};
+};
+
+// A few levels between the root and the leaves so that dynamic_cast has a hierarchy to walk.
+//
+struct Level1 : OpenLeaf
+{
+};
+
+struct Level2 : Level1
+{
+};
+
+struct DeepLeaf : Level2
+{
+};
+
+}  // namespace
+
+template <typename Leaf, typename Made = Leaf>
+static void BM_DynamicCast(benchmark::State &state)
+{
+    sia::checked_shared_ptr<Node> node{sia::make_checked_shared<Made>()};
+
+    for (auto _ : state)
+    {
+        auto leaf = std::dynamic_pointer_cast<Leaf>(node);
+        benchmark::DoNotOptimize(leaf);
+    }
+}
+
+static void BM_StaticCastCopy(benchmark::State &state)
+{
+    sia::checked_shared_ptr<Node> node{sia::make_checked_shared<FinalLeaf>()};
+
+    for (auto _ : state)
+    {
+        auto copy = node;
+        auto leaf = std::static_pointer_cast<FinalLeaf>(copy);
+        benchmark::DoNotOptimize(leaf);
+    }
+}
+
+static void BM_StaticCastMove(benchmark::State &state)
+{
+    sia::checked_shared_ptr<Node> node{sia::make_checked_shared<FinalLeaf>()};
+
+    for (auto _ : state)
+    {
+        auto copy = node;
+        auto leaf = std::static_pointer_cast<FinalLeaf>(std::move(copy));
+        benchmark::DoNotOptimize(leaf);
+    }
+}
+
+static void BM_UpcastMove(benchmark::State &state)
+{
+    auto leaf = sia::make_checked_shared<FinalLeaf>();
+
+    for (auto _ : state)
+    {
+        auto copy = leaf;
+        auto node = std::static_pointer_cast<Node>(std::move(copy));
+        benchmark::DoNotOptimize(node);
+    }
+}
+
+static void BM_CheckedPointerCast(benchmark::State &state)
+{
+    sia::checked_shared_ptr<Node> node{sia::make_checked_shared<FinalLeaf>()};
+
+    for (auto _ : state)
+    {
+        auto leaf = sia::checked_pointer_cast<FinalLeaf>(node);
+        benchmark::DoNotOptimize(leaf);
+    }
+}
+
+BENCHMARK_TEMPLATE(BM_DynamicCast, OpenLeaf);
+BENCHMARK_TEMPLATE(BM_DynamicCast, OpenLeaf, DeepLeaf);
+BENCHMARK_TEMPLATE(BM_DynamicCast, FinalLeaf);
+BENCHMARK_TEMPLATE(BM_DynamicCast, TaggedLeaf);
+BENCHMARK_TEMPLATE(BM_DynamicCast, FinalLeaf, Branch);
+BENCHMARK(BM_StaticCastCopy);
+BENCHMARK(BM_StaticCastMove);
+BENCHMARK(BM_UpcastMove);
+BENCHMARK(BM_CheckedPointerCast);
@@ -0,0 +1,81 @@
+#include "atomic_checked_shared_ptr.hpp"
+#include "checked_rcu.hpp"
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <thread>
+
+// Readers on every core looking up the same table. Copying the owner out bumps one reference count from all of them,
+// an rcu_read_guard only writes a record of the reading thread.
+//
+
+namespace
+{
+
+struct LookupTable
+{
+    std::int64_t m_entries{64};
+};
+
+struct CopyOutReader
+{
+    const sia::checked_shared_ptr<LookupTable> m_slot{sia::make_checked_shared<LookupTable>()};
+
+    std::int64_t read() const
+    {
+        auto table = m_slot;
+        return table->m_entries;
+    }
+};
+
+struct AtomicReader
+{
+    sia::atomic_checked_shared_ptr<LookupTable> m_slot{sia::make_checked_shared<LookupTable>()};
+
+    std::int64_t read() const
+    {
+        auto table = m_slot.load();
+        return table->m_entries;
+    }
+};
+
+struct RcuReader
+{
+    sia::rcu_checked_shared_ptr<LookupTable> m_slot{sia::make_checked_shared<LookupTable>()};
+
+    std::int64_t read() const
+    {
+        sia::rcu_read_guard guard{};
+        return m_slot.read(guard)->m_entries;
+    }
+};
+
+}  // namespace
+
+template <typename Reader>
+void BM_ReaderScaling(benchmark::State &state)
+{
+    static Reader reader{};
+
+    for (auto _ : state)
+        benchmark::DoNotOptimize(reader.read());
+
+    state.SetItemsProcessed(state.iterations());
+}
+
+static const int kMaxReaderThreads = static_cast<int>(std::max(1U, std::thread::hardware_concurrency()));
+
+BENCHMARK_TEMPLATE(BM_ReaderScaling, CopyOutReader)->ThreadRange(1, kMaxReaderThreads)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_ReaderScaling, AtomicReader)->ThreadRange(1, kMaxReaderThreads)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_ReaderScaling, RcuReader)->ThreadRange(1, kMaxReaderThreads)->UseRealTime();
+
+// Cost of a replacement, including the reclamation of the previous table.
+//
+static void BM_RcuStore(benchmark::State &state)
+{
+    sia::rcu_checked_shared_ptr<LookupTable> slot{};
+
+    for (auto _ : state)
+        slot.store(sia::make_checked_shared<LookupTable>());
+}
+
+BENCHMARK(BM_RcuStore);
@@ -0,0 +1,35 @@
+#include "checked_shared_ptr.hpp"
+#include <benchmark/benchmark.h>
+
+// Cost of copying with the refcount profiler switched on. Every thread counts into its own table, so the overhead
+// is expected to stay flat with the number of threads. Compare with BM_CopyConstruct of the plain pointer. Built as an
+// executable of its own with SIA_CSP_PROFILE_REFCOUNT=1, see bench/CMakeLists.txt.
+//
+
+namespace
+{
+
+struct ProfiledPayload
+{
+    std::int64_t m_value{42};
+};
+
+}  // namespace
+
+static void BM_ProfiledCopyConstruct(benchmark::State &state)
+{
+    static auto shared = sia::make_checked_shared<ProfiledPayload>();
+    auto local = sia::make_checked_shared<ProfiledPayload>();
+    const auto &ptr = state.range(0) == 0 ? local : shared;
+
+    for (auto _ : state)
+    {
+        sia::checked_shared_ptr<ProfiledPayload> copy{ptr};
+        benchmark::DoNotOptimize(copy);
+    }
+
+    if (state.thread_index() == 0)
+        sia::refcount_profiler::reset();
+}
+
+BENCHMARK(BM_ProfiledCopyConstruct)->Arg(0)->Arg(1)->Threads(1)->Threads(2)->Threads(4);
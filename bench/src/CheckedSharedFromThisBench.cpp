@@ -0,0 +1,57 @@
+#include "checked_shared_from_this.hpp"
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <thread>
+
+// Taking a pointer to this from inside a member, std::enable_shared_from_this against
+// sia::enable_checked_shared_from_this, on one thread and with all threads on the same object.
+//
+
+namespace
+{
+
+struct Session : sia::enable_checked_shared_from_this<Session>
+{
+    std::int64_t m_id{1};
+};
+
+}  // namespace
+
+static void BM_StdSharedFromThis(benchmark::State &state)
+{
+    static auto session = sia::make_checked_shared<Session>();
+
+    for (auto _ : state)
+    {
+        auto self = session->shared_from_this();
+        benchmark::DoNotOptimize(self);
+    }
+}
+
+static void BM_CheckedSharedFromThis(benchmark::State &state)
+{
+    static auto session = sia::make_checked_shared<Session>();
+
+    for (auto _ : state)
+    {
+        auto self = session->checked_shared_from_this();
+        benchmark::DoNotOptimize(self);
+    }
+}
+
+static void BM_ViewFromThis(benchmark::State &state)
+{
+    static auto session = sia::make_checked_shared<Session>();
+
+    for (auto _ : state)
+    {
+        auto self = session->view_from_this();
+        benchmark::DoNotOptimize(self);
+    }
+}
+
+static const int kMaxThreads = static_cast<int>(std::max(4U, std::thread::hardware_concurrency()));
+
+BENCHMARK(BM_StdSharedFromThis)->ThreadRange(1, kMaxThreads)->UseRealTime();
+BENCHMARK(BM_CheckedSharedFromThis)->ThreadRange(1, kMaxThreads)->UseRealTime();
+BENCHMARK(BM_ViewFromThis)->ThreadRange(1, kMaxThreads)->UseRealTime();
@@ -0,0 +1,247 @@
+#include "checked_shared_ptr.hpp"
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <memory>
+#include <thread>
+
+// libstdc++ uses plain increments for std::shared_ptr as long as the process has never started a thread. Start one
+// up front so that the numbers reflect a real multi-threaded service and do not depend on the benchmark filter.
+//
+static const bool kMultiThreaded = [] {
+    std::thread([] {}).join();
+    return true;
+}();
+
+// Every benchmark is instantiated twice: once for the raw std::shared_ptr and once for sia::checked_shared_ptr.
+// Keep the bodies identical so that the only difference in the report is the pointer type itself.
+//
+
+struct Payload
+{
+    std::int64_t m_value{42};
+};
+
+struct BasePayload
+{
+    virtual ~BasePayload() = default;
+
+    std::int64_t m_value{42};
+};
+
+struct DerivedPayload final : BasePayload
+{
+};
+
+struct EnabledPayload : public std::enable_shared_from_this<EnabledPayload>
+{
+    std::int64_t m_value{42};
+};
+
+template <typename T>
+using StdPtr = std::shared_ptr<T>;
+
+template <typename T>
+using CheckedPtr = sia::checked_shared_ptr<T>;
+
+template <typename T>
+using AbortPtr = sia::checked_shared_ptr<T, sia::abort_on_null>;
+
+// Must be on par with StdPtr, the check is compiled out completely.
+//
+template <typename T>
+using UncheckedPtr = sia::checked_shared_ptr<T, sia::unchecked>;
+
+template <template <typename> class Ptr, typename T>
+Ptr<T> makePtr()
+{
+    if constexpr (std::is_same_v<Ptr<T>, std::shared_ptr<T>>)
+        return std::make_shared<T>();
+    else
+        return Ptr<T>{sia::make_checked_shared<T>()};
+}
+
+template <template <typename> class Ptr>
+void BM_ArrowOperator(benchmark::State &state)
+{
+    auto ptr = makePtr<Ptr, Payload>();
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(ptr);
+        benchmark::DoNotOptimize(ptr->m_value);
+    }
+}
+
+template <template <typename> class Ptr>
+void BM_DerefOperator(benchmark::State &state)
+{
+    auto ptr = makePtr<Ptr, Payload>();
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(ptr);
+        benchmark::DoNotOptimize((*ptr).m_value);
+    }
+}
+
+template <template <typename> class Ptr>
+void BM_CopyConstruct(benchmark::State &state)
+{
+    auto ptr = makePtr<Ptr, Payload>();
+
+    for (auto _ : state)
+    {
+        Ptr<Payload> copy{ptr};
+        benchmark::DoNotOptimize(copy);
+    }
+}
+
+template <template <typename> class Ptr>
+void BM_MoveConstruct(benchmark::State &state)
+{
+    auto ptr = makePtr<Ptr, Payload>();
+
+    for (auto _ : state)
+    {
+        Ptr<Payload> moved{std::move(ptr)};
+        benchmark::DoNotOptimize(moved);
+        ptr = std::move(moved);
+    }
+}
+
+template <template <typename> class Ptr>
+void BM_CopyAssign(benchmark::State &state)
+{
+    auto ptr = makePtr<Ptr, Payload>();
+    Ptr<Payload> other{};
+
+    for (auto _ : state)
+    {
+        other = ptr;
+        benchmark::DoNotOptimize(other);
+        other = nullptr;
+    }
+}
+
+template <template <typename> class Ptr>
+void BM_MoveAssign(benchmark::State &state)
+{
+    auto ptr = makePtr<Ptr, Payload>();
+    Ptr<Payload> other{};
+
+    for (auto _ : state)
+    {
+        other = std::move(ptr);
+        benchmark::DoNotOptimize(other);
+        ptr = std::move(other);
+    }
+}
+
+template <template <typename> class Ptr>
+void BM_Make(benchmark::State &state)
+{
+    for (auto _ : state)
+    {
+        auto ptr = makePtr<Ptr, Payload>();
+        benchmark::DoNotOptimize(ptr);
+    }
+}
+
+template <template <typename> class Ptr>
+void BM_StaticPointerCast(benchmark::State &state)
+{
+    Ptr<BasePayload> ptr{makePtr<Ptr, DerivedPayload>()};
+
+    for (auto _ : state)
+    {
+        auto derived = std::static_pointer_cast<DerivedPayload>(ptr);
+        benchmark::DoNotOptimize(derived);
+    }
+}
+
+template <template <typename> class Ptr>
+void BM_DynamicPointerCast(benchmark::State &state)
+{
+    Ptr<BasePayload> ptr{makePtr<Ptr, DerivedPayload>()};
+
+    for (auto _ : state)
+    {
+        auto derived = std::dynamic_pointer_cast<DerivedPayload>(ptr);
+        benchmark::DoNotOptimize(derived);
+    }
+}
+
+template <template <typename> class Ptr>
+void BM_SharedFromThis(benchmark::State &state)
+{
+    auto ptr = makePtr<Ptr, EnabledPayload>();
+
+    for (auto _ : state)
+    {
+        if constexpr (std::is_same_v<Ptr<EnabledPayload>, std::shared_ptr<EnabledPayload>>)
+        {
+            auto self = ptr->shared_from_this();
+            benchmark::DoNotOptimize(self);
+        }
+        else
+        {
+            auto self = ptr.shared_from_this();
+            benchmark::DoNotOptimize(self);
+        }
+    }
+}
+
+// All threads copy the very same pointer so they fight over a single control block.
+//
+template <template <typename> class Ptr>
+void BM_ContendedCopy(benchmark::State &state)
+{
+    static Ptr<Payload> shared = makePtr<Ptr, Payload>();
+
+    for (auto _ : state)
+    {
+        Ptr<Payload> copy{shared};
+        benchmark::DoNotOptimize(copy);
+    }
+}
+
+// Every thread owns its pointer, this is the baseline for the contended case above.
+//
+template <template <typename> class Ptr>
+void BM_UncontendedCopy(benchmark::State &state)
+{
+    auto ptr = makePtr<Ptr, Payload>();
+
+    for (auto _ : state)
+    {
+        Ptr<Payload> copy{ptr};
+        benchmark::DoNotOptimize(copy);
+    }
+}
+
+static const int kMaxThreads = static_cast<int>(std::max(2U, std::thread::hardware_concurrency()));
+
+#define CSP_BENCHMARK(name)            \
+    BENCHMARK_TEMPLATE(name, StdPtr); \
+    BENCHMARK_TEMPLATE(name, CheckedPtr)
+
+#define CSP_THREADED_BENCHMARK(name)                                                   \
+    BENCHMARK_TEMPLATE(name, StdPtr)->ThreadRange(1, kMaxThreads)->UseRealTime();     \
+    BENCHMARK_TEMPLATE(name, CheckedPtr)->ThreadRange(1, kMaxThreads)->UseRealTime()
+
+CSP_BENCHMARK(BM_ArrowOperator);
+BENCHMARK_TEMPLATE(BM_ArrowOperator, AbortPtr);
+BENCHMARK_TEMPLATE(BM_ArrowOperator, UncheckedPtr);
+CSP_BENCHMARK(BM_DerefOperator);
+BENCHMARK_TEMPLATE(BM_DerefOperator, AbortPtr);
+BENCHMARK_TEMPLATE(BM_DerefOperator, UncheckedPtr);
+CSP_BENCHMARK(BM_CopyConstruct);
+CSP_BENCHMARK(BM_MoveConstruct);
+CSP_BENCHMARK(BM_CopyAssign);
+CSP_BENCHMARK(BM_MoveAssign);
+CSP_BENCHMARK(BM_Make);
+CSP_BENCHMARK(BM_StaticPointerCast);
+CSP_BENCHMARK(BM_DynamicPointerCast);
+CSP_BENCHMARK(BM_SharedFromThis);
+CSP_THREADED_BENCHMARK(BM_ContendedCopy);
+CSP_THREADED_BENCHMARK(BM_UncontendedCopy);
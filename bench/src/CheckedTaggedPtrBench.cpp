@@ -0,0 +1,72 @@
+#include "checked_tagged_ptr.hpp"
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <vector>
+
+// Scanning the entries of an index for dirty ones, each entry a pointer and a dirty flag. Next to a checked_shared_ptr
+// the flag pads every entry to 24 bytes, packed into the pointer it stays at 16.
+//
+
+namespace
+{
+
+struct Record
+{
+    std::int64_t m_value{};
+};
+
+struct PaddedEntry
+{
+    sia::checked_shared_ptr<Record> m_record;
+    bool m_dirty{false};
+};
+
+struct TaggedEntry
+{
+    sia::tagged_checked_shared_ptr<Record> m_record;
+};
+
+static_assert(sizeof(PaddedEntry) == 24 && sizeof(TaggedEntry) == 16);
+
+}  // namespace
+
+static void BM_ScanPadded(benchmark::State &state)
+{
+    std::vector<PaddedEntry> entries(static_cast<std::size_t>(state.range(0)));
+    for (std::size_t i = 0; i < entries.size(); ++i)
+        entries[i] = PaddedEntry{sia::make_checked_shared<Record>(), i % 3 == 0};
+
+    for (auto _ : state)
+    {
+        std::int64_t dirty = 0;
+        for (const auto &entry : entries)
+        {
+            dirty += entry.m_dirty ? 1 : 0;
+        }
+        benchmark::DoNotOptimize(dirty);
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void BM_ScanTagged(benchmark::State &state)
+{
+    std::vector<TaggedEntry> entries(static_cast<std::size_t>(state.range(0)));
+    for (std::size_t i = 0; i < entries.size(); ++i)
+        entries[i].m_record = {sia::make_checked_shared<Record>(), i % 3 == 0 ? 1U : 0U};
+
+    for (auto _ : state)
+    {
+        std::int64_t dirty = 0;
+        for (const auto &entry : entries)
+        {
+            dirty += static_cast<std::int64_t>(entry.m_record.tag());
+        }
+        benchmark::DoNotOptimize(dirty);
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(BM_ScanPadded)->Arg(1 << 12)->Arg(1 << 18);
+BENCHMARK(BM_ScanTagged)->Arg(1 << 12)->Arg(1 << 18);
@@ -0,0 +1,61 @@
+#include "checked_view.hpp"
+#include <benchmark/benchmark.h>
+
+// A call chain which only reads through the pointer, passing it by value, by reference and as a checked_view.
+//
+
+namespace
+{
+
+struct Order
+{
+    std::int64_t m_quantity{1};
+};
+
+template <typename Param>
+[[gnu::noinline]] std::int64_t leaf(Param order)
+{
+    return order->m_quantity;
+}
+
+template <typename Param>
+[[gnu::noinline]] std::int64_t middle(Param order)
+{
+    return leaf<Param>(order) + 1;
+}
+
+template <typename Param>
+[[gnu::noinline]] std::int64_t root(Param order)
+{
+    return middle<Param>(order) + 1;
+}
+
+}  // namespace
+
+static void BM_CallChainByValue(benchmark::State &state)
+{
+    auto order = sia::make_checked_shared<Order>();
+
+    for (auto _ : state)
+        benchmark::DoNotOptimize(root<sia::checked_shared_ptr<Order>>(order));
+}
+
+static void BM_CallChainByReference(benchmark::State &state)
+{
+    auto order = sia::make_checked_shared<Order>();
+
+    for (auto _ : state)
+        benchmark::DoNotOptimize(root<const sia::checked_shared_ptr<Order> &>(order));
+}
+
+static void BM_CallChainByView(benchmark::State &state)
+{
+    auto order = sia::make_checked_shared<Order>();
+
+    for (auto _ : state)
+        benchmark::DoNotOptimize(root<sia::checked_view<Order>>(order));
+}
+
+BENCHMARK(BM_CallChainByValue);
+BENCHMARK(BM_CallChainByReference);
+BENCHMARK(BM_CallChainByView);
@@ -0,0 +1,87 @@
+#include "checked_shared_ptr.hpp"
+#include <benchmark/benchmark.h>
+
+// checked_weak_ptr against the previous way of getting a std::weak_ptr out of a checked_shared_ptr.
+//
+
+struct WeakPayload
+{
+    std::int64_t m_value{42};
+};
+
+static void BM_WeakFromManagedSharedPointer(benchmark::State &state)
+{
+    auto ptr = sia::make_checked_shared<WeakPayload>();
+
+    for (auto _ : state)
+    {
+        std::weak_ptr<WeakPayload> weak = ptr.managedSharedPointer();
+        benchmark::DoNotOptimize(weak);
+    }
+}
+
+static void BM_WeakFromCheckedSharedPtr(benchmark::State &state)
+{
+    auto ptr = sia::make_checked_shared<WeakPayload>();
+
+    for (auto _ : state)
+    {
+        sia::checked_weak_ptr<WeakPayload> weak{ptr};
+        benchmark::DoNotOptimize(weak);
+    }
+}
+
+static void BM_WeakLockStd(benchmark::State &state)
+{
+    auto ptr = std::make_shared<WeakPayload>();
+    std::weak_ptr<WeakPayload> weak{ptr};
+
+    for (auto _ : state)
+    {
+        auto locked = weak.lock();
+        benchmark::DoNotOptimize(locked->m_value);
+    }
+}
+
+static void BM_WeakLockChecked(benchmark::State &state)
+{
+    auto ptr = sia::make_checked_shared<WeakPayload>();
+    sia::checked_weak_ptr<WeakPayload> weak{ptr};
+
+    for (auto _ : state)
+    {
+        auto locked = weak.lock();
+        benchmark::DoNotOptimize(locked->m_value);
+    }
+}
+
+static void BM_WeakLockOrThrow(benchmark::State &state)
+{
+    auto ptr = sia::make_checked_shared<WeakPayload>();
+    sia::checked_weak_ptr<WeakPayload> weak{ptr};
+
+    for (auto _ : state)
+    {
+        auto locked = weak.lock_or_throw();
+        benchmark::DoNotOptimize(locked.get()->m_value);
+    }
+}
+
+static void BM_WeakExpired(benchmark::State &state)
+{
+    auto ptr = sia::make_checked_shared<WeakPayload>();
+    sia::checked_weak_ptr<WeakPayload> weak{ptr};
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(weak);
+        benchmark::DoNotOptimize(weak.expired());
+    }
+}
+
+BENCHMARK(BM_WeakFromManagedSharedPointer);
+BENCHMARK(BM_WeakFromCheckedSharedPtr);
+BENCHMARK(BM_WeakLockStd);
+BENCHMARK(BM_WeakLockChecked);
+BENCHMARK(BM_WeakLockOrThrow);
+BENCHMARK(BM_WeakExpired);
@@ -0,0 +1,67 @@
+#include "checked_shared_ptr.hpp"
+#include <benchmark/benchmark.h>
+#include <array>
+
+// A hot loop writing bytes through the pointer. The char stores may alias the pointer itself, so the compiler has to
+// reload it and redo the null check on every access unless the loop runs on a not-null handle.
+//
+
+namespace
+{
+
+struct Frame
+{
+    std::array<unsigned char, 4096> m_bytes{};
+};
+
+template <typename Ptr>
+[[gnu::noinline]] void fill(const Ptr &frame, std::int64_t count)
+{
+    for (std::int64_t i = 0; i < count; ++i)
+        frame->m_bytes[static_cast<std::size_t>(i)] = static_cast<unsigned char>(i);
+}
+
+}  // namespace
+
+static void BM_HotLoopChecked(benchmark::State &state)
+{
+    auto frame = sia::make_checked_shared<Frame>();
+
+    for (auto _ : state)
+    {
+        fill(frame, state.range(0));
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void BM_HotLoopNonNull(benchmark::State &state)
+{
+    auto frame = sia::make_checked_shared<Frame>();
+
+    for (auto _ : state)
+    {
+        fill(frame.non_null(), state.range(0));
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void BM_HotLoopSharedPtr(benchmark::State &state)
+{
+    auto frame = std::make_shared<Frame>();
+
+    for (auto _ : state)
+    {
+        fill(frame, state.range(0));
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(BM_HotLoopChecked)->Range(1 << 6, 1 << 12);
+BENCHMARK(BM_HotLoopNonNull)->Range(1 << 6, 1 << 12);
+BENCHMARK(BM_HotLoopSharedPtr)->Range(1 << 6, 1 << 12);
@@ -0,0 +1,255 @@
+#pragma once
+
+#include "checked_shared_ptr.hpp"
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+
+namespace sia
+{
+
+namespace detail
+{
+
+// How a slot tells an empty value, which is stored without a node.
+//
+template <typename Value>
+struct atomic_slot_traits //NOLINT(readability-identifier-naming)
+{
+    static bool isEmpty(const Value &value) noexcept
+    {
+        return value == nullptr;
+    }
+};
+
+// Lock-free atomic slot for checked_shared_ptr like values, based on split reference counting.
+//
+// Every published value lives in a node. The address of the current node and an external count of readers which are
+// about to copy out of it are packed into a single 64-bit word. A reader bumps the external count with one fetch_add,
+// copies the value and then gives its reference back by decrementing the external count again. If a writer replaced
+// the node meanwhile, it has transferred the external count to the internal count of the node and the reader
+// decrements that one instead. Whoever brings the node to zero deletes it. A replaced node is never published again,
+// so there is no ABA problem.
+//
+// Limits: node addresses must fit into 48 bits, which is the case for user space on x86-64 and AArch64, and at most
+// 65535 loads may be in flight on the same node at once. All operations are sequentially consistent.
+//
+template <typename Value>
+class atomic_shared_slot //NOLINT(readability-identifier-naming)
+{
+    using Word = std::uint64_t;
+
+    static_assert(sizeof(void *) == sizeof(Word), "atomic_shared_slot requires 64-bit pointers");
+
+    static constexpr int kCountShift = 48;
+    static constexpr Word kOneRef = Word{1} << kCountShift;
+    static constexpr Word kPtrMask = kOneRef - 1;
+
+    struct Node
+    {
+        explicit Node(Value &&value) noexcept : m_value(std::move(value))
+        {
+        }
+
+        Value m_value;
+        std::atomic<std::int64_t> m_internal_count{0};
+    };
+
+    public:
+    static constexpr bool is_always_lock_free = std::atomic<Word>::is_always_lock_free; //NOLINT(readability-identifier-naming)
+
+    constexpr atomic_shared_slot() noexcept = default;
+
+    atomic_shared_slot(Value desired) : m_word(pack(makeNode(std::move(desired)))) //NOLINT(google-explicit-constructor)
+    {
+    }
+
+    atomic_shared_slot(const atomic_shared_slot &) = delete;
+    atomic_shared_slot &operator=(const atomic_shared_slot &) = delete;
+
+    ~atomic_shared_slot()
+    {
+        retire(ptrOf(m_word.load()), 0);
+    }
+
+    operator Value() const //NOLINT(google-explicit-constructor)
+    {
+        return load();
+    }
+
+    [[nodiscard]] bool is_lock_free() const noexcept //NOLINT(readability-identifier-naming)
+    {
+        return m_word.is_lock_free();
+    }
+
+    [[nodiscard]] Value load() const noexcept
+    {
+        Word cur = acquireRef();
+        Node *node = ptrOf(cur);
+        Value value = node != nullptr ? node->m_value : nullptr;
+        releaseRef(node, cur);
+        return value;
+    }
+
+    void store(Value desired)
+    {
+        exchange(std::move(desired));
+    }
+
+    Value exchange(Value desired)
+    {
+        Node *fresh = makeNode(std::move(desired));
+        Word old = m_word.exchange(pack(fresh));
+        Node *node = ptrOf(old);
+
+        if (node == nullptr)
+            return nullptr;
+
+        // Nobody is reading from the node, it can be taken apart without any further refcount traffic.
+        //
+        if (countOf(old) == 0)
+        {
+            Value value = std::move(node->m_value);
+            delete node;
+            return value;
+        }
+
+        Value value = node->m_value;
+        retire(node, countOf(old));
+        return value;
+    }
+
+    bool compare_exchange_strong(Value &expected, Value desired) //NOLINT(readability-identifier-naming)
+    {
+        Node *fresh = nullptr;
+        bool fresh_made = false;
+
+        for (;;)
+        {
+            Word cur = acquireRef();
+            Node *node = ptrOf(cur);
+
+            if (!equivalent(node, expected))
+            {
+                expected = node != nullptr ? node->m_value : nullptr;
+                releaseRef(node, cur);
+                delete fresh;
+                return false;
+            }
+
+            if (!fresh_made)
+            {
+                fresh = makeNode(std::move(desired));
+                fresh_made = true;
+            }
+
+            // Our own reference is still counted in the word, so the node cannot go away while trying.
+            //
+            while (ptrOf(cur) == node)
+            {
+                if (m_word.compare_exchange_weak(cur, pack(fresh)))
+                {
+                    retire(node, countOf(cur) - 1);
+                    return true;
+                }
+            }
+
+            // Replaced by somebody else meanwhile, the value has to be compared again.
+            //
+            releaseRef(node, cur);
+        }
+    }
+
+    bool compare_exchange_weak(Value &expected, Value desired) //NOLINT(readability-identifier-naming)
+    {
+        return compare_exchange_strong(expected, std::move(desired));
+    }
+
+    private:
+    static Node *makeNode(Value &&value)
+    {
+        return !atomic_slot_traits<Value>::isEmpty(value) ? new Node(std::move(value)) : nullptr;
+    }
+
+    static Word pack(Node *node) noexcept
+    {
+        auto word = static_cast<Word>(reinterpret_cast<std::uintptr_t>(node));
+        assert((word & ~kPtrMask) == 0 && "node address does not fit into 48 bits");
+        return word;
+    }
+
+    static Node *ptrOf(Word word) noexcept
+    {
+        return reinterpret_cast<Node *>(static_cast<std::uintptr_t>(word & kPtrMask));
+    }
+
+    static std::int64_t countOf(Word word) noexcept
+    {
+        return static_cast<std::int64_t>(word >> kCountShift);
+    }
+
+    static bool equivalent(const Node *node, const Value &expected) noexcept
+    {
+        if (node == nullptr)
+            return atomic_slot_traits<Value>::isEmpty(expected);
+
+        return node->m_value == expected && !node->m_value.owner_before(expected) &&
+               !expected.owner_before(node->m_value);
+    }
+
+    // Returns the word including the reference just taken.
+    //
+    Word acquireRef() const noexcept
+    {
+        return m_word.fetch_add(kOneRef) + kOneRef;
+    }
+
+    void releaseRef(Node *node, Word cur) const noexcept
+    {
+        while (ptrOf(cur) == node)
+        {
+            if (m_word.compare_exchange_weak(cur, cur - kOneRef))
+                return;
+        }
+
+        // The node has been replaced and our reference was moved to its internal count. References taken on an
+        // empty slot are simply dropped by the writer.
+        //
+        if (node != nullptr && node->m_internal_count.fetch_sub(1) == 1)
+            delete node;
+    }
+
+    // Hands the external references over to the node which is no longer reachable from the slot.
+    //
+    static void retire(Node *node, std::int64_t external_count) noexcept
+    {
+        if (node != nullptr && node->m_internal_count.fetch_add(external_count) == -external_count)
+            delete node;
+    }
+
+    mutable std::atomic<Word> m_word{0};
+};
+
+}  // namespace detail
+
+// Lock-free atomic slot for checked_shared_ptr, see detail::atomic_shared_slot.
+//
+template <typename T, typename CheckPolicy = SIA_CSP_DEFAULT_CHECK_POLICY>
+class atomic_checked_shared_ptr final //NOLINT(readability-identifier-naming)
+    : public detail::atomic_shared_slot<checked_shared_ptr<T, CheckPolicy>>
+{
+    using Slot = detail::atomic_shared_slot<checked_shared_ptr<T, CheckPolicy>>;
+
+    public:
+    using Slot::Slot;
+
+    constexpr atomic_checked_shared_ptr() noexcept = default;
+
+    atomic_checked_shared_ptr &operator=(checked_shared_ptr<T, CheckPolicy> desired)
+    {
+        this->store(std::move(desired));
+        return *this;
+    }
+};
+
+}  // namespace sia
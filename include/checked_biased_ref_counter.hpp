@@ -0,0 +1,391 @@
+#pragma once
+
+#include "checked_intrusive_ptr.hpp"
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace sia::detail
+{
+
+// Per-thread record of checked_biased_ref_counter, it collects the references which other threads hand back to the
+// owner. It is freed once its thread has exited and the last object biased towards it is gone.
+//
+class biased_owner //NOLINT(readability-identifier-naming)
+{
+    public:
+    using ReleaseFn = void (*)(const void *) noexcept;
+
+    biased_owner(const biased_owner &) = delete;
+    biased_owner &operator=(const biased_owner &) = delete;
+
+    // The record of the calling thread, nullptr once the thread is exiting.
+    //
+    static biased_owner *current() noexcept
+    {
+        return currentSlot();
+    }
+
+    static biased_owner *registerCurrent()
+    {
+        biased_owner *owner = currentSlot();
+
+        if (owner == nullptr && !threadGone())
+        {
+            thread_local Registration registration{};
+            owner = currentSlot();
+        }
+
+        return owner;
+    }
+
+    void retain() noexcept
+    {
+        m_objects.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void release() noexcept
+    {
+        if (m_objects.fetch_sub(1, std::memory_order_acq_rel) == 1)
+            delete this;
+    }
+
+    // Hands a reference over to the owner thread. Fails once the owner has exited, the caller merges the counts
+    // itself then.
+    //
+    bool enqueue(const void *object, ReleaseFn release_fn)
+    {
+        std::lock_guard<std::mutex> lock{m_mutex};
+        if (!m_alive)
+            return false;
+
+        m_queue.push_back({object, release_fn});
+        m_pending.store(true, std::memory_order_release);
+        return true;
+    }
+
+    // Releases the references handed over by other threads, must be called on the owner thread.
+    //
+    void drain() noexcept
+    {
+        if (m_pending.load(std::memory_order_acquire))
+            takeAndRelease();
+    }
+
+    // Synchronizes the owner's last updates of its biased counts with the threads which merge them after its exit.
+    //
+    void lock() noexcept
+    {
+        m_mutex.lock();
+    }
+
+    void unlock() noexcept
+    {
+        m_mutex.unlock();
+    }
+
+    private:
+    struct Queued
+    {
+        const void *m_object;
+        ReleaseFn m_release;
+    };
+
+    struct Registration
+    {
+        Registration() : m_owner(new biased_owner())  //NOLINT(cppcoreguidelines-owning-memory)
+        {
+            currentSlot() = m_owner;
+        }
+
+        Registration(const Registration &) = delete;
+        Registration &operator=(const Registration &) = delete;
+
+        // References may still arrive while we release the queued ones, the owner is only retired once the queue is
+        // empty. Objects released later on by other thread_local destructors of this thread take the foreign path.
+        //
+        ~Registration()
+        {
+            while (!m_owner->retireIfIdle())
+                m_owner->takeAndRelease();
+
+            currentSlot() = nullptr;
+            threadGone() = true;
+            m_owner->release();
+        }
+
+        biased_owner *m_owner;
+    };
+
+    biased_owner() = default;
+    ~biased_owner() = default;
+
+    static biased_owner *&currentSlot() noexcept
+    {
+        thread_local biased_owner *owner = nullptr;
+        return owner;
+    }
+
+    static bool &threadGone() noexcept
+    {
+        thread_local bool gone = false;
+        return gone;
+    }
+
+    bool retireIfIdle() noexcept
+    {
+        std::lock_guard<std::mutex> lock{m_mutex};
+        if (!m_queue.empty())
+            return false;
+
+        m_alive = false;
+        return true;
+    }
+
+    // Releasing a reference may run destructors which queue new ones, those are left for the next round.
+    //
+    void takeAndRelease() noexcept
+    {
+        std::vector<Queued> queue{};
+        {
+            std::lock_guard<std::mutex> lock{m_mutex};
+            queue.swap(m_queue);
+            m_pending.store(false, std::memory_order_relaxed);
+        }
+
+        for (const Queued &queued : queue)
+            queued.m_release(queued.m_object);
+    }
+
+    std::mutex m_mutex{};
+    std::vector<Queued> m_queue{};
+    bool m_alive{true};
+    std::atomic<bool> m_pending{false};
+
+    // One for the thread itself plus one per object biased towards it.
+    //
+    std::atomic<std::int64_t> m_objects{1};
+};
+
+}  // namespace sia::detail
+
+namespace sia
+{
+
+// Reference counter for checked_intrusive_ptr which is biased towards the thread that created the object. Derive your
+// type T from checked_biased_ref_counter<T> instead of checked_intrusive_ref_counter<T>.
+//
+// The owner thread counts its references with plain loads and stores, all other threads use an atomic shared count
+// which may go negative, e.g. when a pointer created by the owner is released elsewhere. Whenever a foreign release
+// would take the shared count below zero, or to zero before the owner has taken any reference, the reference is
+// handed back to the owner thread instead, since only the owner knows whether that was the last one. Once the
+// owner's biased count drops to zero, or when it releases a handed back reference, it merges its count into the shared
+// one and from then on the object is counted like any other intrusive object.
+//
+// The owner releases the handed back references the next time it creates a biased object, or when it calls
+// merge_biased_refcounts(), e.g. once per event loop iteration, and at the latest when it exits. Objects referenced by
+// a thread which exits are merged by whichever thread releases their last reference.
+//
+template <typename T>
+class checked_biased_ref_counter //NOLINT(readability-identifier-naming)
+{
+    template <typename U>
+    friend void checkedIntrusiveAddRef(const checked_biased_ref_counter<U> *ptr) noexcept;
+
+    template <typename U>
+    friend void checkedIntrusiveRelease(const checked_biased_ref_counter<U> *ptr) noexcept;
+
+    template <typename U>
+    friend std::int64_t checkedIntrusiveUseCount(const checked_biased_ref_counter<U> *ptr) noexcept;
+
+    // The shared count is stored in units of kOneRef, the low bits are flags. kBiased tells the other threads that the
+    // owner holds references of its own, set once when it takes the first one.
+    //
+    static constexpr std::int64_t kMerged = 1;
+    static constexpr std::int64_t kQueued = 2;
+    static constexpr std::int64_t kBiased = 4;
+    static constexpr std::int64_t kOneRef = 8;
+    static constexpr int kCountShift = 3;
+
+    protected:
+    checked_biased_ref_counter() : m_owner(detail::biased_owner::registerCurrent())
+    {
+        if (m_owner != nullptr)
+        {
+            m_owner->retain();
+            m_owner->drain();
+        }
+        else
+        {
+            m_merged = true;
+            m_shared.store(kMerged, std::memory_order_relaxed);
+        }
+    }
+
+    // The reference count belongs to the object identity, it is never copied.
+    //
+    checked_biased_ref_counter(const checked_biased_ref_counter & /*r*/) : checked_biased_ref_counter()
+    {
+    }
+
+    checked_biased_ref_counter &operator=(const checked_biased_ref_counter &) noexcept
+    {
+        return *this;
+    }
+
+    ~checked_biased_ref_counter()
+    {
+        if (m_owner != nullptr)
+            m_owner->release();
+    }
+
+    private:
+    bool isOwnedByThisThread() const noexcept
+    {
+        return m_owner == detail::biased_owner::current() && !m_merged;
+    }
+
+    static std::int64_t countOf(std::int64_t shared) noexcept
+    {
+        return shared >> kCountShift;
+    }
+
+    void destroy() const noexcept
+    {
+        delete static_cast<const T *>(this);
+    }
+
+    void ownerRelease() const noexcept
+    {
+        const std::int64_t biased = m_biased.load(std::memory_order_relaxed) - 1;
+        m_biased.store(biased, std::memory_order_relaxed);
+
+        if (biased == 0)
+            merge(0, 0);
+    }
+
+    // Folds the biased count into the shared one, for good.
+    //
+    void merge(std::int64_t biased, std::int64_t flags) const noexcept
+    {
+        m_merged = true;
+        m_biased.store(0, std::memory_order_relaxed);
+
+        const std::int64_t delta = biased * kOneRef + kMerged - flags;
+        if (countOf(m_shared.fetch_add(delta, std::memory_order_acq_rel) + delta) == 0)
+            destroy();
+    }
+
+    void foreignRelease() const noexcept
+    {
+        std::int64_t shared = m_shared.load(std::memory_order_relaxed);
+
+        for (;;)
+        {
+            // While the owner holds a reference, dropping the shared count to zero cannot be the last release.
+            //
+            const std::int64_t floor = (shared & kBiased) != 0 ? 0 : 1;
+
+            if ((shared & (kMerged | kQueued)) != 0 || countOf(shared) > floor)
+            {
+                if (m_shared.compare_exchange_weak(shared, shared - kOneRef, std::memory_order_acq_rel,
+                                                   std::memory_order_relaxed))
+                {
+                    if ((shared & kMerged) != 0 && countOf(shared) == 1)
+                        destroy();
+
+                    return;
+                }
+            }
+            else if (m_shared.compare_exchange_weak(shared, shared | kQueued, std::memory_order_acq_rel,
+                                                    std::memory_order_relaxed))
+            {
+                break;
+            }
+        }
+
+        if (m_owner->enqueue(this, &releaseQueued))
+            return;
+
+        // The owner has exited, its biased count is final.
+        //
+        m_owner->lock();
+        const std::int64_t biased = m_biased.load(std::memory_order_relaxed);
+        m_owner->unlock();
+
+        merge(biased - 1, kQueued);
+    }
+
+    static void releaseQueued(const void *object) noexcept
+    {
+        const auto *counter = static_cast<const checked_biased_ref_counter *>(object);
+
+        if (counter->m_merged)
+        {
+            // Merged while queued, the queue held a reference all along.
+            //
+            if (countOf(counter->m_shared.fetch_sub(kOneRef + kQueued, std::memory_order_acq_rel)) == 1)
+                counter->destroy();
+
+            return;
+        }
+
+        // Other threads may have released references of the owner in the meantime, the object is shared for real.
+        //
+        counter->merge(counter->m_biased.load(std::memory_order_relaxed) - 1, kQueued);
+    }
+
+    detail::biased_owner *const m_owner;
+
+    // Written by the owner thread only, before the merge.
+    //
+    mutable std::atomic<std::int64_t> m_biased{0};
+    mutable bool m_merged{false};
+
+    mutable std::atomic<std::int64_t> m_shared{0};
+};
+
+template <typename U>
+inline void checkedIntrusiveAddRef(const checked_biased_ref_counter<U> *ptr) noexcept
+{
+    if (ptr->isOwnedByThisThread())
+    {
+        const std::int64_t biased = ptr->m_biased.load(std::memory_order_relaxed);
+        if (biased == 0)
+            ptr->m_shared.fetch_or(checked_biased_ref_counter<U>::kBiased, std::memory_order_relaxed);
+
+        ptr->m_biased.store(biased + 1, std::memory_order_relaxed);
+    }
+    else
+        ptr->m_shared.fetch_add(checked_biased_ref_counter<U>::kOneRef, std::memory_order_relaxed);
+}
+
+template <typename U>
+inline void checkedIntrusiveRelease(const checked_biased_ref_counter<U> *ptr) noexcept
+{
+    if (ptr->isOwnedByThisThread())
+        ptr->ownerRelease();
+    else
+        ptr->foreignRelease();
+}
+
+// Exact on the owner thread, a snapshot elsewhere.
+//
+template <typename U>
+inline std::int64_t checkedIntrusiveUseCount(const checked_biased_ref_counter<U> *ptr) noexcept
+{
+    return ptr->m_biased.load(std::memory_order_relaxed) +
+           checked_biased_ref_counter<U>::countOf(ptr->m_shared.load(std::memory_order_relaxed));
+}
+
+// Releases the references other threads have handed back to the calling thread.
+//
+inline void merge_biased_refcounts() noexcept //NOLINT(readability-identifier-naming)
+{
+    if (detail::biased_owner *owner = detail::biased_owner::current())
+        owner->drain();
+}
+
+}  // namespace sia
@@ -0,0 +1,160 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <memory_resource>
+
+namespace sia
+{
+
+// Pool resource tuned for allocate_checked_shared<T>. Every allocation made for a single T has the same size since it
+// is the control block together with the object, so the block size is taken from the first allocation. Blocks are
+// carved from chunks of upstream memory and recycled through an intrusive free list; allocations of any other size
+// are forwarded to the upstream resource. Chunks are only returned by release() or the destructor, so it can be put
+// on top of a std::pmr::monotonic_buffer_resource as well.
+//
+// Not thread-safe. Use one per request or per thread.
+//
+class fixed_block_resource : public std::pmr::memory_resource //NOLINT(readability-identifier-naming)
+{
+    public:
+    explicit fixed_block_resource(std::size_t blocks_per_chunk = 256,
+                                  std::pmr::memory_resource *upstream = std::pmr::get_default_resource()) noexcept
+        : m_blocks_per_chunk(std::max<std::size_t>(blocks_per_chunk, 1)), m_upstream(upstream)
+    {
+    }
+
+    fixed_block_resource(const fixed_block_resource &) = delete;
+    fixed_block_resource &operator=(const fixed_block_resource &) = delete;
+
+    ~fixed_block_resource() override
+    {
+        release();
+    }
+
+    // Returns every chunk to the upstream resource. Blocks which are still in use become invalid.
+    //
+    void release() noexcept
+    {
+        while (m_chunks != nullptr)
+        {
+            Chunk *next = m_chunks->m_next;
+            m_upstream->deallocate(m_chunks, chunkSize(), chunkAlignment());
+            m_chunks = next;
+        }
+
+        m_free_blocks = nullptr;
+    }
+
+    // Zero until the first allocation.
+    //
+    [[nodiscard]] std::size_t blockSize() const noexcept
+    {
+        return m_block_size;
+    }
+
+    [[nodiscard]] std::pmr::memory_resource *upstreamResource() const noexcept
+    {
+        return m_upstream;
+    }
+
+    protected:
+    void *do_allocate(std::size_t bytes, std::size_t alignment) override
+    {
+        if (m_block_size == 0)
+        {
+            m_block_alignment = std::max(alignment, alignof(FreeBlock));
+            m_block_size = roundUp(std::max(bytes, sizeof(FreeBlock)), m_block_alignment);
+        }
+
+        if (!isBlock(bytes, alignment))
+            return m_upstream->allocate(bytes, alignment);
+
+        if (m_free_blocks == nullptr)
+            refill();
+
+        FreeBlock *block = m_free_blocks;
+        m_free_blocks = block->m_next;
+        return block;
+    }
+
+    void do_deallocate(void *ptr, std::size_t bytes, std::size_t alignment) override
+    {
+        if (!isBlock(bytes, alignment))
+        {
+            m_upstream->deallocate(ptr, bytes, alignment);
+            return;
+        }
+
+        auto *block = static_cast<FreeBlock *>(ptr);
+        block->m_next = m_free_blocks;
+        m_free_blocks = block;
+    }
+
+    [[nodiscard]] bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override
+    {
+        return this == &other;
+    }
+
+    private:
+    struct FreeBlock
+    {
+        FreeBlock *m_next;
+    };
+
+    // Placed at the beginning of every chunk, followed by the blocks.
+    //
+    struct Chunk
+    {
+        Chunk *m_next;
+    };
+
+    static constexpr std::size_t roundUp(std::size_t value, std::size_t alignment) noexcept
+    {
+        return (value + alignment - 1) / alignment * alignment;
+    }
+
+    [[nodiscard]] bool isBlock(std::size_t bytes, std::size_t alignment) const noexcept
+    {
+        return bytes <= m_block_size && alignment <= m_block_alignment;
+    }
+
+    [[nodiscard]] std::size_t chunkAlignment() const noexcept
+    {
+        return std::max(m_block_alignment, alignof(Chunk));
+    }
+
+    [[nodiscard]] std::size_t blocksOffset() const noexcept
+    {
+        return roundUp(sizeof(Chunk), m_block_alignment);
+    }
+
+    [[nodiscard]] std::size_t chunkSize() const noexcept
+    {
+        return blocksOffset() + m_blocks_per_chunk * m_block_size;
+    }
+
+    void refill()
+    {
+        auto *chunk = static_cast<Chunk *>(m_upstream->allocate(chunkSize(), chunkAlignment()));
+        chunk->m_next = m_chunks;
+        m_chunks = chunk;
+
+        auto *blocks = reinterpret_cast<std::byte *>(chunk) + blocksOffset();
+        for (std::size_t i = m_blocks_per_chunk; i > 0; --i)
+        {
+            auto *block = reinterpret_cast<FreeBlock *>(blocks + (i - 1) * m_block_size);
+            block->m_next = m_free_blocks;
+            m_free_blocks = block;
+        }
+    }
+
+    std::size_t m_blocks_per_chunk;
+    std::pmr::memory_resource *m_upstream;
+    std::size_t m_block_size{0};
+    std::size_t m_block_alignment{0};
+    Chunk *m_chunks{nullptr};
+    FreeBlock *m_free_blocks{nullptr};
+};
+
+}  // namespace sia
@@ -0,0 +1,231 @@
+#pragma once
+
+#include "checked_intrusive_ptr.hpp"
+#include "checked_shared_ptr.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace sia
+{
+
+// True for types whose objects may be moved to another address by copying their bytes, after which the source is
+// treated as destroyed. The standard has no such notion yet, so it defaults to trivially copyable types.
+//
+template <typename T>
+struct is_trivially_relocatable : std::is_trivially_copyable<T> //NOLINT(readability-identifier-naming)
+{
+};
+
+template <typename T>
+inline constexpr bool is_trivially_relocatable_v = is_trivially_relocatable<T>::value; //NOLINT(readability-identifier-naming)
+
+template <typename T, typename P>
+struct is_trivially_relocatable<checked_intrusive_ptr<T, P>> : std::true_type
+{
+};
+
+// std::shared_ptr and std::weak_ptr are a stored pointer and a control block pointer with no pointer back to
+// themselves in libstdc++, libc++ and the MSVC STL. Other standard libraries fall back to move and destroy.
+//
+#if defined(__GLIBCXX__) || defined(_LIBCPP_VERSION) || defined(_MSC_VER)
+template <typename T, typename P>
+struct is_trivially_relocatable<checked_shared_ptr<T, P>> : std::true_type
+{
+};
+
+template <typename T, typename P>
+struct is_trivially_relocatable<checked_weak_ptr<T, P>> : std::true_type
+{
+};
+#endif
+
+// Moves [first, last) into the uninitialized storage at dest and ends the lifetime of the source objects, like a
+// move construction followed by the destruction of the source. For trivially relocatable types, e.g. all of the
+// checked pointers, this is a single memcpy without any refcount traffic. Use it when growing your own containers of
+// checked pointers. Returns the end of the destination range.
+//
+template <typename T>
+T *uninitialized_relocate(T *first, T *last, T *dest) noexcept //NOLINT(readability-identifier-naming)
+{
+    static_assert(is_trivially_relocatable_v<T> || std::is_nothrow_move_constructible_v<T>,
+                  "uninitialized_relocate requires a trivially relocatable or nothrow move constructible type");
+
+    if constexpr (is_trivially_relocatable_v<T>)
+    {
+        const auto count = static_cast<std::size_t>(last - first);
+        if (count != 0)
+            std::memcpy(static_cast<void *>(dest), static_cast<const void *>(first), count * sizeof(T));
+
+        return dest + count;
+    }
+    else
+    {
+        for (; first != last; ++first, ++dest)
+        {
+            ::new (static_cast<void *>(dest)) T(std::move(*first));
+            first->~T();
+        }
+
+        return dest;
+    }
+}
+
+// Returns the first null pointer in [first, last), or last. Blocks of pointers are tested without branching, so that
+// the compiler can vectorize the loads and compares, and only the block containing a null is looked at one by one.
+//
+template <typename Ptr>
+const Ptr *find_first_null(const Ptr *first, const Ptr *last) noexcept //NOLINT(readability-identifier-naming)
+{
+    constexpr std::ptrdiff_t kBlock = 8;
+
+    for (; last - first >= kBlock; first += kBlock)
+    {
+        bool any_null = false;
+        for (std::ptrdiff_t i = 0; i < kBlock; ++i)
+            any_null |= first[i].get() == nullptr;
+
+        if (any_null)
+            break;
+    }
+
+    for (; first != last; ++first)
+    {
+        if (first->get() == nullptr)
+            return first;
+    }
+
+    return last;
+}
+
+template <typename Ptr>
+bool all_non_null(const Ptr *first, const Ptr *last) noexcept //NOLINT(readability-identifier-naming)
+{
+    return find_first_null(first, last) == last;
+}
+
+namespace detail
+{
+
+template <typename T, typename = void>
+struct has_intrusive_bulk_refs : std::false_type //NOLINT(readability-identifier-naming)
+{
+};
+
+template <typename T>
+struct has_intrusive_bulk_refs<T, std::void_t<decltype(checkedIntrusiveAddRefs(std::declval<const T *>(), std::int64_t{})),
+                                              decltype(checkedIntrusiveReleaseRefs(std::declval<const T *>(), std::int64_t{}))>>
+    : std::true_type
+{
+};
+
+template <typename T>
+void addIntrusiveRefs(const T *ptr, std::int64_t count) noexcept
+{
+    if constexpr (has_intrusive_bulk_refs<T>::value)
+    {
+        checkedIntrusiveAddRefs(ptr, count);
+    }
+    else
+    {
+        for (std::int64_t i = 0; i < count; ++i)
+            checkedIntrusiveAddRef(ptr);
+    }
+}
+
+template <typename T>
+void releaseIntrusiveRefs(const T *ptr, std::int64_t count) noexcept
+{
+    if constexpr (has_intrusive_bulk_refs<T>::value)
+    {
+        checkedIntrusiveReleaseRefs(ptr, count);
+    }
+    else
+    {
+        for (std::int64_t i = 0; i < count; ++i)
+            checkedIntrusiveRelease(ptr);
+    }
+}
+
+// Length of the run of pointers equal to *first.
+//
+template <typename Ptr>
+std::ptrdiff_t runLength(const Ptr *first, const Ptr *last) noexcept
+{
+    std::ptrdiff_t length = 1;
+    while (first + length != last && first[length].get() == first->get())
+        ++length;
+
+    return length;
+}
+
+}  // namespace detail
+
+// Copies [first, last) into the uninitialized storage at dest. Runs of checked_intrusive_ptr to the same object take
+// their references with a single fetch_add. Any other type is copied one by one: std::shared_ptr has no way to add
+// more than one reference at a time. Returns the end of the destination range.
+//
+template <typename Ptr>
+Ptr *uninitialized_copy_coalesced(const Ptr *first, const Ptr *last, Ptr *dest) //NOLINT(readability-identifier-naming)
+{
+    return std::uninitialized_copy(first, last, dest);
+}
+
+template <typename T, typename P>
+checked_intrusive_ptr<T, P> *uninitialized_copy_coalesced(const checked_intrusive_ptr<T, P> *first, //NOLINT(readability-identifier-naming)
+                                                          const checked_intrusive_ptr<T, P> *last,
+                                                          checked_intrusive_ptr<T, P> *dest) noexcept
+{
+    while (first != last)
+    {
+        const std::ptrdiff_t length = detail::runLength(first, last);
+        T *ptr = first->get();
+
+        if (ptr != nullptr)
+            detail::addIntrusiveRefs(ptr, length);
+
+        for (std::ptrdiff_t i = 0; i < length; ++i)
+            ::new (static_cast<void *>(dest + i)) checked_intrusive_ptr<T, P>(ptr, false);
+
+        first += length;
+        dest += length;
+    }
+
+    return dest;
+}
+
+// Destroys [first, last). Runs of checked_intrusive_ptr to the same object give their references back with a single
+// fetch_sub, any other type is destroyed one by one.
+//
+template <typename Ptr>
+void destroy_coalesced(Ptr *first, Ptr *last) noexcept //NOLINT(readability-identifier-naming)
+{
+    std::destroy(first, last);
+}
+
+template <typename T, typename P>
+void destroy_coalesced(checked_intrusive_ptr<T, P> *first, checked_intrusive_ptr<T, P> *last) noexcept //NOLINT(readability-identifier-naming)
+{
+    while (first != last)
+    {
+        const std::ptrdiff_t length = detail::runLength<checked_intrusive_ptr<T, P>>(first, last);
+        T *ptr = first->get();
+
+        for (std::ptrdiff_t i = 0; i < length; ++i)
+        {
+            (void)first[i].detach();
+            first[i].~checked_intrusive_ptr<T, P>();
+        }
+
+        if (ptr != nullptr)
+            detail::releaseIntrusiveRefs(ptr, length);
+
+        first += length;
+    }
+}
+
+}  // namespace sia
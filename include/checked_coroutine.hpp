@@ -0,0 +1,239 @@
+#pragma once
+
+#include "checked_shared_ptr.hpp"
+
+// Coroutine utilities, available when compiling with coroutine support (C++20).
+//
+#if defined(__cpp_impl_coroutine) && __has_include(<coroutine>)
+
+#include <coroutine>
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace sia
+{
+
+// Result of keep_alive(). It never suspends, co_await just hands out the pinned pointer, which then lives in the
+// coroutine frame until the coroutine finishes.
+//
+template <typename T, typename CheckPolicy>
+class keep_alive_awaiter //NOLINT(readability-identifier-naming)
+{
+    public:
+    explicit keep_alive_awaiter(checked_shared_ptr<T, CheckPolicy> ptr) noexcept : m_ptr(std::move(ptr))
+    {
+    }
+
+    bool await_ready() const noexcept //NOLINT(readability-identifier-naming)
+    {
+        return true;
+    }
+
+    void await_suspend(std::coroutine_handle<> /*handle*/) const noexcept //NOLINT(readability-identifier-naming)
+    {
+    }
+
+    [[nodiscard]] checked_shared_ptr<T, CheckPolicy> await_resume() noexcept //NOLINT(readability-identifier-naming)
+    {
+        return std::move(m_ptr);
+    }
+
+    private:
+    checked_shared_ptr<T, CheckPolicy> m_ptr;
+};
+
+// Pins the object a member coroutine runs on, for as long as the coroutine runs:
+//
+//     Task Session::run()
+//     {
+//         auto self = co_await sia::keep_alive(this);
+//         ...
+//     }
+//
+// T has to derive from std::enable_shared_from_this and be owned by a shared pointer. This takes exactly one
+// reference, unlike passing a copy of the owner into the coroutine through a lambda or a parameter. A null this is
+// reported to the check policy.
+//
+template <typename CheckPolicy = SIA_CSP_DEFAULT_CHECK_POLICY, typename T>
+keep_alive_awaiter<T, CheckPolicy> keep_alive(T *self) noexcept(CheckPolicy::is_noexcept) //NOLINT(readability-identifier-naming)
+{
+    detail::checkNullPtr<CheckPolicy>(self);
+    return keep_alive_awaiter<T, CheckPolicy>(std::static_pointer_cast<T>(self->shared_from_this()));
+}
+
+// Pins an object the caller already owns. The rvalue overload takes over the reference without any refcount traffic.
+//
+template <typename T, typename P>
+keep_alive_awaiter<T, P> keep_alive(const checked_shared_ptr<T, P> &ptr) noexcept //NOLINT(readability-identifier-naming)
+{
+    return keep_alive_awaiter<T, P>(ptr);
+}
+
+template <typename T, typename P>
+keep_alive_awaiter<T, P> keep_alive(checked_shared_ptr<T, P> &&ptr) noexcept //NOLINT(readability-identifier-naming)
+{
+    return keep_alive_awaiter<T, P>(std::move(ptr));
+}
+
+namespace detail
+{
+
+template <typename Awaitable, typename = void>
+struct has_member_co_await : std::false_type //NOLINT(readability-identifier-naming)
+{
+};
+
+template <typename Awaitable>
+struct has_member_co_await<Awaitable, std::void_t<decltype(std::declval<Awaitable &>().operator co_await())>>
+    : std::true_type
+{
+};
+
+template <typename Awaitable>
+decltype(auto) getAwaiter(Awaitable &awaitable)
+{
+    if constexpr (has_member_co_await<Awaitable>::value)
+        return awaitable.operator co_await();
+    else
+        return (awaitable);
+}
+
+}  // namespace detail
+
+// Wraps another awaitable and applies the null check to ptr when the coroutine resumes. ptr is held by reference, so
+// it sees whatever happened to it while the coroutine was suspended, e.g. a member which was reset on shutdown.
+//
+template <typename T, typename CheckPolicy, typename Awaitable>
+class checked_resume_awaiter //NOLINT(readability-identifier-naming)
+{
+    using Stored = std::conditional_t<std::is_lvalue_reference_v<Awaitable>, Awaitable, std::remove_cvref_t<Awaitable>>;
+    using Awaiter = decltype(detail::getAwaiter(std::declval<std::remove_reference_t<Stored> &>()));
+
+    public:
+    checked_resume_awaiter(const checked_shared_ptr<T, CheckPolicy> &ptr, Awaitable &&awaitable)
+        : m_ptr(ptr), m_awaitable(std::forward<Awaitable>(awaitable)), m_awaiter(detail::getAwaiter(m_awaitable))
+    {
+    }
+
+    // m_awaiter may refer to m_awaitable.
+    //
+    checked_resume_awaiter(const checked_resume_awaiter &) = delete;
+    checked_resume_awaiter &operator=(const checked_resume_awaiter &) = delete;
+
+    bool await_ready() //NOLINT(readability-identifier-naming)
+    {
+        return m_awaiter.await_ready();
+    }
+
+    template <typename Promise>
+    decltype(auto) await_suspend(std::coroutine_handle<Promise> handle) //NOLINT(readability-identifier-naming)
+    {
+        return m_awaiter.await_suspend(handle);
+    }
+
+    decltype(auto) await_resume() //NOLINT(readability-identifier-naming)
+    {
+        detail::checkNullPtr<CheckPolicy>(m_ptr.get());
+        return m_awaiter.await_resume();
+    }
+
+    private:
+    const checked_shared_ptr<T, CheckPolicy> &m_ptr;
+    Stored m_awaitable;
+    Awaiter m_awaiter;
+};
+
+template <typename T, typename P, typename Awaitable>
+checked_resume_awaiter<T, P, Awaitable> checked_resume(const checked_shared_ptr<T, P> &ptr, Awaitable &&awaitable) //NOLINT(readability-identifier-naming)
+{
+    return checked_resume_awaiter<T, P, Awaitable>(ptr, std::forward<Awaitable>(awaitable));
+}
+
+// Derive a promise type from this to allocate the coroutine frames from a std::pmr::memory_resource passed as
+// std::allocator_arg, resource (or a polymorphic_allocator) in front of the other parameters, e.g. the same arena the
+// objects come from by allocate_checked_shared. Member coroutines take them after the implicit object parameter.
+// Coroutines without these parameters use the global operator new. Every frame is released by the usual operator
+// delete, which finds the resource in a header in front of the frame. GCC 12 pairs the templated operator new with
+// that operator delete and reports a false -Wmismatched-new-delete at the coroutines.
+//
+//     Task handle(std::allocator_arg_t, std::pmr::memory_resource *, sia::checked_shared_ptr<Request> request);
+//
+struct checked_frame_allocation //NOLINT(readability-identifier-naming)
+{
+    template <typename... Args>
+    static void *operator new(std::size_t size, std::allocator_arg_t /*tag*/, std::pmr::memory_resource *resource,
+                              Args &.../*args*/)
+    {
+        return allocateFrame(size, resource);
+    }
+
+    template <typename U, typename... Args>
+    static void *operator new(std::size_t size, std::allocator_arg_t /*tag*/,
+                              const std::pmr::polymorphic_allocator<U> &alloc, Args &.../*args*/)
+    {
+        return allocateFrame(size, alloc.resource());
+    }
+
+    template <typename Self, typename... Args>
+    static void *operator new(std::size_t size, Self & /*self*/, std::allocator_arg_t /*tag*/,
+                              std::pmr::memory_resource *resource, Args &.../*args*/)
+    {
+        return allocateFrame(size, resource);
+    }
+
+    template <typename Self, typename U, typename... Args>
+    static void *operator new(std::size_t size, Self & /*self*/, std::allocator_arg_t /*tag*/,
+                              const std::pmr::polymorphic_allocator<U> &alloc, Args &.../*args*/)
+    {
+        return allocateFrame(size, alloc.resource());
+    }
+
+    static void *operator new(std::size_t size)
+    {
+        return allocateFrame(size, nullptr);
+    }
+
+    static void operator delete(void *frame, std::size_t /*size*/) noexcept
+    {
+        deallocateFrame(frame);
+    }
+
+    private:
+    // Sits in front of every frame.
+    //
+    struct Header
+    {
+        std::pmr::memory_resource *m_resource;
+        std::size_t m_bytes;
+    };
+
+    static constexpr std::size_t kFrameAlignment = __STDCPP_DEFAULT_NEW_ALIGNMENT__;
+    static constexpr std::size_t kHeaderSize = (sizeof(Header) + kFrameAlignment - 1) / kFrameAlignment * kFrameAlignment;
+
+    static void *allocateFrame(std::size_t size, std::pmr::memory_resource *resource)
+    {
+        const std::size_t bytes = kHeaderSize + size;
+        void *block = resource != nullptr ? resource->allocate(bytes, kFrameAlignment) : ::operator new(bytes);
+        ::new (block) Header{resource, bytes};
+        return static_cast<std::byte *>(block) + kHeaderSize;
+    }
+
+    static void deallocateFrame(void *frame) noexcept
+    {
+        void *block = static_cast<std::byte *>(frame) - kHeaderSize;
+        const Header header = *static_cast<Header *>(block);
+
+        if (header.m_resource != nullptr)
+            header.m_resource->deallocate(block, header.m_bytes, kFrameAlignment);
+        else
+            ::operator delete(block, header.m_bytes);
+    }
+};
+
+}  // namespace sia
+
+#endif
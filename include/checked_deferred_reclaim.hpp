@@ -0,0 +1,351 @@
+#pragma once
+
+#include "checked_shared_ptr.hpp"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+namespace sia
+{
+
+namespace detail
+{
+
+// Header in front of every object created with deferred reclamation, links it into a reclamation_queue once the
+// last reference is gone.
+//
+struct reclaim_node //NOLINT(readability-identifier-naming)
+{
+    reclaim_node *m_next{nullptr};
+    void (*m_destroy)(reclaim_node *) noexcept {nullptr};
+};
+
+template <typename T>
+struct deferred_node final : reclaim_node //NOLINT(readability-identifier-naming)
+{
+    template <typename... Args>
+    explicit deferred_node(Args &&...args) : m_value(std::forward<Args>(args)...)
+    {
+        m_destroy = [](reclaim_node *node) noexcept { delete static_cast<deferred_node *>(node); };
+    }
+
+    T m_value;
+};
+
+}  // namespace detail
+
+// Queue of objects whose last checked_shared_ptr is gone but which are not destroyed yet. Retiring an object is a
+// single compare and swap on an intrusive list, the destructors run later in flush(): either on a background thread
+// started with start(), or at a safe point chosen by the owner of the queue. Objects retired while a flush is running
+// are picked up by the same flush, so a deep graph is torn down iteratively instead of recursively.
+//
+// The queue is bounded by its capacity. Once it is full the releasing thread destroys the object inline, as if it had
+// not been deferred at all.
+//
+class reclamation_queue //NOLINT(readability-identifier-naming)
+{
+    public:
+    static constexpr std::size_t kDefaultCapacity = std::size_t{1} << 16U;
+
+    explicit reclamation_queue(std::size_t capacity = kDefaultCapacity) noexcept : m_capacity(capacity)
+    {
+    }
+
+    reclamation_queue(const reclamation_queue &) = delete;
+    reclamation_queue &operator=(const reclamation_queue &) = delete;
+
+    // Stops the background thread if any and destroys everything still queued.
+    //
+    ~reclamation_queue()
+    {
+        stop();
+    }
+
+    // Process wide queue drained by a background thread. It lives until the process exits, at exit the thread is
+    // stopped, the queue is flushed and later releases are destroyed inline.
+    //
+    static reclamation_queue &background()
+    {
+        static reclamation_queue *queue = []
+        {
+            auto *created = new reclamation_queue();  //NOLINT(cppcoreguidelines-owning-memory)
+            created->start();
+            std::atexit([] { background().stop(); });
+            return created;
+        }();
+
+        return *queue;
+    }
+
+    // Queue of the calling thread, only drained by flush() calls of that thread and when the thread exits.
+    //
+    static reclamation_queue *threadBatch() noexcept
+    {
+        thread_local bool gone = false;
+        thread_local struct Batch
+        {
+            ~Batch()
+            {
+                m_queue.flush();
+                gone = true;
+            }
+
+            reclamation_queue m_queue{};
+        } batch{};
+
+        return gone ? nullptr : &batch.m_queue;
+    }
+
+    // Starts a thread which flushes the queue every interval, or earlier once it is half full.
+    //
+    // start() and stop() must not be called concurrently from different threads. The one exception is stop() called
+    // by the background thread itself.
+    //
+    void start(std::chrono::microseconds interval = std::chrono::milliseconds(1))
+    {
+        joinStoppedWorker();
+        std::lock_guard<std::mutex> lock{m_mutex};
+
+        if (m_worker.joinable())
+            return;
+
+        m_running = true;
+        m_closed.store(false, std::memory_order_release);
+
+        const std::uint64_t generation = ++m_generation;
+        m_worker = std::thread(
+            [this, interval, generation]
+            {
+                std::unique_lock<std::mutex> worker_lock{m_mutex};
+
+                // A worker which stopped itself may still be finishing its flush when the queue is started again.
+                //
+                while (m_running && m_generation == generation)
+                {
+                    m_wakeup.wait_for(worker_lock, interval);
+
+                    worker_lock.unlock();
+                    flush();
+                    worker_lock.lock();
+                }
+            });
+    }
+
+    // Joins the background thread and destroys everything still queued on the calling thread. Objects retired
+    // afterwards are destroyed inline.
+    //
+    // The background thread cannot join itself, e.g. when the destructor of an object it reclaims stops the queue.
+    // It then leaves its loop after the current flush and is joined by the next start() or stop() on another thread,
+    // at the latest by the destructor. The queue must not be destroyed by its own background thread.
+    //
+    void stop()
+    {
+        std::thread worker{};
+        {
+            std::lock_guard<std::mutex> lock{m_mutex};
+            m_running = false;
+            m_closed.store(true);
+
+            if (m_worker.get_id() == std::this_thread::get_id())
+                m_stopped_worker = std::move(m_worker);
+            else
+                worker = std::move(m_worker);
+        }
+
+        m_wakeup.notify_all();
+
+        if (worker.joinable())
+            worker.join();
+
+        joinStoppedWorker();
+        flush();
+    }
+
+    // Destroys the queued objects, including the ones retired by their destructors, and returns how many.
+    //
+    std::size_t flush() noexcept
+    {
+        std::size_t destroyed = 0;
+
+        for (;;)
+        {
+            // Sequentially consistent, so that either stop() sees the nodes pushed by retire() or retire() sees that
+            // the queue is closed.
+            //
+            detail::reclaim_node *node = m_head.exchange(nullptr);
+
+            if (node == nullptr)
+                return destroyed;
+
+            // Retire order is the reverse of the list, destroy the oldest first.
+            //
+            detail::reclaim_node *oldest = nullptr;
+            std::size_t count = 0;
+
+            while (node != nullptr)
+            {
+                detail::reclaim_node *next = node->m_next;
+                node->m_next = oldest;
+                oldest = node;
+                node = next;
+                ++count;
+            }
+
+            m_size.fetch_sub(count, std::memory_order_relaxed);
+
+            while (oldest != nullptr)
+            {
+                detail::reclaim_node *next = oldest->m_next;
+                oldest->m_destroy(oldest);
+                oldest = next;
+            }
+
+            destroyed += count;
+        }
+    }
+
+    void retire(detail::reclaim_node *node) noexcept
+    {
+        const std::size_t size = m_size.fetch_add(1, std::memory_order_relaxed);
+
+        if (size >= m_capacity.load(std::memory_order_relaxed) || m_closed.load(std::memory_order_acquire))
+        {
+            m_size.fetch_sub(1, std::memory_order_relaxed);
+            m_overflows.fetch_add(1, std::memory_order_relaxed);
+            node->m_destroy(node);
+            return;
+        }
+
+        node->m_next = m_head.load(std::memory_order_relaxed);
+        while (!m_head.compare_exchange_weak(node->m_next, node, std::memory_order_seq_cst, std::memory_order_relaxed))
+        {
+        }
+
+        // The queue may have been stopped between the check above and the push, after its last flush.
+        //
+        if (m_closed.load())
+        {
+            flush();
+            return;
+        }
+
+        if (size + 1 == m_capacity.load(std::memory_order_relaxed) / 2)
+            m_wakeup.notify_one();
+    }
+
+    [[nodiscard]] std::size_t size() const noexcept
+    {
+        return m_size.load(std::memory_order_relaxed);
+    }
+
+    [[nodiscard]] std::size_t capacity() const noexcept
+    {
+        return m_capacity.load(std::memory_order_relaxed);
+    }
+
+    void setCapacity(std::size_t capacity) noexcept
+    {
+        m_capacity.store(capacity, std::memory_order_relaxed);
+    }
+
+    // Number of objects destroyed inline because the queue was full or stopped.
+    //
+    [[nodiscard]] std::size_t overflows() const noexcept
+    {
+        return m_overflows.load(std::memory_order_relaxed);
+    }
+
+    private:
+    // Joins the background thread which stopped itself, unless that is the caller. The handle is taken under the lock
+    // since that thread may still be inside stop(), and joined outside of it since it may still be flushing.
+    //
+    void joinStoppedWorker()
+    {
+        std::thread stopped{};
+        {
+            std::lock_guard<std::mutex> lock{m_mutex};
+
+            if (m_stopped_worker.get_id() != std::this_thread::get_id())
+                stopped = std::move(m_stopped_worker);
+        }
+
+        if (stopped.joinable())
+            stopped.join();
+    }
+
+    std::atomic<detail::reclaim_node *> m_head{nullptr};
+    std::atomic<std::size_t> m_size{0};
+    std::atomic<std::size_t> m_capacity;
+    std::atomic<std::size_t> m_overflows{0};
+    std::atomic<bool> m_closed{false};
+
+    std::mutex m_mutex{};
+    std::condition_variable m_wakeup{};
+    bool m_running{false};
+    std::uint64_t m_generation{0};
+    std::thread m_worker{};
+    std::thread m_stopped_worker{};
+};
+
+// Selects where the final release of an object made by make_checked_shared is destroyed. A null queue stands for
+// reclamation_queue::threadBatch() of the thread which releases the last reference.
+//
+struct deferred_reclaim_t //NOLINT(readability-identifier-naming)
+{
+    reclamation_queue *m_queue{nullptr};
+};
+
+inline constexpr deferred_reclaim_t reclaim_at_safe_point{}; //NOLINT(readability-identifier-naming)
+
+inline deferred_reclaim_t reclaim_on(reclamation_queue &queue) noexcept //NOLINT(readability-identifier-naming)
+{
+    return deferred_reclaim_t{&queue};
+}
+
+inline deferred_reclaim_t reclaim_in_background() //NOLINT(readability-identifier-naming)
+{
+    return deferred_reclaim_t{&reclamation_queue::background()};
+}
+
+namespace detail
+{
+
+template <typename T>
+struct deferred_deleter //NOLINT(readability-identifier-naming)
+{
+    void operator()(T * /*ptr*/) const noexcept
+    {
+        reclamation_queue *queue = m_queue != nullptr ? m_queue : reclamation_queue::threadBatch();
+
+        if (queue != nullptr)
+            queue->retire(m_node);
+        else
+            m_node->m_destroy(m_node);
+    }
+
+    reclamation_queue *m_queue;
+    reclaim_node *m_node;
+};
+
+}  // namespace detail
+
+// Same as make_checked_shared but the object is destroyed by a reclamation_queue after the last reference is gone.
+// The object and the control block are allocated separately. Weak pointers expire as usual as soon as the last
+// reference is gone.
+//
+template <typename T, typename... Args>
+sia::checked_shared_ptr<T> make_checked_shared(deferred_reclaim_t reclaim, Args &&...args)
+{
+    // Should the control block fail to allocate, std::shared_ptr hands the object to the deleter.
+    //
+    auto *node = new detail::deferred_node<T>(std::forward<Args>(args)...);  //NOLINT(cppcoreguidelines-owning-memory)
+    return std::shared_ptr<T>(&node->m_value, detail::deferred_deleter<T>{reclaim.m_queue, node});
+}
+
+}  // namespace sia
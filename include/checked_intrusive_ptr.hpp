@@ -0,0 +1,423 @@
+#pragma once
+
+#include "checked_shared_ptr.hpp"
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <ostream>
+#include <type_traits>
+
+namespace sia
+{
+
+// Keeps the reference count inside the object. Derive your type T from checked_intrusive_ref_counter<T> to be able
+// to manage it by checked_intrusive_ptr. If T is used polymorphically it must have a virtual destructor since the
+// last owner deletes it through T *.
+//
+// Any other type can be managed as well by providing the following functions findable by ADL:
+//   void checkedIntrusiveAddRef(const T *);
+//   void checkedIntrusiveRelease(const T *);
+//   std::int64_t checkedIntrusiveUseCount(const T *);
+//
+// Optionally, the bulk operations of checked_bulk.hpp use these to add or release count references at once:
+//   void checkedIntrusiveAddRefs(const T *, std::int64_t count);
+//   void checkedIntrusiveReleaseRefs(const T *, std::int64_t count);
+//
+template <typename T>
+class checked_intrusive_ref_counter //NOLINT(readability-identifier-naming)
+{
+    template <typename U>
+    friend void checkedIntrusiveAddRef(const checked_intrusive_ref_counter<U> *ptr) noexcept;
+
+    template <typename U>
+    friend void checkedIntrusiveRelease(const checked_intrusive_ref_counter<U> *ptr) noexcept;
+
+    template <typename U>
+    friend std::int64_t checkedIntrusiveUseCount(const checked_intrusive_ref_counter<U> *ptr) noexcept;
+
+    template <typename U>
+    friend void checkedIntrusiveAddRefs(const checked_intrusive_ref_counter<U> *ptr, std::int64_t count) noexcept;
+
+    template <typename U>
+    friend void checkedIntrusiveReleaseRefs(const checked_intrusive_ref_counter<U> *ptr, std::int64_t count) noexcept;
+
+    protected:
+    constexpr checked_intrusive_ref_counter() noexcept = default;
+
+    // The reference count belongs to the object identity, it is never copied.
+    //
+    checked_intrusive_ref_counter(const checked_intrusive_ref_counter &) noexcept
+    {
+    }
+
+    checked_intrusive_ref_counter &operator=(const checked_intrusive_ref_counter &) noexcept
+    {
+        return *this;
+    }
+
+    ~checked_intrusive_ref_counter() = default;
+
+    private:
+    mutable std::atomic<std::int64_t> m_ref_count{0};
+};
+
+template <typename U>
+inline void checkedIntrusiveAddRef(const checked_intrusive_ref_counter<U> *ptr) noexcept
+{
+    ptr->m_ref_count.fetch_add(1, std::memory_order_relaxed);
+}
+
+template <typename U>
+inline void checkedIntrusiveRelease(const checked_intrusive_ref_counter<U> *ptr) noexcept
+{
+    if (ptr->m_ref_count.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        delete static_cast<const U *>(ptr);
+}
+
+template <typename U>
+inline std::int64_t checkedIntrusiveUseCount(const checked_intrusive_ref_counter<U> *ptr) noexcept
+{
+    return ptr->m_ref_count.load(std::memory_order_relaxed);
+}
+
+template <typename U>
+inline void checkedIntrusiveAddRefs(const checked_intrusive_ref_counter<U> *ptr, std::int64_t count) noexcept
+{
+    ptr->m_ref_count.fetch_add(count, std::memory_order_relaxed);
+}
+
+template <typename U>
+inline void checkedIntrusiveReleaseRefs(const checked_intrusive_ref_counter<U> *ptr, std::int64_t count) noexcept
+{
+    if (ptr->m_ref_count.fetch_sub(count, std::memory_order_acq_rel) == count)
+        delete static_cast<const U *>(ptr);
+}
+
+// A single word smart pointer with the same null checking as checked_shared_ptr. The reference count lives inside
+// the managed object so there is neither a control block nor a second allocation.
+//
+template <typename T, typename CheckPolicy = SIA_CSP_DEFAULT_CHECK_POLICY>
+class checked_intrusive_ptr final //NOLINT(readability-identifier-naming)
+{
+    template <typename U, typename Q>
+    friend class checked_intrusive_ptr;
+
+    template <typename U>
+    using Convertible = std::enable_if_t<std::is_convertible_v<U *, T *>>;
+
+    public:
+    using element_type = T;
+
+    // Default contructor.
+    //
+    constexpr checked_intrusive_ptr() noexcept = default;
+
+    // Contructor accepting nullptr.
+    //
+    constexpr checked_intrusive_ptr(std::nullptr_t) noexcept //NOLINT(google-explicit-constructor)
+    {
+    }
+
+    // Constructor accepting raw pointer. Pass add_ref = false to adopt a reference which is already counted,
+    // e.g. one returned by detach().
+    //
+    template <typename U, typename = Convertible<U>>
+    explicit checked_intrusive_ptr(U *ptr, bool add_ref = true) noexcept : m_ptr(ptr)
+    {
+        if (m_ptr != nullptr && add_ref)
+            checkedIntrusiveAddRef(m_ptr);
+    }
+
+    // Default copy constructor.
+    //
+    checked_intrusive_ptr(const checked_intrusive_ptr &r) noexcept : checked_intrusive_ptr(r.m_ptr)
+    {
+    }
+
+    // Conversion copy constructor.
+    //
+    template <typename U, typename Q, typename = Convertible<U>>
+    explicit checked_intrusive_ptr(const checked_intrusive_ptr<U, Q> &r) noexcept : checked_intrusive_ptr(r.m_ptr)
+    {
+    }
+
+    // Default move constructor.
+    //
+    checked_intrusive_ptr(checked_intrusive_ptr &&r) noexcept : m_ptr(r.m_ptr)
+    {
+        r.m_ptr = nullptr;
+    }
+
+    // Conversion move constructor.
+    //
+    template <typename U, typename Q, typename = Convertible<U>>
+    explicit checked_intrusive_ptr(checked_intrusive_ptr<U, Q> &&r) noexcept : m_ptr(r.m_ptr)
+    {
+        r.m_ptr = nullptr;
+    }
+
+    ~checked_intrusive_ptr()
+    {
+        if (m_ptr != nullptr)
+            checkedIntrusiveRelease(m_ptr);
+    }
+
+    // Default copy assignment operator.
+    //
+    checked_intrusive_ptr &operator=(const checked_intrusive_ptr &r) noexcept
+    {
+        checked_intrusive_ptr(r).swap(*this);
+        return *this;
+    }
+
+    // Conversion copy assignment operator.
+    //
+    template <typename U, typename Q, typename = Convertible<U>>
+    checked_intrusive_ptr &operator=(const checked_intrusive_ptr<U, Q> &r) noexcept
+    {
+        checked_intrusive_ptr(r).swap(*this);
+        return *this;
+    }
+
+    // Default move assignment operator.
+    //
+    checked_intrusive_ptr &operator=(checked_intrusive_ptr &&r) noexcept
+    {
+        checked_intrusive_ptr(std::move(r)).swap(*this);
+        return *this;
+    }
+
+    // Conversion move assignment operator.
+    //
+    template <typename U, typename Q, typename = Convertible<U>>
+    checked_intrusive_ptr &operator=(checked_intrusive_ptr<U, Q> &&r) noexcept
+    {
+        checked_intrusive_ptr(std::move(r)).swap(*this);
+        return *this;
+    }
+
+    void reset() noexcept
+    {
+        checked_intrusive_ptr().swap(*this);
+    }
+
+    template <typename U, typename = Convertible<U>>
+    void reset(U *ptr, bool add_ref = true) noexcept
+    {
+        checked_intrusive_ptr(ptr, add_ref).swap(*this);
+    }
+
+    void swap(checked_intrusive_ptr &r) noexcept
+    {
+        std::swap(m_ptr, r.m_ptr);
+    }
+
+    // Gives up the ownership without touching the reference count.
+    //
+    [[nodiscard]] element_type *detach() noexcept
+    {
+        element_type *ptr = m_ptr;
+        m_ptr = nullptr;
+        return ptr;
+    }
+
+    element_type *get() const noexcept
+    {
+        return m_ptr;
+    }
+
+    [[nodiscard]] std::int64_t use_count() const noexcept //NOLINT(readability-identifier-naming)
+    {
+        return m_ptr != nullptr ? checkedIntrusiveUseCount(m_ptr) : 0;
+    }
+
+    element_type &operator*() const noexcept(CheckPolicy::is_noexcept)
+    {
+        throwIfNullPtr();
+        return *m_ptr;
+    }
+
+    element_type *operator->() const noexcept(CheckPolicy::is_noexcept)
+    {
+        throwIfNullPtr();
+        return m_ptr;
+    }
+
+    explicit operator bool() const noexcept
+    {
+        return m_ptr != nullptr;
+    }
+
+    private:
+    inline void throwIfNullPtr() const noexcept(CheckPolicy::is_noexcept)
+    {
+        detail::checkNullPtr<CheckPolicy>(m_ptr);
+    }
+
+    element_type *m_ptr{nullptr};
+};
+
+template <typename T, typename... Args>
+sia::checked_intrusive_ptr<T> make_checked_intrusive(Args &&...args)
+{
+    return sia::checked_intrusive_ptr<T>(new T(std::forward<Args>(args)...));
+}
+
+template <typename Ch, typename Tr, typename Tp, typename P>
+inline std::basic_ostream<Ch, Tr> &operator<<(std::basic_ostream<Ch, Tr> &os, const checked_intrusive_ptr<Tp, P> &p)
+{
+    os << p.get();
+    return os;
+}
+
+template <typename T, typename P>
+inline bool operator==(const checked_intrusive_ptr<T, P> &lhs, std::nullptr_t) noexcept
+{
+    return lhs.get() == nullptr;
+}
+
+template <typename T, typename P>
+inline bool operator==(std::nullptr_t, const checked_intrusive_ptr<T, P> &lhs) noexcept
+{
+    return lhs.get() == nullptr;
+}
+
+template <typename T, typename P, typename U, typename Q>
+inline bool operator==(const checked_intrusive_ptr<T, P> &lhs, const checked_intrusive_ptr<U, Q> &rhs) noexcept
+{
+    return lhs.get() == rhs.get();
+}
+
+template <typename T, typename P>
+inline bool operator!=(const checked_intrusive_ptr<T, P> &lhs, std::nullptr_t) noexcept
+{
+    return lhs.get() != nullptr;
+}
+
+template <typename T, typename P>
+inline bool operator!=(std::nullptr_t, const checked_intrusive_ptr<T, P> &lhs) noexcept
+{
+    return lhs.get() != nullptr;
+}
+
+template <typename T, typename P, typename U, typename Q>
+inline bool operator!=(const checked_intrusive_ptr<T, P> &lhs, const checked_intrusive_ptr<U, Q> &rhs) noexcept
+{
+    return lhs.get() != rhs.get();
+}
+
+template <typename T, typename P, typename U, typename Q>
+inline bool operator<(const checked_intrusive_ptr<T, P> &lhs, const checked_intrusive_ptr<U, Q> &rhs) noexcept
+{
+    using RsT = std::common_type_t<T *, U *>;
+    return std::less<RsT>()(lhs.get(), rhs.get());
+}
+
+template <typename T, typename P>
+inline bool operator<(const checked_intrusive_ptr<T, P> &r, std::nullptr_t) noexcept
+{
+    return std::less<T *>()(r.get(), nullptr);
+}
+
+template <typename T, typename P>
+inline bool operator<(std::nullptr_t, const checked_intrusive_ptr<T, P> &r) noexcept
+{
+    return std::less<T *>()(nullptr, r.get());
+}
+
+template <typename T, typename P, typename U, typename Q>
+inline bool operator<=(const checked_intrusive_ptr<T, P> &lhs, const checked_intrusive_ptr<U, Q> &rhs) noexcept
+{
+    return !(rhs < lhs);
+}
+
+template <typename T, typename P>
+inline bool operator<=(const checked_intrusive_ptr<T, P> &r, std::nullptr_t) noexcept
+{
+    return !(nullptr < r);
+}
+
+template <typename T, typename P>
+inline bool operator<=(std::nullptr_t, const checked_intrusive_ptr<T, P> &r) noexcept
+{
+    return !(r < nullptr);
+}
+
+template <typename T, typename P, typename U, typename Q>
+inline bool operator>(const checked_intrusive_ptr<T, P> &lhs, const checked_intrusive_ptr<U, Q> &rhs) noexcept
+{
+    return rhs < lhs;
+}
+
+template <typename T, typename P>
+inline bool operator>(const checked_intrusive_ptr<T, P> &r, std::nullptr_t) noexcept
+{
+    return nullptr < r;
+}
+
+template <typename T, typename P>
+inline bool operator>(std::nullptr_t, const checked_intrusive_ptr<T, P> &r) noexcept
+{
+    return r < nullptr;
+}
+
+template <typename T, typename P, typename U, typename Q>
+inline bool operator>=(const checked_intrusive_ptr<T, P> &lhs, const checked_intrusive_ptr<U, Q> &rhs) noexcept
+{
+    return !(lhs < rhs);
+}
+
+template <typename T, typename P>
+inline bool operator>=(const checked_intrusive_ptr<T, P> &r, std::nullptr_t) noexcept
+{
+    return !(r < nullptr);
+}
+
+template <typename T, typename P>
+inline bool operator>=(std::nullptr_t, const checked_intrusive_ptr<T, P> &r) noexcept
+{
+    return !(nullptr < r);
+}
+
+template <typename T, typename P>
+inline void swap(checked_intrusive_ptr<T, P> &a, checked_intrusive_ptr<T, P> &b) noexcept
+{
+    a.swap(b);
+}
+}  // namespace sia
+
+namespace std
+{
+template <typename _Tp, typename _Pp>
+struct hash<sia::checked_intrusive_ptr<_Tp, _Pp>>
+{
+    size_t operator()(const sia::checked_intrusive_ptr<_Tp, _Pp> &__s) const noexcept
+    {
+        return sia::detail::hashPointer(__s.get());
+    }
+};
+
+template <typename T, typename U, typename P>
+inline ::sia::checked_intrusive_ptr<T, P> static_pointer_cast(const ::sia::checked_intrusive_ptr<U, P> &__r) noexcept
+{
+    return ::sia::checked_intrusive_ptr<T, P>(static_cast<T *>(__r.get()));
+}
+
+template <typename T, typename U, typename P>
+inline ::sia::checked_intrusive_ptr<T, P> dynamic_pointer_cast(const ::sia::checked_intrusive_ptr<U, P> &__r) noexcept
+{
+    return ::sia::checked_intrusive_ptr<T, P>(dynamic_cast<T *>(__r.get()));
+}
+
+template <typename T, typename U, typename P>
+inline ::sia::checked_intrusive_ptr<T, P> const_pointer_cast(const ::sia::checked_intrusive_ptr<U, P> &__r) noexcept
+{
+    return ::sia::checked_intrusive_ptr<T, P>(const_cast<T *>(__r.get()));
+}
+
+template <typename T, typename U, typename P>
+inline ::sia::checked_intrusive_ptr<T, P> reinterpret_pointer_cast(const ::sia::checked_intrusive_ptr<U, P> &__r) noexcept
+{
+    return ::sia::checked_intrusive_ptr<T, P>(reinterpret_cast<T *>(__r.get()));
+}
+}  // namespace std
@@ -0,0 +1,500 @@
+#pragma once
+
+#include "checked_shared_ptr.hpp"
+#include <cassert>
+#include <cstdint>
+#include <functional>
+#include <new>
+#include <ostream>
+#include <thread>
+#include <type_traits>
+
+// When enabled every reference count update and every dereference asserts that it happens on the thread which
+// created the managed object. Off by default: the control block then stores the owner thread, so the switch must be
+// the same for everything linked into one program.
+//
+#ifndef SIA_CSP_CHECK_LOCAL_PTR_OWNER
+#define SIA_CSP_CHECK_LOCAL_PTR_OWNER 0
+#endif
+
+namespace sia::detail
+{
+
+// Control block with a plain integer reference count. It must never be shared across threads.
+//
+struct local_control_block //NOLINT(readability-identifier-naming)
+{
+    local_control_block() = default;
+    local_control_block(const local_control_block &) = delete;
+    local_control_block &operator=(const local_control_block &) = delete;
+
+    void addRef() noexcept
+    {
+        assertOwnerThread();
+        ++m_use_count;
+    }
+
+    void release() noexcept
+    {
+        assertOwnerThread();
+        if (--m_use_count == 0)
+        {
+            dispose();
+            destroy();
+        }
+    }
+
+    [[nodiscard]] std::int64_t useCount() const noexcept
+    {
+        return m_use_count;
+    }
+
+    void assertOwnerThread() const noexcept
+    {
+#if SIA_CSP_CHECK_LOCAL_PTR_OWNER
+        assert(m_owner == std::this_thread::get_id() && "checked_local_ptr is touched by a foreign thread");
+#endif
+    }
+
+    protected:
+    ~local_control_block() = default;
+
+    // Destroys the managed object.
+    //
+    virtual void dispose() noexcept = 0;
+
+    // Frees the control block itself.
+    //
+    virtual void destroy() noexcept = 0;
+
+    private:
+    std::int64_t m_use_count{1};
+#if SIA_CSP_CHECK_LOCAL_PTR_OWNER
+    std::thread::id m_owner{std::this_thread::get_id()};
+#endif
+};
+
+// Control block owning an object allocated separately, e.g. by new.
+//
+template <typename T>
+struct local_control_block_ptr final : local_control_block //NOLINT(readability-identifier-naming)
+{
+    explicit local_control_block_ptr(T *ptr) noexcept : m_ptr(ptr)
+    {
+    }
+
+    void dispose() noexcept override
+    {
+        delete m_ptr;
+    }
+
+    void destroy() noexcept override
+    {
+        delete this;
+    }
+
+    T *m_ptr;
+};
+
+// Control block with the object stored inline, used by make_checked_local() to allocate only once.
+//
+template <typename T>
+struct local_control_block_inplace final : local_control_block //NOLINT(readability-identifier-naming)
+{
+    template <typename... Args>
+    explicit local_control_block_inplace(Args &&...args)
+    {
+        ::new (static_cast<void *>(&m_storage)) T(std::forward<Args>(args)...);
+    }
+
+    T *get() noexcept
+    {
+        return std::launder(reinterpret_cast<T *>(&m_storage));
+    }
+
+    void dispose() noexcept override
+    {
+        get()->~T();
+    }
+
+    void destroy() noexcept override
+    {
+        delete this;
+    }
+
+    std::aligned_storage_t<sizeof(T), alignof(T)> m_storage;
+};
+
+}  // namespace sia::detail
+
+namespace sia
+{
+
+// Same API and null checking as checked_shared_ptr but the reference count is a plain integer. Use it for object
+// graphs which never leave the thread that created them, copies do not need any lock-prefixed instruction.
+//
+template <typename T, typename CheckPolicy = SIA_CSP_DEFAULT_CHECK_POLICY>
+class checked_local_ptr final //NOLINT(readability-identifier-naming)
+{
+    template <typename U, typename Q>
+    friend class checked_local_ptr;
+
+    template <typename U, typename... Args>
+    friend checked_local_ptr<U> make_checked_local(Args &&...args);
+
+    template <typename U>
+    using Convertible = std::enable_if_t<std::is_convertible_v<U *, T *>>;
+
+    public:
+    using element_type = T;
+
+    // Default contructor.
+    //
+    constexpr checked_local_ptr() noexcept = default;
+
+    // Contructor accepting nullptr.
+    //
+    constexpr checked_local_ptr(std::nullptr_t) noexcept //NOLINT(google-explicit-constructor)
+    {
+    }
+
+    // Constructor accepting raw pointer.
+    //
+    template <typename U, typename = Convertible<U>>
+    explicit checked_local_ptr(U *ptr) : m_ptr(ptr)
+    {
+        try
+        {
+            m_cb = new detail::local_control_block_ptr<U>(ptr);
+        }
+        catch (...)
+        {
+            delete ptr;
+            throw;
+        }
+    }
+
+    // Alising constructor.
+    //
+    template <typename U, typename Q>
+    checked_local_ptr(const checked_local_ptr<U, Q> &r, element_type *ptr) noexcept : m_ptr(ptr), m_cb(r.m_cb)
+    {
+        addRef();
+    }
+
+    // Alising constructor. Takes over the reference of r without touching the count.
+    //
+    template <typename U, typename Q>
+    checked_local_ptr(checked_local_ptr<U, Q> &&r, element_type *ptr) noexcept : m_ptr(ptr), m_cb(r.m_cb)
+    {
+        r.m_ptr = nullptr;
+        r.m_cb = nullptr;
+    }
+
+    // Default copy constructor.
+    //
+    checked_local_ptr(const checked_local_ptr &r) noexcept : m_ptr(r.m_ptr), m_cb(r.m_cb)
+    {
+        addRef();
+    }
+
+    // Conversion copy constructor.
+    //
+    template <typename U, typename Q, typename = Convertible<U>>
+    explicit checked_local_ptr(const checked_local_ptr<U, Q> &r) noexcept : m_ptr(r.m_ptr), m_cb(r.m_cb)
+    {
+        addRef();
+    }
+
+    // Default move constructor.
+    //
+    checked_local_ptr(checked_local_ptr &&r) noexcept : m_ptr(r.m_ptr), m_cb(r.m_cb)
+    {
+        r.m_ptr = nullptr;
+        r.m_cb = nullptr;
+    }
+
+    // Conversion move constructor.
+    //
+    template <typename U, typename Q, typename = Convertible<U>>
+    explicit checked_local_ptr(checked_local_ptr<U, Q> &&r) noexcept : m_ptr(r.m_ptr), m_cb(r.m_cb)
+    {
+        r.m_ptr = nullptr;
+        r.m_cb = nullptr;
+    }
+
+    ~checked_local_ptr()
+    {
+        if (m_cb != nullptr)
+            m_cb->release();
+    }
+
+    // Default copy assignment operator.
+    //
+    checked_local_ptr &operator=(const checked_local_ptr &r) noexcept
+    {
+        checked_local_ptr(r).swap(*this);
+        return *this;
+    }
+
+    // Conversion copy assignment operator.
+    //
+    template <typename U, typename Q, typename = Convertible<U>>
+    checked_local_ptr &operator=(const checked_local_ptr<U, Q> &r) noexcept
+    {
+        checked_local_ptr(r).swap(*this);
+        return *this;
+    }
+
+    // Default move assignment operator.
+    //
+    checked_local_ptr &operator=(checked_local_ptr &&r) noexcept
+    {
+        checked_local_ptr(std::move(r)).swap(*this);
+        return *this;
+    }
+
+    // Conversion move assignment operator.
+    //
+    template <typename U, typename Q, typename = Convertible<U>>
+    checked_local_ptr &operator=(checked_local_ptr<U, Q> &&r) noexcept
+    {
+        checked_local_ptr(std::move(r)).swap(*this);
+        return *this;
+    }
+
+    void reset() noexcept
+    {
+        checked_local_ptr().swap(*this);
+    }
+
+    template <typename U, typename = Convertible<U>>
+    void reset(U *ptr)
+    {
+        checked_local_ptr(ptr).swap(*this);
+    }
+
+    void swap(checked_local_ptr &r) noexcept
+    {
+        std::swap(m_ptr, r.m_ptr);
+        std::swap(m_cb, r.m_cb);
+    }
+
+    element_type *get() const noexcept
+    {
+        return m_ptr;
+    }
+
+    [[nodiscard]] std::int64_t use_count() const noexcept //NOLINT(readability-identifier-naming)
+    {
+        return m_cb != nullptr ? m_cb->useCount() : 0;
+    }
+
+    element_type &operator*() const noexcept(CheckPolicy::is_noexcept)
+    {
+        throwIfNullPtr();
+        return *m_ptr;
+    }
+
+    element_type *operator->() const noexcept(CheckPolicy::is_noexcept)
+    {
+        throwIfNullPtr();
+        return m_ptr;
+    }
+
+    explicit operator bool() const noexcept
+    {
+        return m_ptr != nullptr;
+    }
+
+    private:
+    checked_local_ptr(element_type *ptr, detail::local_control_block *cb) noexcept : m_ptr(ptr), m_cb(cb)
+    {
+    }
+
+    void addRef() const noexcept
+    {
+        if (m_cb != nullptr)
+            m_cb->addRef();
+    }
+
+    inline void throwIfNullPtr() const noexcept(CheckPolicy::is_noexcept)
+    {
+#if SIA_CSP_CHECK_LOCAL_PTR_OWNER
+        if (m_cb != nullptr)
+            m_cb->assertOwnerThread();
+#endif
+        detail::checkNullPtr<CheckPolicy>(m_ptr);
+    }
+
+    element_type *m_ptr{nullptr};
+    detail::local_control_block *m_cb{nullptr};
+};
+
+template <typename T, typename... Args>
+checked_local_ptr<T> make_checked_local(Args &&...args)
+{
+    auto *cb = new detail::local_control_block_inplace<T>(std::forward<Args>(args)...);
+    return checked_local_ptr<T>(cb->get(), cb);
+}
+
+template <typename Ch, typename Tr, typename Tp, typename P>
+inline std::basic_ostream<Ch, Tr> &operator<<(std::basic_ostream<Ch, Tr> &os, const checked_local_ptr<Tp, P> &p)
+{
+    os << p.get();
+    return os;
+}
+
+template <typename T, typename P>
+inline bool operator==(const checked_local_ptr<T, P> &lhs, std::nullptr_t) noexcept
+{
+    return lhs.get() == nullptr;
+}
+
+template <typename T, typename P>
+inline bool operator==(std::nullptr_t, const checked_local_ptr<T, P> &lhs) noexcept
+{
+    return lhs.get() == nullptr;
+}
+
+template <typename T, typename P, typename U, typename Q>
+inline bool operator==(const checked_local_ptr<T, P> &lhs, const checked_local_ptr<U, Q> &rhs) noexcept
+{
+    return lhs.get() == rhs.get();
+}
+
+template <typename T, typename P>
+inline bool operator!=(const checked_local_ptr<T, P> &lhs, std::nullptr_t) noexcept
+{
+    return lhs.get() != nullptr;
+}
+
+template <typename T, typename P>
+inline bool operator!=(std::nullptr_t, const checked_local_ptr<T, P> &lhs) noexcept
+{
+    return lhs.get() != nullptr;
+}
+
+template <typename T, typename P, typename U, typename Q>
+inline bool operator!=(const checked_local_ptr<T, P> &lhs, const checked_local_ptr<U, Q> &rhs) noexcept
+{
+    return lhs.get() != rhs.get();
+}
+
+template <typename T, typename P, typename U, typename Q>
+inline bool operator<(const checked_local_ptr<T, P> &lhs, const checked_local_ptr<U, Q> &rhs) noexcept
+{
+    using RsT = std::common_type_t<T *, U *>;
+    return std::less<RsT>()(lhs.get(), rhs.get());
+}
+
+template <typename T, typename P>
+inline bool operator<(const checked_local_ptr<T, P> &r, std::nullptr_t) noexcept
+{
+    return std::less<T *>()(r.get(), nullptr);
+}
+
+template <typename T, typename P>
+inline bool operator<(std::nullptr_t, const checked_local_ptr<T, P> &r) noexcept
+{
+    return std::less<T *>()(nullptr, r.get());
+}
+
+template <typename T, typename P, typename U, typename Q>
+inline bool operator<=(const checked_local_ptr<T, P> &lhs, const checked_local_ptr<U, Q> &rhs) noexcept
+{
+    return !(rhs < lhs);
+}
+
+template <typename T, typename P>
+inline bool operator<=(const checked_local_ptr<T, P> &r, std::nullptr_t) noexcept
+{
+    return !(nullptr < r);
+}
+
+template <typename T, typename P>
+inline bool operator<=(std::nullptr_t, const checked_local_ptr<T, P> &r) noexcept
+{
+    return !(r < nullptr);
+}
+
+template <typename T, typename P, typename U, typename Q>
+inline bool operator>(const checked_local_ptr<T, P> &lhs, const checked_local_ptr<U, Q> &rhs) noexcept
+{
+    return rhs < lhs;
+}
+
+template <typename T, typename P>
+inline bool operator>(const checked_local_ptr<T, P> &r, std::nullptr_t) noexcept
+{
+    return nullptr < r;
+}
+
+template <typename T, typename P>
+inline bool operator>(std::nullptr_t, const checked_local_ptr<T, P> &r) noexcept
+{
+    return r < nullptr;
+}
+
+template <typename T, typename P, typename U, typename Q>
+inline bool operator>=(const checked_local_ptr<T, P> &lhs, const checked_local_ptr<U, Q> &rhs) noexcept
+{
+    return !(lhs < rhs);
+}
+
+template <typename T, typename P>
+inline bool operator>=(const checked_local_ptr<T, P> &r, std::nullptr_t) noexcept
+{
+    return !(r < nullptr);
+}
+
+template <typename T, typename P>
+inline bool operator>=(std::nullptr_t, const checked_local_ptr<T, P> &r) noexcept
+{
+    return !(nullptr < r);
+}
+
+template <typename T, typename P>
+inline void swap(checked_local_ptr<T, P> &a, checked_local_ptr<T, P> &b) noexcept
+{
+    a.swap(b);
+}
+}  // namespace sia
+
+namespace std
+{
+template <typename _Tp, typename _Pp>
+struct hash<sia::checked_local_ptr<_Tp, _Pp>>
+{
+    size_t operator()(const sia::checked_local_ptr<_Tp, _Pp> &__s) const noexcept
+    {
+        return sia::detail::hashPointer(__s.get());
+    }
+};
+
+template <typename T, typename U, typename P>
+inline ::sia::checked_local_ptr<T, P> static_pointer_cast(const ::sia::checked_local_ptr<U, P> &__r) noexcept
+{
+    return ::sia::checked_local_ptr<T, P>(__r, static_cast<T *>(__r.get()));
+}
+
+template <typename T, typename U, typename P>
+inline ::sia::checked_local_ptr<T, P> dynamic_pointer_cast(const ::sia::checked_local_ptr<U, P> &__r) noexcept
+{
+    if (auto *ptr = dynamic_cast<T *>(__r.get()))
+        return ::sia::checked_local_ptr<T, P>(__r, ptr);
+    return nullptr;
+}
+
+template <typename T, typename U, typename P>
+inline ::sia::checked_local_ptr<T, P> const_pointer_cast(const ::sia::checked_local_ptr<U, P> &__r) noexcept
+{
+    return ::sia::checked_local_ptr<T, P>(__r, const_cast<T *>(__r.get()));
+}
+
+template <typename T, typename U, typename P>
+inline ::sia::checked_local_ptr<T, P> reinterpret_pointer_cast(const ::sia::checked_local_ptr<U, P> &__r) noexcept
+{
+    return ::sia::checked_local_ptr<T, P>(__r, reinterpret_cast<T *>(__r.get()));
+}
+}  // namespace std
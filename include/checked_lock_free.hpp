@@ -0,0 +1,276 @@
+#pragma once
+
+#include "checked_shared_ptr.hpp"
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <utility>
+
+namespace sia
+{
+
+// Bounded lock-free multi-producer multi-consumer FIFO of checked_shared_ptr, after Dmitry Vyukov's array queue.
+//
+// Every cell carries a sequence number which tells producers and consumers whose turn it is: a producer claims the
+// cell at position p when its sequence is p, a consumer when it is p + 1. Positions only ever grow, so a stale
+// sequence can never be mistaken for a current one and there is no ABA problem. The cells are allocated up front and
+// never freed while the queue lives, so there is nothing to reclaim either.
+//
+// The pointers are moved in and out of the cells, ownership is handed over without touching the reference count.
+//
+template <typename T, typename CheckPolicy = SIA_CSP_DEFAULT_CHECK_POLICY>
+class checked_mpmc_queue //NOLINT(readability-identifier-naming)
+{
+    using Value = checked_shared_ptr<T, CheckPolicy>;
+
+    struct Cell
+    {
+        std::atomic<std::size_t> m_sequence;
+        alignas(Value) std::byte m_storage[sizeof(Value)]; //NOLINT(modernize-avoid-c-arrays)
+    };
+
+    static constexpr std::size_t kCacheLine = 64;
+
+    public:
+    // The capacity is rounded up to a power of two, at least 2.
+    //
+    explicit checked_mpmc_queue(std::size_t capacity) : m_mask(roundUp(capacity) - 1)
+    {
+        m_cells = std::make_unique<Cell[]>(m_mask + 1); //NOLINT(modernize-avoid-c-arrays)
+        for (std::size_t i = 0; i <= m_mask; ++i)
+            m_cells[i].m_sequence.store(i, std::memory_order_relaxed);
+    }
+
+    checked_mpmc_queue(const checked_mpmc_queue &) = delete;
+    checked_mpmc_queue &operator=(const checked_mpmc_queue &) = delete;
+
+    ~checked_mpmc_queue()
+    {
+        Value value{};
+        while (tryPop(value))
+            value = nullptr;
+    }
+
+    [[nodiscard]] std::size_t capacity() const noexcept
+    {
+        return m_mask + 1;
+    }
+
+    // Moves value in unless the queue is full, value is left untouched then.
+    //
+    bool tryPush(Value &&value) noexcept
+    {
+        std::size_t position = m_push_position.load(std::memory_order_relaxed);
+
+        for (;;)
+        {
+            Cell &cell = m_cells[position & m_mask];
+            const std::size_t sequence = cell.m_sequence.load(std::memory_order_acquire);
+            const auto lag = static_cast<std::ptrdiff_t>(sequence - position);
+
+            if (lag == 0)
+            {
+                if (m_push_position.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                {
+                    ::new (static_cast<void *>(cell.m_storage)) Value(std::move(value));
+                    cell.m_sequence.store(position + 1, std::memory_order_release);
+                    return true;
+                }
+            }
+            else if (lag < 0)
+            {
+                return false;
+            }
+            else
+            {
+                position = m_push_position.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // Moves the oldest pointer out into value unless the queue is empty.
+    //
+    bool tryPop(Value &value) noexcept
+    {
+        std::size_t position = m_pop_position.load(std::memory_order_relaxed);
+
+        for (;;)
+        {
+            Cell &cell = m_cells[position & m_mask];
+            const std::size_t sequence = cell.m_sequence.load(std::memory_order_acquire);
+            const auto lag = static_cast<std::ptrdiff_t>(sequence - (position + 1));
+
+            if (lag == 0)
+            {
+                if (m_pop_position.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                {
+                    auto *stored = std::launder(reinterpret_cast<Value *>(cell.m_storage));
+                    value = std::move(*stored);
+                    stored->~Value();
+                    cell.m_sequence.store(position + m_mask + 1, std::memory_order_release);
+                    return true;
+                }
+            }
+            else if (lag < 0)
+            {
+                return false;
+            }
+            else
+            {
+                position = m_pop_position.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    private:
+    static std::size_t roundUp(std::size_t capacity) noexcept
+    {
+        std::size_t result = 2;
+        while (result < capacity)
+            result *= 2;
+
+        return result;
+    }
+
+    std::unique_ptr<Cell[]> m_cells; //NOLINT(modernize-avoid-c-arrays)
+    const std::size_t m_mask;
+    alignas(kCacheLine) std::atomic<std::size_t> m_push_position{0};
+    alignas(kCacheLine) std::atomic<std::size_t> m_pop_position{0};
+};
+
+// Unbounded lock-free LIFO of checked_shared_ptr, a Treiber stack with split reference counting.
+//
+// The head is a single 64-bit word: the address of the top node and a count of threads which are about to pop it.
+// A popper first bumps that count, which keeps the node alive, then swings the head to the next node. The winner
+// moves the pointer out and hands the count of the other threads over to the node's internal count, and whoever
+// brings the node to zero deletes it. Since a counted node cannot be freed, its address cannot be reused while
+// anyone compares against it, which rules out ABA. The same limits as for atomic_checked_shared_ptr apply: node
+// addresses must fit into 48 bits and at most 65535 pops may race on the same node.
+//
+// Like the queue, the pointers are moved in and out without touching their reference count.
+//
+template <typename T, typename CheckPolicy = SIA_CSP_DEFAULT_CHECK_POLICY>
+class checked_lock_free_stack //NOLINT(readability-identifier-naming)
+{
+    using Value = checked_shared_ptr<T, CheckPolicy>;
+    using Word = std::uint64_t;
+
+    static_assert(sizeof(void *) == sizeof(Word), "checked_lock_free_stack requires 64-bit pointers");
+
+    static constexpr int kCountShift = 48;
+    static constexpr Word kOneRef = Word{1} << kCountShift;
+    static constexpr Word kPtrMask = kOneRef - 1;
+
+    struct Node
+    {
+        explicit Node(Value &&value) noexcept : m_value(std::move(value))
+        {
+        }
+
+        Value m_value;
+        Word m_next{0};
+        std::atomic<std::int64_t> m_internal_count{0};
+    };
+
+    public:
+    static constexpr bool is_always_lock_free = std::atomic<Word>::is_always_lock_free; //NOLINT(readability-identifier-naming)
+
+    constexpr checked_lock_free_stack() noexcept = default;
+
+    checked_lock_free_stack(const checked_lock_free_stack &) = delete;
+    checked_lock_free_stack &operator=(const checked_lock_free_stack &) = delete;
+
+    ~checked_lock_free_stack()
+    {
+        Node *node = ptrOf(m_head.load());
+        while (node != nullptr)
+        {
+            Node *next = ptrOf(node->m_next);
+            delete node;
+            node = next;
+        }
+    }
+
+    void push(Value &&value)
+    {
+        auto *node = new Node(std::move(value));
+        const Word word = pack(node);
+
+        node->m_next = m_head.load(std::memory_order_relaxed);
+        while (!m_head.compare_exchange_weak(node->m_next, word, std::memory_order_release, std::memory_order_relaxed))
+        {
+        }
+    }
+
+    // Moves the top pointer out into value unless the stack is empty.
+    //
+    bool tryPop(Value &value) noexcept
+    {
+        Word head = m_head.load(std::memory_order_relaxed);
+
+        for (;;)
+        {
+            // Take a reference on the current top, it keeps the node alive while we look at it.
+            //
+            Word counted = 0;
+            do
+            {
+                if (ptrOf(head) == nullptr)
+                    return false;
+
+                counted = head + kOneRef;
+            } while (!m_head.compare_exchange_weak(head, counted, std::memory_order_acquire, std::memory_order_relaxed));
+
+            Node *node = ptrOf(counted);
+
+            if (m_head.compare_exchange_strong(counted, node->m_next, std::memory_order_acquire,
+                                               std::memory_order_relaxed))
+            {
+                value = std::move(node->m_value);
+
+                const std::int64_t others = countOf(counted) - 1;
+                if (node->m_internal_count.fetch_add(others, std::memory_order_acq_rel) == -others)
+                    delete node;
+
+                return true;
+            }
+
+            // Somebody else changed the top, give our reference back and retry from what we have seen.
+            //
+            if (node->m_internal_count.fetch_sub(1, std::memory_order_acq_rel) == 1)
+                delete node;
+
+            head = counted;
+        }
+    }
+
+    [[nodiscard]] bool empty() const noexcept
+    {
+        return ptrOf(m_head.load(std::memory_order_relaxed)) == nullptr;
+    }
+
+    private:
+    static Word pack(Node *node) noexcept
+    {
+        auto word = static_cast<Word>(reinterpret_cast<std::uintptr_t>(node));
+        assert((word & ~kPtrMask) == 0 && "node address does not fit into 48 bits");
+        return word;
+    }
+
+    static Node *ptrOf(Word word) noexcept
+    {
+        return reinterpret_cast<Node *>(static_cast<std::uintptr_t>(word & kPtrMask));
+    }
+
+    static std::int64_t countOf(Word word) noexcept
+    {
+        return static_cast<std::int64_t>(word >> kCountShift);
+    }
+
+    std::atomic<Word> m_head{0};
+};
+
+}  // namespace sia
@@ -0,0 +1,392 @@
+#pragma once
+
+#include "checked_shared_ptr.hpp"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <ostream>
+#include <vector>
+
+#if __has_include(<execinfo.h>)
+#include <execinfo.h>
+#define SIA_CSP_HAS_BACKTRACE 1
+#else
+#define SIA_CSP_HAS_BACKTRACE 0
+#endif
+
+namespace sia
+{
+
+// Counters of a single call site which dereferenced a null pointer. Sites reached through getChecked() carry the
+// file, line and function of the caller. Sites reached through operator-> or operator* only carry m_address, the
+// return address of the cold handler, which points right behind the failed check. Resolve it with addr2line.
+//
+// Code addresses are only as distinct as the optimizer leaves them. From -O2 on, GCC folds identical functions
+// (-fipa-icf) and shares the identical failure paths of one function (-fcrossjumping), so the checks in such code
+// end up as a single site. getChecked() is keyed by its source location, which cannot be folded, use it wherever
+// exact per-site counts matter, or build with -fno-ipa-icf -fno-crossjumping.
+//
+struct null_site_stats //NOLINT(readability-identifier-naming)
+{
+    const char *m_file{nullptr};
+    std::uint32_t m_line{0};
+    const char *m_function{nullptr};
+    const void *m_address{nullptr};
+    std::uint64_t m_hits{0};
+};
+
+struct null_backtrace_sample //NOLINT(readability-identifier-naming)
+{
+    null_site_stats m_site{};
+    std::int64_t m_timestamp_ns{0};
+    std::vector<void *> m_frames{};
+};
+
+struct null_telemetry_snapshot //NOLINT(readability-identifier-naming)
+{
+    // Sorted by hits, the hottest site first.
+    //
+    std::vector<null_site_stats> m_sites{};
+
+    // Oldest first.
+    //
+    std::vector<null_backtrace_sample> m_samples{};
+
+    // Hits which were not counted because every site slot was taken.
+    //
+    std::uint64_t m_dropped_hits{0};
+};
+
+// Process wide registry of null dereferences. Recording is lock-free: sites live in a fixed size open addressing
+// table and are counted with a single fetch_add, backtraces are written into a ring buffer guarded by a sequence
+// number per entry. A backtrace is captured on the first hit of a site and afterwards at most once per sample
+// interval and site. Nothing here is on the fast path, it only runs after a check failed.
+//
+class null_telemetry //NOLINT(readability-identifier-naming)
+{
+    public:
+    static constexpr std::size_t kMaxSites = 1024;
+    static constexpr std::size_t kMaxSamples = 64;
+    static constexpr std::size_t kMaxFrames = 32;
+
+    null_telemetry() = delete;
+
+    static void record(const char *file, std::uint32_t line, const char *function, const void *address) noexcept
+    {
+        State &state = instance();
+        Site *site = findOrInsert(state, file, line, function, address);
+
+        if (site == nullptr)
+        {
+            state.m_dropped_hits.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+
+        site->m_hits.fetch_add(1, std::memory_order_relaxed);
+
+        if (shouldSample(state, *site))
+            sample(state, *site);
+    }
+
+    [[nodiscard]] static null_telemetry_snapshot snapshot()
+    {
+        State &state = instance();
+        null_telemetry_snapshot result{};
+
+        for (const Site &site : state.m_sites)
+        {
+            if (site.m_state.load(std::memory_order_acquire) == kReady)
+                result.m_sites.push_back(statsOf(site));
+        }
+
+        std::sort(result.m_sites.begin(), result.m_sites.end(),
+                  [](const null_site_stats &lhs, const null_site_stats &rhs) { return lhs.m_hits > rhs.m_hits; });
+
+        const std::uint64_t end = state.m_next_sample.load(std::memory_order_acquire);
+        const std::uint64_t begin = end > kMaxSamples ? end - kMaxSamples : 0;
+
+        for (std::uint64_t i = begin; i < end; ++i)
+        {
+            null_backtrace_sample copy{};
+            if (readSample(state.m_samples[i % kMaxSamples], copy))
+                result.m_samples.push_back(std::move(copy));
+        }
+
+        result.m_dropped_hits = state.m_dropped_hits.load(std::memory_order_relaxed);
+        return result;
+    }
+
+    // Writes a human readable report, the hottest site first.
+    //
+    static void dump(std::ostream &os)
+    {
+        const null_telemetry_snapshot snap = snapshot();
+
+        os << "null dereferences: " << snap.m_sites.size() << " sites, " << snap.m_dropped_hits << " dropped hits\n";
+
+        for (const null_site_stats &site : snap.m_sites)
+        {
+            os << "  " << site.m_hits << " hits at ";
+            writeSite(os, site);
+            os << '\n';
+        }
+
+        for (const null_backtrace_sample &sample : snap.m_samples)
+        {
+            os << "backtrace at ";
+            writeSite(os, sample.m_site);
+            os << '\n';
+
+#if SIA_CSP_HAS_BACKTRACE
+            char **symbols = ::backtrace_symbols(sample.m_frames.data(), static_cast<int>(sample.m_frames.size()));
+#endif
+            for (std::size_t i = 0; i < sample.m_frames.size(); ++i)
+            {
+                os << "  #" << i << ' ' << sample.m_frames[i];
+#if SIA_CSP_HAS_BACKTRACE
+                if (symbols != nullptr)
+                    os << ' ' << symbols[i];
+#endif
+                os << '\n';
+            }
+#if SIA_CSP_HAS_BACKTRACE
+            std::free(symbols);  //NOLINT(cppcoreguidelines-no-malloc)
+#endif
+        }
+    }
+
+    // Minimum time between two backtraces of the same site. Zero samples every hit.
+    //
+    static void setSampleInterval(std::chrono::nanoseconds interval) noexcept
+    {
+        instance().m_sample_interval_ns.store(interval.count(), std::memory_order_relaxed);
+    }
+
+    // Forgets all sites and samples. Must not run concurrently with record().
+    //
+    static void reset() noexcept
+    {
+        State &state = instance();
+
+        for (Site &site : state.m_sites)
+        {
+            site.m_hits.store(0, std::memory_order_relaxed);
+            site.m_last_sample_ns.store(kNeverSampled, std::memory_order_relaxed);
+            site.m_state.store(kEmpty, std::memory_order_release);
+        }
+
+        for (Sample &sample : state.m_samples)
+            sample.m_seq.store(0, std::memory_order_release);
+
+        state.m_next_sample.store(0, std::memory_order_release);
+        state.m_dropped_hits.store(0, std::memory_order_relaxed);
+    }
+
+    private:
+    static constexpr std::uint32_t kEmpty = 0;
+    static constexpr std::uint32_t kClaimed = 1;
+    static constexpr std::uint32_t kReady = 2;
+    static constexpr std::int64_t kNeverSampled = std::numeric_limits<std::int64_t>::min();
+
+    struct Site
+    {
+        std::atomic<std::uint32_t> m_state{kEmpty};
+        const char *m_file{nullptr};
+        std::uint32_t m_line{0};
+        const char *m_function{nullptr};
+        const void *m_address{nullptr};
+        std::atomic<std::uint64_t> m_hits{0};
+        std::atomic<std::int64_t> m_last_sample_ns{kNeverSampled};
+    };
+
+    // Even m_seq means stable, odd means a writer is in the middle of it. Fields are atomics so that a torn read is
+    // merely discarded and not a data race.
+    //
+    struct Sample
+    {
+        std::atomic<std::uint64_t> m_seq{0};
+        std::atomic<const Site *> m_site{nullptr};
+        std::atomic<std::int64_t> m_timestamp_ns{0};
+        std::atomic<std::size_t> m_depth{0};
+        std::array<std::atomic<void *>, kMaxFrames> m_frames{};
+    };
+
+    struct State
+    {
+        std::array<Site, kMaxSites> m_sites{};
+        std::array<Sample, kMaxSamples> m_samples{};
+        std::atomic<std::uint64_t> m_next_sample{0};
+        std::atomic<std::uint64_t> m_dropped_hits{0};
+        std::atomic<std::int64_t> m_sample_interval_ns{std::chrono::nanoseconds(std::chrono::seconds(1)).count()};
+    };
+
+    static State &instance() noexcept
+    {
+        static State state{};
+        return state;
+    }
+
+    static std::int64_t nowNs() noexcept
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                   std::chrono::steady_clock::now().time_since_epoch())
+            .count();
+    }
+
+    static bool sameSite(const Site &site, const char *file, std::uint32_t line, const char *function,
+                         const void *address) noexcept
+    {
+        return site.m_file == file && site.m_line == line && site.m_function == function && site.m_address == address;
+    }
+
+    static Site *findOrInsert(State &state, const char *file, std::uint32_t line, const char *function,
+                              const void *address) noexcept
+    {
+        std::size_t hash = std::hash<const void *>()(file) ^ (std::hash<const void *>()(address) * 31U) ^ line;
+        hash ^= hash >> 17U;
+
+        for (std::size_t probe = 0; probe < kMaxSites; ++probe)
+        {
+            Site &site = state.m_sites[(hash + probe) % kMaxSites];
+            std::uint32_t current = site.m_state.load(std::memory_order_acquire);
+
+            if (current == kEmpty &&
+                site.m_state.compare_exchange_strong(current, kClaimed, std::memory_order_acquire))
+            {
+                site.m_file = file;
+                site.m_line = line;
+                site.m_function = function;
+                site.m_address = address;
+                site.m_state.store(kReady, std::memory_order_release);
+                return &site;
+            }
+
+            // Another thread is filling the slot in, it may turn out to be our site.
+            //
+            while (current == kClaimed)
+                current = site.m_state.load(std::memory_order_acquire);
+
+            if (sameSite(site, file, line, function, address))
+                return &site;
+        }
+
+        return nullptr;
+    }
+
+    static bool shouldSample(State &state, Site &site) noexcept
+    {
+        const std::int64_t now = nowNs();
+        std::int64_t last = site.m_last_sample_ns.load(std::memory_order_relaxed);
+
+        if (last != kNeverSampled && now - last < state.m_sample_interval_ns.load(std::memory_order_relaxed))
+            return false;
+
+        return site.m_last_sample_ns.compare_exchange_strong(last, now, std::memory_order_relaxed);
+    }
+
+    static void sample(State &state, const Site &site) noexcept
+    {
+        std::array<void *, kMaxFrames> frames{};
+        std::size_t depth = 0;
+#if SIA_CSP_HAS_BACKTRACE
+        depth = static_cast<std::size_t>(::backtrace(frames.data(), static_cast<int>(kMaxFrames)));
+#endif
+
+        const std::uint64_t index = state.m_next_sample.fetch_add(1, std::memory_order_acq_rel);
+        Sample &slot = state.m_samples[index % kMaxSamples];
+
+        std::uint64_t seq = slot.m_seq.load(std::memory_order_relaxed);
+        if ((seq & 1U) != 0 || !slot.m_seq.compare_exchange_strong(seq, seq + 1, std::memory_order_acquire))
+        {
+            // A writer which wrapped around the whole ring is still busy with this slot, rather lose the sample.
+            //
+            return;
+        }
+        std::atomic_thread_fence(std::memory_order_release);
+
+        slot.m_site.store(&site, std::memory_order_relaxed);
+        slot.m_timestamp_ns.store(site.m_last_sample_ns.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        slot.m_depth.store(depth, std::memory_order_relaxed);
+
+        for (std::size_t i = 0; i < depth; ++i)
+            slot.m_frames[i].store(frames[i], std::memory_order_relaxed);
+
+        slot.m_seq.store(seq + 2, std::memory_order_release);
+    }
+
+    static bool readSample(const Sample &slot, null_backtrace_sample &out)
+    {
+        const std::uint64_t before = slot.m_seq.load(std::memory_order_acquire);
+        if (before == 0 || (before & 1U) != 0)
+            return false;
+
+        const Site *site = slot.m_site.load(std::memory_order_relaxed);
+        out.m_timestamp_ns = slot.m_timestamp_ns.load(std::memory_order_relaxed);
+        const std::size_t depth = std::min(slot.m_depth.load(std::memory_order_relaxed), kMaxFrames);
+
+        out.m_frames.resize(depth);
+        for (std::size_t i = 0; i < depth; ++i)
+            out.m_frames[i] = slot.m_frames[i].load(std::memory_order_relaxed);
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (site == nullptr || slot.m_seq.load(std::memory_order_relaxed) != before)
+            return false;
+
+        out.m_site = statsOf(*site);
+        return true;
+    }
+
+    static null_site_stats statsOf(const Site &site) noexcept
+    {
+        return null_site_stats{site.m_file, site.m_line, site.m_function, site.m_address,
+                               site.m_hits.load(std::memory_order_relaxed)};
+    }
+
+    static void writeSite(std::ostream &os, const null_site_stats &site)
+    {
+        if (site.m_file != nullptr && site.m_file[0] != '\0')
+            os << site.m_file << ':' << site.m_line << " in " << site.m_function;
+        else
+            os << site.m_address;
+    }
+};
+
+template <typename Inner>
+struct record_on_null //NOLINT(readability-identifier-naming)
+{
+    static constexpr bool is_checked = true;
+    static constexpr bool is_noexcept = Inner::is_noexcept;
+
+    // Keyed by the code address of the failed check, see null_site_stats for when sites get folded together.
+    //
+    [[noreturn]] SIA_CSP_COLD static void onNullPtr() noexcept(is_noexcept)
+    {
+#if defined(__GNUC__) || defined(__clang__)
+        null_telemetry::record(nullptr, 0, nullptr, __builtin_return_address(0));
+#else
+        null_telemetry::record(nullptr, 0, nullptr, nullptr);
+#endif
+        Inner::onNullPtr();
+    }
+
+    [[noreturn]] SIA_CSP_COLD static void onNullPtrAt(const char *file, std::uint32_t line,
+                                                      const char *function) noexcept(is_noexcept)
+    {
+        null_telemetry::record(file, line, function, nullptr);
+        Inner::onNullPtr();
+    }
+
+    // Not a null dereference, nothing to record.
+    //
+    [[noreturn]] SIA_CSP_COLD static void onOutOfRange() noexcept(is_noexcept)
+    {
+        detail::outOfRange<Inner>();
+    }
+};
+
+}  // namespace sia
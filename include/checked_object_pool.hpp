@@ -0,0 +1,422 @@
+#pragma once
+
+#include "checked_shared_ptr.hpp"
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+#include <new>
+#include <utility>
+
+namespace sia
+{
+
+struct object_pool_stats //NOLINT(readability-identifier-naming)
+{
+    // Slots taken from and given back to operator new / operator delete.
+    //
+    std::size_t m_system_allocations{0};
+    std::size_t m_system_frees{0};
+
+    // Batches of slots moved between the thread caches and the shared depot.
+    //
+    std::size_t m_depot_refills{0};
+    std::size_t m_depot_spills{0};
+
+    // Free slots currently held by the depot.
+    //
+    std::size_t m_depot_slots{0};
+};
+
+// Recycles the slots, control block and object in one, of pooled_checked_shared<T>. Every thread keeps a free list
+// of its own, so that an allocation and a release on the same thread touch no shared state. A slot goes back to the
+// cache of the thread which releases the last reference. Caches which grow over setThreadCap() spill half of their
+// slots to a shared depot under a mutex, and empty caches refill from there. This is what moves the slots from a
+// consumer thread back to a producer. The depot itself holds up to setDepotCap() slots, the rest go back to the
+// system.
+//
+// All allocations for T have the same size, it is taken from the first one just like fixed_block_resource does.
+//
+template <typename T>
+class object_pool //NOLINT(readability-identifier-naming)
+{
+    public:
+    static constexpr std::size_t kDefaultThreadCap = 256;
+    static constexpr std::size_t kDefaultDepotCap = 16384;
+
+    object_pool() = delete;
+
+    // Number of free slots a thread may keep before it spills to the depot, at least 2.
+    //
+    static void setThreadCap(std::size_t slots) noexcept
+    {
+        instance().m_thread_cap.store(slots < 2 ? 2 : slots, std::memory_order_relaxed);
+    }
+
+    static void setDepotCap(std::size_t slots) noexcept
+    {
+        instance().m_depot_cap.store(slots, std::memory_order_relaxed);
+    }
+
+    [[nodiscard]] static std::size_t threadCap() noexcept
+    {
+        return instance().m_thread_cap.load(std::memory_order_relaxed);
+    }
+
+    [[nodiscard]] static std::size_t depotCap() noexcept
+    {
+        return instance().m_depot_cap.load(std::memory_order_relaxed);
+    }
+
+    // Zero until the first allocation.
+    //
+    [[nodiscard]] static std::size_t slotSize() noexcept
+    {
+        return instance().m_slot_size.load(std::memory_order_acquire);
+    }
+
+    [[nodiscard]] static object_pool_stats stats()
+    {
+        State &state = instance();
+        object_pool_stats result{};
+        result.m_system_allocations = state.m_system_allocations.load(std::memory_order_relaxed);
+        result.m_system_frees = state.m_system_frees.load(std::memory_order_relaxed);
+        result.m_depot_refills = state.m_depot_refills.load(std::memory_order_relaxed);
+        result.m_depot_spills = state.m_depot_spills.load(std::memory_order_relaxed);
+
+        std::lock_guard<std::mutex> lock{state.m_lock};
+        result.m_depot_slots = state.m_depot_count;
+        return result;
+    }
+
+    // Returns the free slots of the calling thread and of the depot to the system.
+    //
+    static void trim() noexcept
+    {
+        if (Cache *cache = threadCache())
+        {
+            freeList(cache->m_head);
+            cache->m_head = nullptr;
+            cache->m_count = 0;
+        }
+
+        State &state = instance();
+        FreeSlot *depot = nullptr;
+        {
+            std::lock_guard<std::mutex> lock{state.m_lock};
+            depot = std::exchange(state.m_depot, nullptr);
+            state.m_depot_count = 0;
+        }
+
+        freeList(depot);
+    }
+
+    // Used by detail::pool_allocator.
+    //
+    [[nodiscard]] static void *allocate(std::size_t bytes, std::size_t alignment)
+    {
+        if (!isSlot(bytes, alignment))
+            return systemAllocate(bytes, alignment);
+
+        Cache *cache = threadCache();
+
+        if (cache != nullptr && (cache->m_head != nullptr || refill(*cache)))
+        {
+            FreeSlot *slot = cache->m_head;
+            cache->m_head = slot->m_next;
+            --cache->m_count;
+            return slot;
+        }
+
+        State &state = instance();
+        state.m_system_allocations.fetch_add(1, std::memory_order_relaxed);
+        return systemAllocate(bytes, state.m_slot_alignment.load(std::memory_order_relaxed));
+    }
+
+    static void deallocate(void *ptr, std::size_t bytes, std::size_t alignment) noexcept
+    {
+        if (!isSlot(bytes, alignment))
+        {
+            systemFree(ptr, bytes, alignment);
+            return;
+        }
+
+        auto *slot = ::new (ptr) FreeSlot{nullptr};
+        Cache *cache = threadCache();
+
+        // Released by a static or thread_local destructor after the cache of this thread is gone.
+        //
+        if (cache == nullptr)
+        {
+            slot->m_next = nullptr;
+            spill(slot, slot, 1);
+            return;
+        }
+
+        slot->m_next = cache->m_head;
+        cache->m_head = slot;
+
+        if (++cache->m_count > threadCap())
+            spillHalf(*cache);
+    }
+
+    private:
+    struct FreeSlot
+    {
+        FreeSlot *m_next;
+    };
+
+    struct State
+    {
+        std::atomic<std::size_t> m_slot_size{0};
+        std::atomic<std::size_t> m_slot_alignment{0};
+        std::atomic<std::size_t> m_thread_cap{kDefaultThreadCap};
+        std::atomic<std::size_t> m_depot_cap{kDefaultDepotCap};
+
+        std::atomic<std::size_t> m_system_allocations{0};
+        std::atomic<std::size_t> m_system_frees{0};
+        std::atomic<std::size_t> m_depot_refills{0};
+        std::atomic<std::size_t> m_depot_spills{0};
+
+        std::mutex m_lock{};
+        FreeSlot *m_depot{nullptr};
+        std::size_t m_depot_count{0};
+    };
+
+    // Hands the free slots of an exiting thread to the depot.
+    //
+    struct Cache
+    {
+        Cache() = default;
+        Cache(const Cache &) = delete;
+        Cache &operator=(const Cache &) = delete;
+
+        ~Cache()
+        {
+            if (m_head != nullptr)
+            {
+                FreeSlot *tail = m_head;
+                while (tail->m_next != nullptr)
+                    tail = tail->m_next;
+
+                spill(m_head, tail, m_count);
+            }
+
+            threadGone() = true;
+        }
+
+        FreeSlot *m_head{nullptr};
+        std::size_t m_count{0};
+    };
+
+    // Never destroyed, slots may still be released while static objects are destroyed.
+    //
+    static State &instance() noexcept
+    {
+        static State *state = new State();  //NOLINT(cppcoreguidelines-owning-memory)
+        return *state;
+    }
+
+    static bool &threadGone() noexcept
+    {
+        thread_local bool gone = false;
+        return gone;
+    }
+
+    static Cache *threadCache() noexcept
+    {
+        if (threadGone())
+            return nullptr;
+
+        thread_local Cache cache{};
+        return &cache;
+    }
+
+    static bool isSlot(std::size_t bytes, std::size_t alignment) noexcept
+    {
+        State &state = instance();
+        std::size_t size = state.m_slot_size.load(std::memory_order_acquire);
+
+        if (SIA_CSP_UNLIKELY(size == 0))
+        {
+            std::size_t expected = 0;
+            const std::size_t slot_alignment = alignment < alignof(FreeSlot) ? alignof(FreeSlot) : alignment;
+            state.m_slot_alignment.store(slot_alignment, std::memory_order_relaxed);
+            state.m_slot_size.compare_exchange_strong(expected, bytes < sizeof(FreeSlot) ? sizeof(FreeSlot) : bytes,
+                                                      std::memory_order_acq_rel);
+            size = state.m_slot_size.load(std::memory_order_acquire);
+        }
+
+        return bytes == size && alignment <= state.m_slot_alignment.load(std::memory_order_relaxed);
+    }
+
+    static void *systemAllocate(std::size_t bytes, std::size_t alignment)
+    {
+        if (alignment > __STDCPP_DEFAULT_NEW_ALIGNMENT__)
+            return ::operator new(bytes, std::align_val_t(alignment));
+
+        return ::operator new(bytes);
+    }
+
+    static void systemFree(void *ptr, std::size_t bytes, std::size_t alignment) noexcept
+    {
+        if (alignment > __STDCPP_DEFAULT_NEW_ALIGNMENT__)
+            ::operator delete(ptr, bytes, std::align_val_t(alignment));
+        else
+            ::operator delete(ptr, bytes);
+    }
+
+    static void freeList(FreeSlot *slot) noexcept
+    {
+        State &state = instance();
+        const std::size_t size = state.m_slot_size.load(std::memory_order_relaxed);
+        const std::size_t alignment = state.m_slot_alignment.load(std::memory_order_relaxed);
+
+        while (slot != nullptr)
+        {
+            FreeSlot *next = slot->m_next;
+            systemFree(slot, size, alignment);
+            state.m_system_frees.fetch_add(1, std::memory_order_relaxed);
+            slot = next;
+        }
+    }
+
+    // Takes up to half a thread cap of slots from the depot.
+    //
+    static bool refill(Cache &cache) noexcept
+    {
+        State &state = instance();
+        const std::size_t batch = threadCap() / 2;
+
+        std::lock_guard<std::mutex> lock{state.m_lock};
+
+        if (state.m_depot == nullptr)
+            return false;
+
+        FreeSlot *first = state.m_depot;
+        FreeSlot *last = first;
+        std::size_t count = 1;
+
+        while (count < batch && last->m_next != nullptr)
+        {
+            last = last->m_next;
+            ++count;
+        }
+
+        state.m_depot = last->m_next;
+        state.m_depot_count -= count;
+        last->m_next = nullptr;
+
+        cache.m_head = first;
+        cache.m_count = count;
+        state.m_depot_refills.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    static void spillHalf(Cache &cache) noexcept
+    {
+        const std::size_t count = cache.m_count / 2;
+        FreeSlot *first = cache.m_head;
+        FreeSlot *last = first;
+
+        for (std::size_t i = 1; i < count; ++i)
+            last = last->m_next;
+
+        cache.m_head = last->m_next;
+        cache.m_count -= count;
+        last->m_next = nullptr;
+
+        spill(first, last, count);
+    }
+
+    // Moves the list first..last to the depot, whatever does not fit goes back to the system.
+    //
+    static void spill(FreeSlot *first, FreeSlot *last, std::size_t count) noexcept
+    {
+        State &state = instance();
+        const std::size_t cap = depotCap();
+
+        {
+            std::lock_guard<std::mutex> lock{state.m_lock};
+            state.m_depot_spills.fetch_add(1, std::memory_order_relaxed);
+
+            if (state.m_depot_count + count <= cap)
+            {
+                last->m_next = state.m_depot;
+                state.m_depot = first;
+                state.m_depot_count += count;
+                return;
+            }
+
+            for (; first != nullptr && state.m_depot_count < cap; ++state.m_depot_count)
+            {
+                FreeSlot *next = first->m_next;
+                first->m_next = state.m_depot;
+                state.m_depot = first;
+                first = next;
+            }
+        }
+
+        freeList(first);
+    }
+};
+
+namespace detail
+{
+
+// Stateless allocator for allocate_shared which takes its memory from object_pool<T>, whatever type it is rebound
+// to. Since allocate_shared allocates only the control block with the object in place, all allocations for one T
+// have the same size.
+//
+template <typename U, typename T>
+struct pool_allocator //NOLINT(readability-identifier-naming)
+{
+    using value_type = U;
+
+    template <typename V>
+    struct rebind
+    {
+        using other = pool_allocator<V, T>;
+    };
+
+    pool_allocator() noexcept = default;
+
+    template <typename V>
+    pool_allocator(const pool_allocator<V, T> & /*r*/) noexcept //NOLINT(google-explicit-constructor)
+    {
+    }
+
+    U *allocate(std::size_t n)
+    {
+        return static_cast<U *>(object_pool<T>::allocate(sizeof(U) * n, alignof(U)));
+    }
+
+    void deallocate(U *ptr, std::size_t n) noexcept
+    {
+        object_pool<T>::deallocate(ptr, sizeof(U) * n, alignof(U));
+    }
+
+    template <typename V>
+    bool operator==(const pool_allocator<V, T> & /*r*/) const noexcept
+    {
+        return true;
+    }
+
+    template <typename V>
+    bool operator!=(const pool_allocator<V, T> & /*r*/) const noexcept
+    {
+        return false;
+    }
+};
+
+}  // namespace detail
+
+// Same as make_checked_shared but the control block and the object come from object_pool<T>, which recycles them
+// once the last owner, strong or weak, is gone. The result is an ordinary checked_shared_ptr<T>.
+//
+template <typename T, typename... Args>
+sia::checked_shared_ptr<T> pooled_checked_shared(Args &&...args) //NOLINT(readability-identifier-naming)
+{
+    return std::allocate_shared<T>(detail::pool_allocator<T, T>{}, std::forward<Args>(args)...);
+}
+
+}  // namespace sia
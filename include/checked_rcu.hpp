@@ -0,0 +1,307 @@
+#pragma once
+
+#include "checked_shared_ptr.hpp"
+#include "checked_view.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace sia
+{
+
+// Process wide epoch based reclamation for rcu_checked_shared_ptr.
+//
+// Every thread which reads has a record holding the global epoch it entered its read-side critical section with, or
+// zero while it is outside. Retiring an object tags its owner with the current epoch and advances the global epoch.
+// The owner is dropped once no reader is left which entered at or before that epoch. Readers only ever write their
+// own record, there is no shared cache line they modify.
+//
+class rcu_domain //NOLINT(readability-identifier-naming)
+{
+    public:
+    rcu_domain() = delete;
+
+    // Keeps the owner alive until every reader which may still see the object has left its critical section.
+    //
+    static void retire(std::shared_ptr<const void> owner)
+    {
+        if (owner == nullptr)
+            return;
+
+        State &state = instance();
+        {
+            std::lock_guard<std::mutex> lock{state.m_lock};
+            state.m_retired.push_back(Retired{state.m_epoch.fetch_add(1), std::move(owner)});
+        }
+
+        reclaim();
+    }
+
+    // Drops the owners whose grace period is over without waiting, returns how many.
+    //
+    static std::size_t reclaim()
+    {
+        State &state = instance();
+        const std::uint64_t oldest_reader = oldestReaderEpoch(state);
+        std::vector<Retired> expired{};
+
+        {
+            std::lock_guard<std::mutex> lock{state.m_lock};
+            auto it = std::partition(state.m_retired.begin(), state.m_retired.end(),
+                                     [oldest_reader](const Retired &r) { return r.m_epoch >= oldest_reader; });
+
+            expired.assign(std::make_move_iterator(it), std::make_move_iterator(state.m_retired.end()));
+            state.m_retired.erase(it, state.m_retired.end());
+        }
+
+        // Destructors run without the lock, they may retire again.
+        //
+        return expired.size();
+    }
+
+    // Waits until everything retired so far is dropped. Must not be called inside a read-side critical section.
+    //
+    static void synchronize()
+    {
+        assert(threadRecord().m_nesting == 0 && "rcu_domain::synchronize() inside a read-side critical section");
+
+        State &state = instance();
+        const std::uint64_t target = state.m_epoch.fetch_add(1);
+
+        for (;;)
+        {
+            reclaim();
+
+            {
+                std::lock_guard<std::mutex> lock{state.m_lock};
+                const bool pending = std::any_of(state.m_retired.begin(), state.m_retired.end(),
+                                                 [target](const Retired &r) { return r.m_epoch < target; });
+                if (!pending)
+                    return;
+            }
+
+            std::this_thread::yield();
+        }
+    }
+
+    [[nodiscard]] static std::size_t retiredCount()
+    {
+        State &state = instance();
+        std::lock_guard<std::mutex> lock{state.m_lock};
+        return state.m_retired.size();
+    }
+
+    private:
+    friend class rcu_read_guard;
+
+    struct Record
+    {
+        std::atomic<std::uint64_t> m_epoch{0};
+        std::atomic<bool> m_in_use{true};
+        Record *m_next{nullptr};
+        std::uint32_t m_nesting{0};
+    };
+
+    struct Retired
+    {
+        std::uint64_t m_epoch;
+        std::shared_ptr<const void> m_owner;
+    };
+
+    struct State
+    {
+        std::atomic<std::uint64_t> m_epoch{1};
+        std::atomic<Record *> m_records{nullptr};
+        std::mutex m_lock{};
+        std::vector<Retired> m_retired{};
+    };
+
+    // Hands the record back for reuse when the thread exits.
+    //
+    struct ThreadRecord
+    {
+        ThreadRecord() : m_record(acquireRecord())
+        {
+        }
+
+        ThreadRecord(const ThreadRecord &) = delete;
+        ThreadRecord &operator=(const ThreadRecord &) = delete;
+
+        ~ThreadRecord()
+        {
+            m_record->m_epoch.store(0);
+            m_record->m_nesting = 0;
+            m_record->m_in_use.store(false, std::memory_order_release);
+        }
+
+        Record *m_record;
+    };
+
+    // Never destroyed, records are only recycled and late retirements at exit must still work.
+    //
+    static State &instance() noexcept
+    {
+        static State *state = new State();  //NOLINT(cppcoreguidelines-owning-memory)
+        return *state;
+    }
+
+    static Record &threadRecord()
+    {
+        thread_local ThreadRecord record{};
+        return *record.m_record;
+    }
+
+    static Record *acquireRecord()
+    {
+        State &state = instance();
+
+        for (Record *record = state.m_records.load(std::memory_order_acquire); record != nullptr;
+             record = record->m_next)
+        {
+            bool in_use = false;
+            if (!record->m_in_use.load(std::memory_order_relaxed) &&
+                record->m_in_use.compare_exchange_strong(in_use, true, std::memory_order_acquire))
+                return record;
+        }
+
+        auto *record = new Record();  //NOLINT(cppcoreguidelines-owning-memory)
+        record->m_next = state.m_records.load(std::memory_order_relaxed);
+        while (!state.m_records.compare_exchange_weak(record->m_next, record, std::memory_order_release,
+                                                      std::memory_order_relaxed))
+        {
+        }
+
+        return record;
+    }
+
+    static std::uint64_t oldestReaderEpoch(State &state) noexcept
+    {
+        std::uint64_t oldest = std::numeric_limits<std::uint64_t>::max();
+
+        for (Record *record = state.m_records.load(std::memory_order_acquire); record != nullptr;
+             record = record->m_next)
+        {
+            const std::uint64_t epoch = record->m_epoch.load();
+            if (epoch != 0)
+                oldest = std::min(oldest, epoch);
+        }
+
+        return oldest;
+    }
+
+    static void enter() noexcept
+    {
+        Record &record = threadRecord();
+
+        if (record.m_nesting++ == 0)
+            record.m_epoch.store(instance().m_epoch.load());
+    }
+
+    static void leave() noexcept
+    {
+        Record &record = threadRecord();
+
+        if (--record.m_nesting == 0)
+            record.m_epoch.store(0, std::memory_order_release);
+    }
+};
+
+// Read-side critical section. Objects read through rcu_checked_shared_ptr::read() stay alive until it ends. Guards
+// nest and are cheap to enter: one load of the global epoch and one store to a record of the calling thread.
+//
+class rcu_read_guard //NOLINT(readability-identifier-naming)
+{
+    public:
+    rcu_read_guard() noexcept
+    {
+        rcu_domain::enter();
+    }
+
+    rcu_read_guard(const rcu_read_guard &) = delete;
+    rcu_read_guard &operator=(const rcu_read_guard &) = delete;
+
+    ~rcu_read_guard()
+    {
+        rcu_domain::leave();
+    }
+};
+
+// Slot for read-mostly data. Readers inside an rcu_read_guard get a checked_view of the current object without
+// touching its reference count. Writers publish a replacement with store() and the previous object is kept alive by
+// rcu_domain until no reader can see it anymore. The objects are ordinary checked_shared_ptr owners, so the slot can
+// share them with the rest of the program.
+//
+template <typename T, typename CheckPolicy = SIA_CSP_DEFAULT_CHECK_POLICY>
+class rcu_checked_shared_ptr //NOLINT(readability-identifier-naming)
+{
+    using Value = checked_shared_ptr<T, CheckPolicy>;
+
+    public:
+    using element_type = typename Value::element_type;
+
+    rcu_checked_shared_ptr() noexcept = default;
+
+    explicit rcu_checked_shared_ptr(Value desired) noexcept : m_owner(std::move(desired))
+    {
+        m_published.store(m_owner.get());
+    }
+
+    rcu_checked_shared_ptr(const rcu_checked_shared_ptr &) = delete;
+    rcu_checked_shared_ptr &operator=(const rcu_checked_shared_ptr &) = delete;
+
+    // Readers may still look at the current object.
+    //
+    ~rcu_checked_shared_ptr()
+    {
+        rcu_domain::retire(std::move(m_owner.m_ptr));
+    }
+
+    // Null checked, non-owning access for the lifetime of guard.
+    //
+    checked_view<element_type, CheckPolicy> read(const rcu_read_guard & /*guard*/) const noexcept
+    {
+        return checked_view<element_type, CheckPolicy>(m_published.load());
+    }
+
+    // Copies the owner out, for readers which need the object beyond their critical section.
+    //
+    [[nodiscard]] Value load() const
+    {
+        std::lock_guard<std::mutex> lock{m_writer};
+        return m_owner;
+    }
+
+    void store(Value desired)
+    {
+        exchange(std::move(desired));
+    }
+
+    // Returns the previous owner, readers may still look at it for the rest of their critical section.
+    //
+    Value exchange(Value desired)
+    {
+        Value previous{};
+        {
+            std::lock_guard<std::mutex> lock{m_writer};
+            previous = std::exchange(m_owner, std::move(desired));
+            m_published.store(m_owner.get());
+        }
+
+        rcu_domain::retire(previous.m_ptr);
+        return previous;
+    }
+
+    private:
+    std::atomic<element_type *> m_published{nullptr};
+    mutable std::mutex m_writer{};
+    Value m_owner{};
+};
+
+}  // namespace sia
@@ -0,0 +1,570 @@
+#pragma once
+
+#include "checked_shared_ptr.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <exception>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Prints refcount_profiler::dump() to std::cerr when the process exits. It can also be switched at runtime with
+// refcount_profiler::setReportAtExit().
+//
+#ifndef SIA_CSP_PROFILE_REFCOUNT_REPORT_AT_EXIT
+#define SIA_CSP_PROFILE_REFCOUNT_REPORT_AT_EXIT 1
+#endif
+
+namespace sia
+{
+
+// Reference count traffic of a single managed object, which is identified by its control block and listed with the
+// address get() returns. Only objects which are still alive are listed, destroyed ones are folded into the stats of
+// their type.
+//
+struct refcount_object_stats //NOLINT(readability-identifier-naming)
+{
+    const void *m_object{nullptr};
+    std::string m_type{};
+    std::uint64_t m_copies{0};
+    std::uint64_t m_moves{0};
+    std::uint64_t m_releases{0};
+
+    // Number of threads which copied, moved or released a pointer to the object.
+    //
+    std::uint32_t m_threads{0};
+    bool m_contended{false};
+};
+
+// Reference count traffic of all objects of a type, the destroyed ones included.
+//
+struct refcount_type_stats //NOLINT(readability-identifier-naming)
+{
+    std::string m_type{};
+    std::uint64_t m_copies{0};
+    std::uint64_t m_moves{0};
+    std::uint64_t m_releases{0};
+    std::uint64_t m_objects{0};
+    std::uint64_t m_contended_objects{0};
+};
+
+struct refcount_report //NOLINT(readability-identifier-naming)
+{
+    // Contended objects first, then by the number of reference count modifications.
+    //
+    std::vector<refcount_object_stats> m_objects{};
+
+    // By the number of reference count modifications.
+    //
+    std::vector<refcount_type_stats> m_types{};
+
+    // Events which could not be counted because the profiler ran out of memory.
+    //
+    std::uint64_t m_dropped_events{0};
+};
+
+// Profiler behind SIA_CSP_PROFILE_REFCOUNT. Every thread counts into its own table, guarded by a mutex which only
+// the reporting thread ever contends for, so that profiling does not add cache line traffic of its own. The tables
+// are merged when a report is requested and when a thread exits. An object is flagged as contended when pointers to
+// it were copied, moved or released by at least setContentionThreshold() threads, which is where the control block
+// bounces between cores.
+//
+// An entry holds a weak reference to the control block of its object, so that a new object at a reused address always
+// gets an entry of its own, and so that a destroyed object is recognised however its last owner went away. Destroyed
+// objects are not looked for on release. They are collected by report(), and by the thread whose table has doubled
+// since the last collection. Only then are the tables locked together, the entries of the destroyed objects merged
+// and added to the totals of their type, with the contention threshold of that moment. Until then a destroyed
+// object keeps its control block allocated, which for make_shared() objects includes the storage of the object.
+//
+class refcount_profiler //NOLINT(readability-identifier-naming)
+{
+    public:
+    refcount_profiler() = delete;
+
+    template <typename T>
+    static void record(const std::shared_ptr<T> &ptr, const char *type, detail::refcount_event event) noexcept
+    {
+        const void *object = ptr.get();
+
+        if (object == nullptr)
+            return;
+
+        // Called from destructors and move operations, a failed allocation only costs the event.
+        //
+        try
+        {
+            ThreadTable *table = threadTable();
+
+            // Pointers released by static destructors after the thread table is gone are counted as a thread of
+            // their own.
+            //
+            if (table == nullptr)
+            {
+                State &state = instance();
+                std::lock_guard<std::mutex> lock{state.m_lock};
+                count(state.m_retired, object, ptr, type, event);
+                return;
+            }
+
+            bool full = false;
+            {
+                std::lock_guard<std::mutex> lock{table->m_lock};
+                count(*table, object, ptr, type, event);
+                full = table->m_objects.size() + table->m_destroyed.size() >= table->m_collect_at;
+            }
+
+            if (full)
+            {
+                State &state = instance();
+                std::lock_guard<std::mutex> lock{state.m_lock};
+                collect(state);
+            }
+        }
+        catch (const std::exception &)
+        {
+            instance().m_dropped_events.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    [[nodiscard]] static refcount_report report()
+    {
+        State &state = instance();
+        ObjectMap merged{};
+        std::unordered_map<const char *, refcount_type_stats> types{};
+
+        {
+            std::lock_guard<std::mutex> lock{state.m_lock};
+            collect(state);
+            types = state.m_destroyed;
+
+            merge(merged, state.m_retired.m_objects);
+            for (ThreadTable *table : state.m_tables)
+            {
+                std::lock_guard<std::mutex> table_lock{table->m_lock};
+                merge(merged, table->m_objects);
+            }
+        }
+
+        const std::uint32_t threshold = state.m_contention_threshold.load(std::memory_order_relaxed);
+        refcount_report result{};
+
+        for (const auto &[owner, counters] : merged)
+        {
+            refcount_object_stats stats{counters.m_object, typeName(counters.m_type), counters.m_copies,
+                                        counters.m_moves,  counters.m_releases,       counters.m_threads,
+                                        counters.m_threads >= threshold};
+
+            refcount_type_stats &type = types[counters.m_type];
+            type.m_copies += stats.m_copies;
+            type.m_moves += stats.m_moves;
+            type.m_releases += stats.m_releases;
+            type.m_objects += 1;
+            type.m_contended_objects += stats.m_contended ? 1 : 0;
+
+            result.m_objects.push_back(std::move(stats));
+        }
+
+        for (auto &[name, type] : types)
+        {
+            type.m_type = typeName(name);
+            result.m_types.push_back(std::move(type));
+        }
+
+        std::sort(result.m_objects.begin(), result.m_objects.end(),
+                  [](const refcount_object_stats &lhs, const refcount_object_stats &rhs)
+                  {
+                      if (lhs.m_contended != rhs.m_contended)
+                          return lhs.m_contended;
+                      if (lhs.m_threads != rhs.m_threads)
+                          return lhs.m_threads > rhs.m_threads;
+                      return lhs.m_copies + lhs.m_releases > rhs.m_copies + rhs.m_releases;
+                  });
+
+        std::sort(result.m_types.begin(), result.m_types.end(),
+                  [](const refcount_type_stats &lhs, const refcount_type_stats &rhs)
+                  { return lhs.m_copies + lhs.m_releases > rhs.m_copies + rhs.m_releases; });
+
+        result.m_dropped_events = state.m_dropped_events.load(std::memory_order_relaxed);
+        return result;
+    }
+
+    // Writes the top entries of report() in a human readable form.
+    //
+    static void dump(std::ostream &os, std::size_t top = 20)
+    {
+        const refcount_report rep = report();
+
+        os << "checked_shared_ptr refcount profile: " << rep.m_objects.size() << " objects, " << rep.m_types.size()
+           << " types\n";
+
+        if (rep.m_dropped_events != 0)
+            os << "dropped events: " << rep.m_dropped_events << '\n';
+
+        os << "types:\n";
+        for (std::size_t i = 0; i < std::min(top, rep.m_types.size()); ++i)
+        {
+            const refcount_type_stats &type = rep.m_types[i];
+            os << "  " << type.m_type << ": copies=" << type.m_copies << " moves=" << type.m_moves
+               << " releases=" << type.m_releases << " objects=" << type.m_objects
+               << " contended=" << type.m_contended_objects << '\n';
+        }
+
+        os << "objects:\n";
+        for (std::size_t i = 0; i < std::min(top, rep.m_objects.size()); ++i)
+        {
+            const refcount_object_stats &object = rep.m_objects[i];
+            os << "  " << object.m_object << ' ' << object.m_type << ": copies=" << object.m_copies
+               << " moves=" << object.m_moves << " releases=" << object.m_releases << " threads=" << object.m_threads
+               << (object.m_contended ? " CONTENDED" : "") << '\n';
+        }
+    }
+
+    // Forgets everything recorded so far.
+    //
+    static void reset()
+    {
+        State &state = instance();
+        std::lock_guard<std::mutex> lock{state.m_lock};
+        state.m_retired.clear();
+        state.m_destroyed.clear();
+        state.m_dropped_events.store(0, std::memory_order_relaxed);
+
+        for (ThreadTable *table : state.m_tables)
+        {
+            std::lock_guard<std::mutex> table_lock{table->m_lock};
+            table->clear();
+        }
+    }
+
+    static void setContentionThreshold(std::uint32_t threads) noexcept
+    {
+        instance().m_contention_threshold.store(std::max<std::uint32_t>(threads, 1), std::memory_order_relaxed);
+    }
+
+    static void setReportAtExit(bool enabled) noexcept
+    {
+        instance().m_report_at_exit.store(enabled, std::memory_order_relaxed);
+    }
+
+    private:
+    // A table is collected once it holds this many entries, or twice as many as after its last collection.
+    //
+    static constexpr std::size_t kMinCollectAt = 1024;
+
+    struct Counters
+    {
+        std::weak_ptr<const void> m_owner{};
+        const void *m_object{nullptr};
+        const char *m_type{nullptr};
+        std::uint64_t m_copies{0};
+        std::uint64_t m_moves{0};
+        std::uint64_t m_releases{0};
+        std::uint32_t m_threads{0};
+    };
+
+    using ObjectMap = std::map<std::weak_ptr<const void>, Counters, std::owner_less<>>;
+
+    struct ThreadTable
+    {
+        void clear() noexcept
+        {
+            m_objects.clear();
+            m_destroyed.clear();
+            m_collect_at = kMinCollectAt;
+        }
+
+        std::mutex m_lock{};
+        std::unordered_map<const void *, Counters> m_objects{};
+
+        // Entries which were found destroyed when a new object showed up at their address.
+        //
+        std::vector<Counters> m_destroyed{};
+        std::size_t m_collect_at{kMinCollectAt};
+    };
+
+    struct State
+    {
+        std::mutex m_lock{};
+        std::vector<ThreadTable *> m_tables{};
+
+        // Entries of threads which are gone, only accessed under m_lock.
+        //
+        ThreadTable m_retired{};
+
+        // Totals of the objects which have been destroyed, by type.
+        //
+        std::unordered_map<const char *, refcount_type_stats> m_destroyed{};
+        std::atomic<std::uint64_t> m_dropped_events{0};
+        std::atomic<std::uint32_t> m_contention_threshold{2};
+        std::atomic<bool> m_report_at_exit{SIA_CSP_PROFILE_REFCOUNT_REPORT_AT_EXIT != 0};
+    };
+
+    // Registers the thread table on construction and moves its counters to the retired ones on thread exit.
+    //
+    struct ThreadRegistration
+    {
+        ThreadRegistration()
+        {
+            State &state = instance();
+            std::lock_guard<std::mutex> lock{state.m_lock};
+            state.m_tables.push_back(&m_table);
+            threadTableSlot() = &m_table;
+        }
+
+        ThreadRegistration(const ThreadRegistration &) = delete;
+        ThreadRegistration &operator=(const ThreadRegistration &) = delete;
+
+        ~ThreadRegistration()
+        {
+            State &state = instance();
+            std::lock_guard<std::mutex> lock{state.m_lock};
+            threadTableSlot() = nullptr;
+            threadGone() = true;
+            state.m_tables.erase(std::find(state.m_tables.begin(), state.m_tables.end(), &m_table));
+            retire(state.m_retired, m_table);
+        }
+
+        ThreadTable m_table{};
+    };
+
+    // Prints the report when static objects are destroyed, the state itself is never destroyed so that pointers
+    // released afterwards can still be recorded.
+    //
+    struct ExitReporter
+    {
+        ExitReporter() = default;
+        ExitReporter(const ExitReporter &) = delete;
+        ExitReporter &operator=(const ExitReporter &) = delete;
+
+        ~ExitReporter()
+        {
+            if (instance().m_report_at_exit.load(std::memory_order_relaxed))
+                dump(std::cerr);
+        }
+    };
+
+    static State &instance() noexcept
+    {
+        static State *state = new State();  //NOLINT(cppcoreguidelines-owning-memory)
+        return *state;
+    }
+
+    static ThreadTable *&threadTableSlot() noexcept
+    {
+        thread_local ThreadTable *table = nullptr;
+        return table;
+    }
+
+    static bool &threadGone() noexcept
+    {
+        thread_local bool gone = false;
+        return gone;
+    }
+
+    static ThreadTable *threadTable()
+    {
+        ThreadTable *table = threadTableSlot();
+
+        if (table == nullptr && !threadGone())
+        {
+            static ExitReporter reporter{};
+            thread_local ThreadRegistration registration{};
+            table = threadTableSlot();
+        }
+
+        return table;
+    }
+
+    template <typename L, typename R>
+    static bool sameOwner(const L &lhs, const R &rhs) noexcept
+    {
+        return !lhs.owner_before(rhs) && !rhs.owner_before(lhs);
+    }
+
+    // Counts an event into the entry of the object ptr owns. The entry of a destroyed object at the same address is put
+    // aside for the next collection, a pointer which aliases a live object at that address is counted with it.
+    //
+    template <typename T>
+    static void count(ThreadTable &table, const void *object, const std::shared_ptr<T> &ptr, const char *type,
+                      detail::refcount_event event)
+    {
+        Counters &counters = table.m_objects[object];
+
+        if (counters.m_object != nullptr && !sameOwner(counters.m_owner, ptr) && counters.m_owner.expired())
+        {
+            table.m_destroyed.push_back(std::move(counters));
+            counters = Counters{};
+        }
+
+        if (counters.m_object == nullptr)
+        {
+            counters.m_owner = std::shared_ptr<const void>(ptr, static_cast<const void *>(nullptr));
+            counters.m_object = object;
+            counters.m_type = type;
+            counters.m_threads = 1;
+        }
+
+        add(counters, event);
+    }
+
+    static void add(Counters &counters, detail::refcount_event event) noexcept
+    {
+        switch (event)
+        {
+            case detail::refcount_event::copy:
+                ++counters.m_copies;
+                break;
+            case detail::refcount_event::move:
+                ++counters.m_moves;
+                break;
+            case detail::refcount_event::release:
+                ++counters.m_releases;
+                break;
+        }
+    }
+
+    static void add(Counters &into, const Counters &from) noexcept
+    {
+        into.m_object = from.m_object;
+        into.m_type = from.m_type;
+        into.m_copies += from.m_copies;
+        into.m_moves += from.m_moves;
+        into.m_releases += from.m_releases;
+        into.m_threads += from.m_threads;
+    }
+
+    // Moves the entries of an exiting thread to the retired ones, where they count as the same thread as all other
+    // exited ones.
+    //
+    static void retire(ThreadTable &into, ThreadTable &from)
+    {
+        for (auto &destroyed : from.m_destroyed)
+            into.m_destroyed.push_back(std::move(destroyed));
+
+        for (auto &[object, counters] : from.m_objects)
+        {
+            auto [it, inserted] = into.m_objects.try_emplace(object, counters);
+
+            if (inserted)
+                continue;
+
+            if (sameOwner(it->second.m_owner, counters.m_owner))
+            {
+                add(it->second, counters);
+            }
+            else if (it->second.m_owner.expired())
+            {
+                into.m_destroyed.push_back(std::move(it->second));
+                it->second = std::move(counters);
+            }
+            else
+            {
+                into.m_destroyed.push_back(std::move(counters));
+            }
+        }
+
+        from.clear();
+    }
+
+    // Every table holds an object at most once, so each one merged adds a thread.
+    //
+    static void merge(ObjectMap &into, const std::unordered_map<const void *, Counters> &from)
+    {
+        for (const auto &[object, counters] : from)
+            add(into[counters.m_owner], counters);
+    }
+
+    // Takes the entries of destroyed objects out of all tables and adds them to the totals of their type. The caller
+    // holds the lock of the state.
+    //
+    static void collect(State &state)
+    {
+        ObjectMap destroyed{};
+
+        const auto take = [&destroyed](ThreadTable &table)
+        {
+            for (const Counters &counters : table.m_destroyed)
+                add(destroyed[counters.m_owner], counters);
+            table.m_destroyed.clear();
+
+            for (auto it = table.m_objects.begin(); it != table.m_objects.end();)
+            {
+                if (it->second.m_owner.expired())
+                {
+                    add(destroyed[it->second.m_owner], it->second);
+                    it = table.m_objects.erase(it);
+                }
+                else
+                {
+                    ++it;
+                }
+            }
+
+            table.m_collect_at = std::max(kMinCollectAt, 2 * table.m_objects.size());
+        };
+
+        take(state.m_retired);
+        for (ThreadTable *table : state.m_tables)
+        {
+            std::lock_guard<std::mutex> table_lock{table->m_lock};
+            take(*table);
+        }
+
+        const std::uint32_t threshold = state.m_contention_threshold.load(std::memory_order_relaxed);
+
+        for (const auto &[owner, counters] : destroyed)
+        {
+            refcount_type_stats &type = state.m_destroyed[counters.m_type];
+            type.m_copies += counters.m_copies;
+            type.m_moves += counters.m_moves;
+            type.m_releases += counters.m_releases;
+            type.m_objects += 1;
+            type.m_contended_objects += counters.m_threads >= threshold ? 1 : 0;
+        }
+    }
+
+    // Turns the signature of detail::refcountTypeName<T>() into the name of T.
+    //
+    static std::string typeName(const char *signature)
+    {
+        if (signature == nullptr)
+            return "?";
+
+        std::string name{signature};
+        const std::size_t begin = name.find("T = ");
+
+        if (begin == std::string::npos)
+            return name;
+
+        const std::size_t end = name.find_first_of(";]", begin);
+        return name.substr(begin + 4, end == std::string::npos ? std::string::npos : end - begin - 4);
+    }
+};
+
+namespace detail
+{
+
+template <typename T>
+const char *refcountTypeName() noexcept
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return __PRETTY_FUNCTION__;
+#else
+    return nullptr;
+#endif
+}
+
+template <typename T>
+void profileRefcount(const std::shared_ptr<T> &ptr, refcount_event event) noexcept
+{
+    refcount_profiler::record(ptr, refcountTypeName<T>(), event);
+}
+
+}  // namespace detail
+
+}  // namespace sia
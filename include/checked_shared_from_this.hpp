@@ -0,0 +1,70 @@
+#pragma once
+
+#include "checked_shared_ptr.hpp"
+#include "checked_view.hpp"
+#include <memory>
+
+namespace sia
+{
+
+// Drop-in replacement for std::enable_shared_from_this which hands out checked pointers. checked_shared_from_this()
+// never throws std::bad_weak_ptr: an object which is not owned by a shared pointer, e.g. one on the stack or one whose
+// last owner is just being released on another thread, gets an empty checked_shared_ptr and its dereference is
+// reported to the check policy. view_from_this() borrows the object without touching the reference count at all.
+//
+// checked_shared_from_this() costs the same as shared_from_this(): the owner may be released concurrently, so the
+// reference has to be taken with the compare-and-swap of weak_ptr::lock(), and the standard library offers no portable
+// way around it. Use view_from_this() where no reference is needed.
+//
+// The std::enable_shared_from_this members stay available, so existing code keeps working.
+//
+template <typename T>
+class enable_checked_shared_from_this : public std::enable_shared_from_this<T> //NOLINT(readability-identifier-naming)
+{
+    public:
+    template <typename CheckPolicy = SIA_CSP_DEFAULT_CHECK_POLICY>
+    [[nodiscard]] checked_shared_ptr<T, CheckPolicy> checked_shared_from_this() noexcept //NOLINT(readability-identifier-naming)
+    {
+        try
+        {
+            return checked_shared_ptr<T, CheckPolicy>(this->shared_from_this());
+        }
+        catch (const std::bad_weak_ptr &)
+        {
+            return checked_shared_ptr<T, CheckPolicy>();
+        }
+    }
+
+    template <typename CheckPolicy = SIA_CSP_DEFAULT_CHECK_POLICY>
+    [[nodiscard]] checked_shared_ptr<const T, CheckPolicy> checked_shared_from_this() const noexcept //NOLINT(readability-identifier-naming)
+    {
+        try
+        {
+            return checked_shared_ptr<const T, CheckPolicy>(this->shared_from_this());
+        }
+        catch (const std::bad_weak_ptr &)
+        {
+            return checked_shared_ptr<const T, CheckPolicy>();
+        }
+    }
+
+    template <typename CheckPolicy = SIA_CSP_DEFAULT_CHECK_POLICY>
+    [[nodiscard]] checked_view<T, CheckPolicy> view_from_this() noexcept //NOLINT(readability-identifier-naming)
+    {
+        return checked_view<T, CheckPolicy>(static_cast<T *>(this));
+    }
+
+    template <typename CheckPolicy = SIA_CSP_DEFAULT_CHECK_POLICY>
+    [[nodiscard]] checked_view<const T, CheckPolicy> view_from_this() const noexcept //NOLINT(readability-identifier-naming)
+    {
+        return checked_view<const T, CheckPolicy>(static_cast<const T *>(this));
+    }
+
+    protected:
+    constexpr enable_checked_shared_from_this() noexcept = default;
+    enable_checked_shared_from_this(const enable_checked_shared_from_this &) noexcept = default;
+    enable_checked_shared_from_this &operator=(const enable_checked_shared_from_this &) noexcept = default;
+    ~enable_checked_shared_from_this() = default;
+};
+
+}  // namespace sia
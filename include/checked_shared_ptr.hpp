@@ -1,23 +1,389 @@
+#pragma once
+
 #include <memory>
+#include <cstddef>
 #include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <limits>
+#include <new>
+#include <optional>
 #include <type_traits>
+#include <typeinfo>
+
+#if defined(__GNUC__) || defined(__clang__)
+#define SIA_CSP_UNLIKELY(expr) __builtin_expect(!!(expr), 0)
+#define SIA_CSP_COLD __attribute__((cold, noinline))
+#define SIA_CSP_ALWAYS_INLINE __attribute__((always_inline)) inline
+#define SIA_CSP_CALLER_FILE __builtin_FILE()
+#define SIA_CSP_CALLER_LINE __builtin_LINE()
+#define SIA_CSP_CALLER_FUNCTION __builtin_FUNCTION()
+#define SIA_CSP_ASSUME(expr)         \
+    do                               \
+    {                                \
+        if (!(expr))                 \
+            __builtin_unreachable(); \
+    } while (false)
+#else
+#define SIA_CSP_UNLIKELY(expr) (expr)
+#define SIA_CSP_COLD
+#define SIA_CSP_ALWAYS_INLINE inline
+#define SIA_CSP_CALLER_FILE ""
+#define SIA_CSP_CALLER_LINE 0
+#define SIA_CSP_CALLER_FUNCTION ""
+#define SIA_CSP_ASSUME(expr) static_cast<void>(0)
+#endif
+
+// Records every null dereference in sia::null_telemetry before the default policy handles it, see
+// checked_null_telemetry.hpp.
+//
+#ifndef SIA_CSP_NULL_TELEMETRY
+#define SIA_CSP_NULL_TELEMETRY 0
+#endif
+
+// Counts copies, moves and releases of every checked_shared_ptr in sia::refcount_profiler, see
+// checked_refcount_profiler.hpp. The copy and move operations are no longer trivial in this mode.
+//
+#ifndef SIA_CSP_PROFILE_REFCOUNT
+#define SIA_CSP_PROFILE_REFCOUNT 0
+#endif
+
+// Null check policy used by checked_shared_ptr<T> when none is given explicitly. Define it project-wide,
+// e.g. -DSIA_CSP_DEFAULT_CHECK_POLICY=::sia::unchecked, to switch every pointer at once.
+//
+#ifndef SIA_CSP_DEFAULT_CHECK_POLICY
+#if SIA_CSP_NULL_TELEMETRY
+#define SIA_CSP_DEFAULT_CHECK_POLICY ::sia::record_on_null<::sia::throw_on_null>
+#else
+#define SIA_CSP_DEFAULT_CHECK_POLICY ::sia::throw_on_null
+#endif
+#endif
+
+namespace sia
+{
+
+struct CheckedNullPtrException : std::exception
+{
+};
+
+struct CheckedOutOfRangeException : std::exception
+{
+};
+
+// Null check policies. A policy decides what happens when a nullptr checked_shared_ptr is dereferenced.
+// The null branch is marked unlikely and onNullPtr() is kept out of line so that the hot path stays a single
+// compare and jump. is_noexcept is propagated to operator-> and operator*.
+//
+// The same policy checks the index of operator[] on arrays. A policy may handle an index out of bounds separately in
+// onOutOfRange(), otherwise it is treated like a nullptr dereference.
+//
+
+// Throws CheckedNullPtrException. This is the default.
+//
+struct throw_on_null //NOLINT(readability-identifier-naming)
+{
+    static constexpr bool is_checked = true;
+    static constexpr bool is_noexcept = false;
+
+    [[noreturn]] SIA_CSP_COLD static void onNullPtr() noexcept(false)
+    {
+        throw CheckedNullPtrException();
+    }
+
+    [[noreturn]] SIA_CSP_COLD static void onOutOfRange() noexcept(false)
+    {
+        throw CheckedOutOfRangeException();
+    }
+};
+
+// Calls std::abort(). No exception handling code is emitted at the call sites.
+//
+struct abort_on_null //NOLINT(readability-identifier-naming)
+{
+    static constexpr bool is_checked = true;
+    static constexpr bool is_noexcept = true;
+
+    [[noreturn]] SIA_CSP_COLD static void onNullPtr() noexcept
+    {
+        std::abort();
+    }
+};
+
+// Executes a trap instruction, the cheapest possible way to stop the process.
+//
+struct trap_on_null //NOLINT(readability-identifier-naming)
+{
+    static constexpr bool is_checked = true;
+    static constexpr bool is_noexcept = true;
+
+    [[noreturn]] SIA_CSP_COLD static void onNullPtr() noexcept
+    {
+#if defined(__GNUC__) || defined(__clang__)
+        __builtin_trap();
+#else
+        std::abort();
+#endif
+    }
+};
+
+// Calls the user provided handler. The handler is expected to throw or to terminate, if it returns the process
+// is aborted since there is nothing valid to dereference.
+//
+template <void (*Handler)()>
+struct callback_on_null //NOLINT(readability-identifier-naming)
+{
+    static constexpr bool is_checked = true;
+    static constexpr bool is_noexcept = false;
+
+    [[noreturn]] SIA_CSP_COLD static void onNullPtr() noexcept(false)
+    {
+        Handler();
+        std::abort();
+    }
+};
+
+// No check at all, operator-> and operator* are plain std::shared_ptr dereferences.
+//
+struct unchecked //NOLINT(readability-identifier-naming)
+{
+    static constexpr bool is_checked = false;
+    static constexpr bool is_noexcept = true;
+};
+
+// Records the call site in sia::null_telemetry and then hands over to the Inner policy. Defined in
+// checked_null_telemetry.hpp.
+//
+template <typename Inner = throw_on_null>
+struct record_on_null;
+
+template <typename T, typename CheckPolicy = SIA_CSP_DEFAULT_CHECK_POLICY>
+class checked_shared_ptr;
+
+template <typename T, typename CheckPolicy = SIA_CSP_DEFAULT_CHECK_POLICY>
+class checked_weak_ptr;
+
+template <typename T, typename CheckPolicy = SIA_CSP_DEFAULT_CHECK_POLICY>
+class not_null_checked_shared_ptr;
+
+namespace detail
+{
+
+// Passkey for the constructors of not_null_checked_shared_ptr which take the pointer as it is. Only checked_shared_ptr,
+// after its check, and the not-null factories, whose pointer cannot be null, can make one.
+//
+class not_null_access //NOLINT(readability-identifier-naming)
+{
+    template <typename U, typename Q>
+    friend class sia::checked_shared_ptr;
+
+    public:
+    // Backends of the not-null factories. They create the object themselves, there is no way to pass a pointer in
+    // which might be null.
+    //
+    template <typename T, typename P, typename... Args>
+    static not_null_checked_shared_ptr<T, P> makeShared(Args &&...args)
+    {
+        return not_null_checked_shared_ptr<T, P>(
+            not_null_access(), checked_shared_ptr<T, P>(std::make_shared<T>(std::forward<Args>(args)...)));
+    }
+
+    template <typename T, typename P, typename Alloc, typename... Args>
+    static not_null_checked_shared_ptr<T, P> allocateShared(const Alloc &alloc, Args &&...args)
+    {
+        return not_null_checked_shared_ptr<T, P>(
+            not_null_access(), checked_shared_ptr<T, P>(std::allocate_shared<T>(alloc, std::forward<Args>(args)...)));
+    }
+
+    private:
+    explicit not_null_access() = default;
+};
+
+}  // namespace detail
+
+template <typename Header, typename T>
+class with_trailing;
+
+}  // namespace sia
 
 namespace sia::detail
 {
 
+// Runs the null check of the given policy, shared by all checked pointer types.
+//
+template <typename CheckPolicy>
+SIA_CSP_ALWAYS_INLINE void checkNullPtr(const void *ptr) noexcept(CheckPolicy::is_noexcept)
+{
+    if constexpr (CheckPolicy::is_checked)
+    {
+        if (SIA_CSP_UNLIKELY(ptr == nullptr))
+            CheckPolicy::onNullPtr();
+    }
+}
+
+template <typename CheckPolicy, typename = void>
+struct has_on_null_ptr_at : std::false_type //NOLINT(readability-identifier-naming)
+{
+};
+
+template <typename CheckPolicy>
+struct has_on_null_ptr_at<CheckPolicy, std::void_t<decltype(&CheckPolicy::onNullPtrAt)>> : std::true_type
+{
+};
+
+// Same as checkNullPtr() but passes the source location down to policies which can make use of it.
+//
+template <typename CheckPolicy>
+SIA_CSP_ALWAYS_INLINE void checkNullPtrAt(const void *ptr, const char *file, std::uint32_t line,
+                                          const char *function) noexcept(CheckPolicy::is_noexcept)
+{
+    if constexpr (CheckPolicy::is_checked)
+    {
+        if (SIA_CSP_UNLIKELY(ptr == nullptr))
+        {
+            if constexpr (has_on_null_ptr_at<CheckPolicy>::value)
+                CheckPolicy::onNullPtrAt(file, line, function);
+            else
+                CheckPolicy::onNullPtr();
+        }
+    }
+}
+
+template <typename CheckPolicy, typename = void>
+struct has_on_out_of_range : std::false_type //NOLINT(readability-identifier-naming)
+{
+};
+
+template <typename CheckPolicy>
+struct has_on_out_of_range<CheckPolicy, std::void_t<decltype(&CheckPolicy::onOutOfRange)>> : std::true_type
+{
+};
+
+template <typename CheckPolicy>
+[[noreturn]] SIA_CSP_ALWAYS_INLINE void outOfRange() noexcept(CheckPolicy::is_noexcept)
+{
+    if constexpr (has_on_out_of_range<CheckPolicy>::value)
+        CheckPolicy::onOutOfRange();
+    else
+        CheckPolicy::onNullPtr();
+}
+
+// Bounds check of operator[], a negative index wraps around and fails as well.
+//
+template <typename CheckPolicy>
+SIA_CSP_ALWAYS_INLINE void checkIndex(std::ptrdiff_t index, std::size_t extent) noexcept(CheckPolicy::is_noexcept)
+{
+    if constexpr (CheckPolicy::is_checked)
+    {
+        if (SIA_CSP_UNLIKELY(static_cast<std::size_t>(index) >= extent))
+            outOfRange<CheckPolicy>();
+    }
+}
+
+// Number of elements behind a checked_shared_ptr<T[]> which did not come from make_checked_shared, e.g. one converted
+// from a std::shared_ptr<T[]>. Only negative indices are caught then.
+//
+inline constexpr std::size_t kUnknownExtent = static_cast<std::size_t>(-1);
+
+// Element count of the array a checked_shared_ptr manages. Bounded arrays know it at compile time, unbounded ones
+// carry it along with the pointer and every other type leaves it empty.
+//
+template <typename T>
+struct array_extent //NOLINT(readability-identifier-naming)
+{
+    [[nodiscard]] static constexpr std::size_t extent() noexcept
+    {
+        return std::extent_v<T>;
+    }
+
+    void setExtent(std::size_t /*extent*/) noexcept
+    {
+    }
+
+    template <typename U>
+    void setExtentFrom(const array_extent<U> & /*r*/) noexcept
+    {
+    }
+
+    void swapExtent(array_extent & /*r*/) noexcept
+    {
+    }
+};
+
+template <typename T>
+struct array_extent<T[]> //NOLINT(readability-identifier-naming)
+{
+    [[nodiscard]] std::size_t extent() const noexcept
+    {
+        return m_extent;
+    }
+
+    void setExtent(std::size_t extent) noexcept
+    {
+        m_extent = extent;
+    }
+
+    template <typename U>
+    void setExtentFrom(const array_extent<U> &r) noexcept
+    {
+        m_extent = std::is_array_v<U> ? r.extent() : kUnknownExtent;
+    }
+
+    void swapExtent(array_extent &r) noexcept
+    {
+        std::swap(m_extent, r.m_extent);
+    }
+
+    std::size_t m_extent{kUnknownExtent};
+};
+
+template <typename T>
+struct is_with_trailing : std::false_type //NOLINT(readability-identifier-naming)
+{
+};
+
+template <typename Header, typename T>
+struct is_with_trailing<with_trailing<Header, T>> : std::true_type
+{
+};
+
+enum class refcount_event //NOLINT(readability-identifier-naming)
+{
+    copy,
+    move,
+    release
+};
+
+#if SIA_CSP_PROFILE_REFCOUNT
+// Defined in checked_refcount_profiler.hpp. Takes the owner so that the profiler can tell the objects which share an
+// address apart.
+//
+template <typename T>
+void profileRefcount(const std::shared_ptr<T> &ptr, refcount_event event) noexcept;
+#else
+template <typename T>
+inline void profileRefcount(const std::shared_ptr<T> & /*ptr*/, refcount_event /*event*/) noexcept
+{
+}
+#endif
+
 template <typename T>
 struct checked_shared_from_this_empty //NOLINT(readability-identifier-naming)
 {
 };
 
 template <typename T>
-struct checked_shared_ptr_base //NOLINT(readability-identifier-naming)
+struct checked_shared_ptr_base : array_extent<T> //NOLINT(readability-identifier-naming)
 {
     using element_type = typename std::shared_ptr<T>::element_type;
 
     constexpr checked_shared_ptr_base() = default;
 
     checked_shared_ptr_base(const std::shared_ptr<T> &ptr) : m_ptr(ptr) //NOLINT(google-explicit-constructor)
+    {
+        profileRefcount<T>(m_ptr, refcount_event::copy);
+    }
+
+    checked_shared_ptr_base(std::shared_ptr<T> &&ptr) noexcept : m_ptr(std::move(ptr)) //NOLINT(google-explicit-constructor)
     {
     }
 
@@ -29,24 +395,71 @@ struct checked_shared_ptr_base //NOLINT(readability-identifier-naming)
     template <typename U>
     checked_shared_ptr_base(const checked_shared_ptr_base<U> &r, element_type *ptr) noexcept : m_ptr(r.m_ptr, ptr)
     {
+        profileRefcount<T>(m_ptr, refcount_event::copy);
     }
 
     template <typename U>
     checked_shared_ptr_base(checked_shared_ptr_base<U> &&r, element_type *ptr) noexcept : m_ptr(std::move(r.m_ptr), ptr)
     {
+        profileRefcount<T>(m_ptr, refcount_event::move);
     }
 
     template <typename U>
     explicit checked_shared_ptr_base(const checked_shared_ptr_base<U> &r) noexcept : m_ptr(r.m_ptr)
     {
+        this->setExtentFrom(r);
+        profileRefcount<T>(m_ptr, refcount_event::copy);
     }
 
     template <typename U>
     explicit checked_shared_ptr_base(checked_shared_ptr_base<U> &&r) noexcept : m_ptr(std::move(r.m_ptr))
     {
+        this->setExtentFrom(r);
+        profileRefcount<T>(m_ptr, refcount_event::move);
+    }
+
+#if SIA_CSP_PROFILE_REFCOUNT
+    checked_shared_ptr_base(const checked_shared_ptr_base &r) noexcept : array_extent<T>(r), m_ptr(r.m_ptr)
+    {
+        profileRefcount<T>(m_ptr, refcount_event::copy);
+    }
+
+    checked_shared_ptr_base(checked_shared_ptr_base &&r) noexcept : array_extent<T>(r), m_ptr(std::move(r.m_ptr))
+    {
+        profileRefcount<T>(m_ptr, refcount_event::move);
+    }
+
+    checked_shared_ptr_base &operator=(const checked_shared_ptr_base &r) noexcept
+    {
+        if (this != &r)
+        {
+            profileRefcount<T>(m_ptr, refcount_event::release);
+            array_extent<T>::operator=(r);
+            m_ptr = r.m_ptr;
+            profileRefcount<T>(m_ptr, refcount_event::copy);
+        }
+
+        return *this;
+    }
+
+    checked_shared_ptr_base &operator=(checked_shared_ptr_base &&r) noexcept
+    {
+        if (this != &r)
+        {
+            profileRefcount<T>(m_ptr, refcount_event::release);
+            array_extent<T>::operator=(r);
+            m_ptr = std::move(r.m_ptr);
+            profileRefcount<T>(m_ptr, refcount_event::move);
+        }
+
+        return *this;
     }
 
-    virtual ~checked_shared_ptr_base() = default;
+    ~checked_shared_ptr_base()
+    {
+        profileRefcount<T>(m_ptr, refcount_event::release);
+    }
+#endif
 
     std::shared_ptr<T> m_ptr{nullptr};
 };
@@ -65,6 +478,13 @@ struct checked_shared_from_this : public checked_shared_ptr_base<T> //NOLINT(rea
         //
         return this->m_ptr.get()->shared_from_this();
     }
+
+    // Taken from the managed pointer itself, so there is no need to dereference it.
+    //
+    checked_weak_ptr<T> weak_from_this() const noexcept
+    {
+        return checked_weak_ptr<T>(this->m_ptr);
+    }
 };
 
 }
@@ -72,20 +492,19 @@ struct checked_shared_from_this : public checked_shared_ptr_base<T> //NOLINT(rea
 namespace sia
 {
 
-struct CheckedNullPtrException : std::exception
-{
-};
-
-template <typename T>
+template <typename T, typename CheckPolicy>
 class checked_shared_ptr final : public std::conditional_t<std::is_base_of_v<std::enable_shared_from_this<T>, T>, //NOLINT(readability-identifier-naming)
                                                            detail::checked_shared_from_this<T>, detail::checked_shared_ptr_base<T>>
 {
     using MyBase = std::conditional_t<std::is_base_of_v<std::enable_shared_from_this<T>, T>,
                                       detail::checked_shared_from_this<T>, detail::checked_shared_ptr_base<T>>;
 
-    template <typename U>
+    template <typename U, typename Q>
     friend class checked_shared_ptr;
 
+    template <typename U, typename Q>
+    friend class checked_weak_ptr;
+
     // std::shared_ptr<T> m_ptr{nullptr};
 
     template <typename... Args>
@@ -111,6 +530,20 @@ class checked_shared_ptr final : public std::conditional_t<std::is_base_of_v<std
     {
     }
 
+    // Conversion constructor, takes over the reference of ptr.
+    //
+    checked_shared_ptr(std::shared_ptr<T> &&ptr) noexcept : MyBase(std::move(ptr)) //NOLINT(google-explicit-constructor)
+    {
+    }
+
+    // Conversion constructor, takes over the reference of ptr.
+    //
+    template <typename U, typename = std::enable_if_t<std::is_convertible_v<U *, T *>>>
+    checked_shared_ptr(std::shared_ptr<U> &&ptr) noexcept //NOLINT(google-explicit-constructor)
+        : MyBase(std::shared_ptr<T>(std::move(ptr)))
+    {
+    }
+
     // Default contructor.
     //
     constexpr checked_shared_ptr() noexcept = default;
@@ -130,15 +563,15 @@ class checked_shared_ptr final : public std::conditional_t<std::is_base_of_v<std
 
     // Alising constructor.
     //
-    template <typename U>
-    checked_shared_ptr(const checked_shared_ptr<U> &r, element_type *ptr) noexcept : MyBase(r, ptr)
+    template <typename U, typename Q>
+    checked_shared_ptr(const checked_shared_ptr<U, Q> &r, element_type *ptr) noexcept : MyBase(r, ptr)
     {
     }
 
     // Alising constructor.
     //
-    template <typename U>
-    checked_shared_ptr(checked_shared_ptr<U> &&r, element_type *ptr) noexcept : MyBase(std::move(r), ptr)
+    template <typename U, typename Q>
+    checked_shared_ptr(checked_shared_ptr<U, Q> &&r, element_type *ptr) noexcept : MyBase(std::move(r), ptr)
     {
     }
 
@@ -148,8 +581,8 @@ class checked_shared_ptr final : public std::conditional_t<std::is_base_of_v<std
 
     // Conversion copy constructor.
     //
-    template <typename U, typename = Constructible<std::shared_ptr<U>>>
-    explicit checked_shared_ptr(const checked_shared_ptr<U> &r) noexcept : MyBase(r)
+    template <typename U, typename Q, typename = Constructible<std::shared_ptr<U>>>
+    explicit checked_shared_ptr(const checked_shared_ptr<U, Q> &r) noexcept : MyBase(r)
     {
     }
 
@@ -159,8 +592,8 @@ class checked_shared_ptr final : public std::conditional_t<std::is_base_of_v<std
 
     // Conversion move constructor.
     //
-    template <typename U, typename = Constructible<std::shared_ptr<U>>>
-    explicit checked_shared_ptr(checked_shared_ptr<U> &&r) noexcept : MyBase(std::move(r))
+    template <typename U, typename Q, typename = Constructible<std::shared_ptr<U>>>
+    explicit checked_shared_ptr(checked_shared_ptr<U, Q> &&r) noexcept : MyBase(std::move(r))
     {
     }
 
@@ -170,10 +603,13 @@ class checked_shared_ptr final : public std::conditional_t<std::is_base_of_v<std
 
     // Conversion copy assignment operator.
     //
-    template <typename U, typename = Assignable<const std::shared_ptr<U> &>>
-    checked_shared_ptr &operator=(const checked_shared_ptr<U> &r)
+    template <typename U, typename Q, typename = Assignable<const std::shared_ptr<U> &>>
+    checked_shared_ptr &operator=(const checked_shared_ptr<U, Q> &r)
     {
+        detail::profileRefcount<T>(this->m_ptr, detail::refcount_event::release);
         this->m_ptr = r.m_ptr;
+        this->setExtentFrom(r);
+        detail::profileRefcount<T>(this->m_ptr, detail::refcount_event::copy);
         return *this;
     }
 
@@ -191,18 +627,23 @@ class checked_shared_ptr final : public std::conditional_t<std::is_base_of_v<std
 
     void reset() noexcept
     {
+        detail::profileRefcount<T>(this->m_ptr, detail::refcount_event::release);
         this->m_ptr.reset();
+        this->setExtent(detail::kUnknownExtent);
     }
 
     template <typename U, typename = std::enable_if_t<std::is_convertible_v<U *, T *>>>
     void reset(U *ptr) noexcept
     {
+        detail::profileRefcount<T>(this->m_ptr, detail::refcount_event::release);
         this->m_ptr.reset(ptr);
+        this->setExtent(detail::kUnknownExtent);
     }
 
     void swap(checked_shared_ptr &r) noexcept
     {
         this->m_ptr.swap(r.m_ptr);
+        this->swapExtent(r);
     }
 
     element_type *get() const noexcept
@@ -215,209 +656,1111 @@ class checked_shared_ptr final : public std::conditional_t<std::is_base_of_v<std
         return this->m_ptr.use_count();
     }
 
-    element_type &operator*() const noexcept(false)
+    SIA_CSP_ALWAYS_INLINE element_type &operator*() const noexcept(CheckPolicy::is_noexcept)
     {
         throwIfNullPtr();
         return *this->m_ptr;
     }
 
-    element_type *operator->() const noexcept(false)
+    SIA_CSP_ALWAYS_INLINE element_type *operator->() const noexcept(CheckPolicy::is_noexcept)
     {
         throwIfNullPtr();
         return this->m_ptr.get();
     }
 
+    // Checked get() which reports the file and line of the caller to the check policy, e.g. to record_on_null.
+    // operator-> cannot take any arguments so it is only identified by its code address.
+    //
+    SIA_CSP_ALWAYS_INLINE element_type *getChecked(const char *file = SIA_CSP_CALLER_FILE,
+                                                   std::uint32_t line = SIA_CSP_CALLER_LINE,
+                                                   const char *function = SIA_CSP_CALLER_FUNCTION) const
+        noexcept(CheckPolicy::is_noexcept)
+    {
+        detail::checkNullPtrAt<CheckPolicy>(get(), file, line, function);
+        return this->m_ptr.get();
+    }
+
+    // Null and bounds checked element access of arrays. The bounds are known for T[N] and for T[] created by
+    // make_checked_shared, see detail::kUnknownExtent for the rest.
+    //
+    template <typename U = T>
+    SIA_CSP_ALWAYS_INLINE std::enable_if_t<std::is_array_v<U>, element_type &> operator[](std::ptrdiff_t index) const
+        noexcept(CheckPolicy::is_noexcept)
+    {
+        throwIfNullPtr();
+        detail::checkIndex<CheckPolicy>(index, this->extent());
+        return get()[index];
+    }
+
+    // Null and bounds checked access to the trailing elements of a with_trailing object.
+    //
+    template <typename U = T>
+    SIA_CSP_ALWAYS_INLINE std::enable_if_t<detail::is_with_trailing<U>::value, typename U::trailing_type &>
+    operator[](std::ptrdiff_t index) const noexcept(CheckPolicy::is_noexcept)
+    {
+        throwIfNullPtr();
+        detail::checkIndex<CheckPolicy>(index, get()->trailingSize());
+        return get()->trailingData()[index];
+    }
+
     explicit operator bool() const noexcept
     {
         return this->m_ptr.operator bool();
     }
 
+    template <typename U, typename Q>
+    [[nodiscard]] bool owner_before(const checked_shared_ptr<U, Q> &r) const noexcept //NOLINT(readability-identifier-naming)
+    {
+        return this->m_ptr.owner_before(r.m_ptr);
+    }
+
     auto managedSharedPointer() const noexcept
     {
         return this->m_ptr;
     }
 
-    private:
-    inline void throwIfNullPtr() const noexcept(false)
+    // Runs the null check once and returns a handle which can never be null, so that its operator-> and operator* do
+    // not need any further check. Use it in front of hot loops.
+    //
+    not_null_checked_shared_ptr<T, CheckPolicy> non_null() const & noexcept(CheckPolicy::is_noexcept) //NOLINT(readability-identifier-naming)
     {
-        if (get() == nullptr)
-            throw CheckedNullPtrException();
+        throwIfNullPtr();
+        return not_null_checked_shared_ptr<T, CheckPolicy>(detail::not_null_access(), *this);
     }
-};
 
-template <typename Ch, typename Tr, typename Tp>
-inline std::basic_ostream<Ch, Tr> &operator<<(std::basic_ostream<Ch, Tr> &os, const checked_shared_ptr<Tp> &p)
-{
-    os << p.get();
-    return os;
-}
+    not_null_checked_shared_ptr<T, CheckPolicy> non_null() && noexcept(CheckPolicy::is_noexcept) //NOLINT(readability-identifier-naming)
+    {
+        throwIfNullPtr();
+        return not_null_checked_shared_ptr<T, CheckPolicy>(detail::not_null_access(), std::move(*this));
+    }
 
-template <typename T>
-inline bool operator==(const ::sia::checked_shared_ptr<T> &lhs, std::nullptr_t) noexcept
-{
-    return lhs.get() == nullptr;
-}
+    // The same without the check policy, empty if the pointer is null. It keeps the outcome of a test in the type, so
+    // that the accesses behind it are unchecked:
+    //
+    //     if (auto frame = ptr.try_non_null())
+    //         render(**frame);
+    //
+    [[nodiscard]] std::optional<not_null_checked_shared_ptr<T, CheckPolicy>> try_non_null() const & noexcept //NOLINT(readability-identifier-naming)
+    {
+        if (get() == nullptr)
+            return std::nullopt;
 
-template <typename T>
-inline bool operator==(std::nullptr_t, const ::sia::checked_shared_ptr<T> &lhs) noexcept
-{
-    return lhs.get() == nullptr;
-}
+        return std::optional<not_null_checked_shared_ptr<T, CheckPolicy>>(std::in_place, detail::not_null_access(),
+                                                                          *this);
+    }
 
-template <typename T, typename U>
-inline bool operator==(const checked_shared_ptr<T> &lhs, const checked_shared_ptr<U> &rhs) noexcept
-{
-    return lhs.get() == rhs.get();
-}
+    [[nodiscard]] std::optional<not_null_checked_shared_ptr<T, CheckPolicy>> try_non_null() && noexcept //NOLINT(readability-identifier-naming)
+    {
+        if (get() == nullptr)
+            return std::nullopt;
 
-template <typename T>
-inline bool operator!=(const ::sia::checked_shared_ptr<T> &lhs, std::nullptr_t) noexcept
-{
-    return lhs.get() != nullptr;
-}
+        return std::optional<not_null_checked_shared_ptr<T, CheckPolicy>>(std::in_place, detail::not_null_access(),
+                                                                          std::move(*this));
+    }
 
-template <typename T>
-inline bool operator!=(std::nullptr_t, const ::sia::checked_shared_ptr<T> &lhs) noexcept
-{
-    return lhs.get() != nullptr;
-}
+    private:
+    SIA_CSP_ALWAYS_INLINE void throwIfNullPtr() const noexcept(CheckPolicy::is_noexcept)
+    {
+        detail::checkNullPtr<CheckPolicy>(get());
+    }
+};
 
-template <typename T, typename U>
-inline bool operator!=(const checked_shared_ptr<T> &lhs, const checked_shared_ptr<U> &rhs) noexcept
+// A checked_shared_ptr which is known to be non-null, created by checked_shared_ptr::non_null(), try_non_null() or
+// make_not_null_checked_shared(). There is no way to make it null: it has no default constructor, no reset() and
+// moving from it copies, so the source stays valid. operator-> and operator* are therefore unchecked and noexcept. It
+// converts back to checked_shared_ptr implicitly.
+//
+template <typename T, typename CheckPolicy>
+class not_null_checked_shared_ptr final //NOLINT(readability-identifier-naming)
 {
-    return lhs.get() != rhs.get();
-}
+    template <typename U, typename Q>
+    friend class checked_shared_ptr;
 
-template <typename T, typename U>
-inline bool operator<(const checked_shared_ptr<T> &lhs, const checked_shared_ptr<U> &rhs) noexcept
-{
-    using LhsT = typename checked_shared_ptr<T>::element_type;
-    using RhsT = typename checked_shared_ptr<U>::element_type;
-    using RsT = std::common_type_t<LhsT *, RhsT *>;
-    return std::less<RsT>()(lhs.get(), rhs.get());
-}
+    template <typename U, typename Q>
+    friend class not_null_checked_shared_ptr;
 
-template <typename T>
-inline bool operator<(const checked_shared_ptr<T> &r, std::nullptr_t) noexcept
-{
-    using RsT = typename checked_shared_ptr<T>::element_type;
+    public:
+    using element_type = typename checked_shared_ptr<T, CheckPolicy>::element_type;
+
+    not_null_checked_shared_ptr() = delete;
+    not_null_checked_shared_ptr(std::nullptr_t) = delete;
+
+    // Default copy constructor. There is intentionally no move constructor.
+    //
+    not_null_checked_shared_ptr(const not_null_checked_shared_ptr &r) noexcept = default;
+
+    // Conversion copy constructor.
+    //
+    template <typename U, typename Q, typename = std::enable_if_t<std::is_convertible_v<U *, T *>>>
+    not_null_checked_shared_ptr(const not_null_checked_shared_ptr<U, Q> &r) noexcept //NOLINT(google-explicit-constructor)
+        : m_ptr(r.m_ptr)
+    {
+    }
+
+    // Default copy assignment operator. There is intentionally no move assignment operator.
+    //
+    not_null_checked_shared_ptr &operator=(const not_null_checked_shared_ptr &) noexcept = default;
+
+    not_null_checked_shared_ptr &operator=(std::nullptr_t) = delete;
+
+    void swap(not_null_checked_shared_ptr &r) noexcept
+    {
+        m_ptr.swap(r.m_ptr);
+    }
+
+    element_type *get() const noexcept
+    {
+        element_type *ptr = m_ptr.get();
+        SIA_CSP_ASSUME(ptr != nullptr);
+        return ptr;
+    }
+
+    [[nodiscard]] std::int64_t use_count() const noexcept //NOLINT(readability-identifier-naming)
+    {
+        return m_ptr.use_count();
+    }
+
+    element_type &operator*() const noexcept
+    {
+        return *get();
+    }
+
+    element_type *operator->() const noexcept
+    {
+        return get();
+    }
+
+    explicit operator bool() const noexcept
+    {
+        return true;
+    }
+
+    // Decays to the nullable pointer.
+    //
+    operator const checked_shared_ptr<T, CheckPolicy> &() const noexcept //NOLINT(google-explicit-constructor)
+    {
+        return m_ptr;
+    }
+
+    const checked_shared_ptr<T, CheckPolicy> &nullable() const noexcept
+    {
+        return m_ptr;
+    }
+
+    // Take the pointer as it is, see detail::not_null_access.
+    //
+    not_null_checked_shared_ptr(detail::not_null_access /*key*/, const checked_shared_ptr<T, CheckPolicy> &ptr) noexcept
+        : m_ptr(ptr)
+    {
+    }
+
+    not_null_checked_shared_ptr(detail::not_null_access /*key*/, checked_shared_ptr<T, CheckPolicy> &&ptr) noexcept
+        : m_ptr(std::move(ptr))
+    {
+    }
+
+    private:
+    checked_shared_ptr<T, CheckPolicy> m_ptr;
+};
+
+// The wrapper must not add anything on top of the managed std::shared_ptr. Neither the base nor the
+// shared_from_this mixin may declare virtual members.
+//
+static_assert(sizeof(checked_shared_ptr<int>) == sizeof(std::shared_ptr<int>));
+
+template <typename Ch, typename Tr, typename Tp, typename P>
+inline std::basic_ostream<Ch, Tr> &operator<<(std::basic_ostream<Ch, Tr> &os, const checked_shared_ptr<Tp, P> &p)
+{
+    os << p.get();
+    return os;
+}
+
+template <typename T, typename P>
+inline bool operator==(const ::sia::checked_shared_ptr<T, P> &lhs, std::nullptr_t) noexcept
+{
+    return lhs.get() == nullptr;
+}
+
+template <typename T, typename P>
+inline bool operator==(std::nullptr_t, const ::sia::checked_shared_ptr<T, P> &lhs) noexcept
+{
+    return lhs.get() == nullptr;
+}
+
+template <typename T, typename P, typename U, typename Q>
+inline bool operator==(const checked_shared_ptr<T, P> &lhs, const checked_shared_ptr<U, Q> &rhs) noexcept
+{
+    return lhs.get() == rhs.get();
+}
+
+template <typename T, typename P>
+inline bool operator!=(const ::sia::checked_shared_ptr<T, P> &lhs, std::nullptr_t) noexcept
+{
+    return lhs.get() != nullptr;
+}
+
+template <typename T, typename P>
+inline bool operator!=(std::nullptr_t, const ::sia::checked_shared_ptr<T, P> &lhs) noexcept
+{
+    return lhs.get() != nullptr;
+}
+
+template <typename T, typename P, typename U, typename Q>
+inline bool operator!=(const checked_shared_ptr<T, P> &lhs, const checked_shared_ptr<U, Q> &rhs) noexcept
+{
+    return lhs.get() != rhs.get();
+}
+
+template <typename T, typename P, typename U, typename Q>
+inline bool operator<(const checked_shared_ptr<T, P> &lhs, const checked_shared_ptr<U, Q> &rhs) noexcept
+{
+    using LhsT = typename checked_shared_ptr<T, P>::element_type;
+    using RhsT = typename checked_shared_ptr<U, Q>::element_type;
+    using RsT = std::common_type_t<LhsT *, RhsT *>;
+    return std::less<RsT>()(lhs.get(), rhs.get());
+}
+
+template <typename T, typename P>
+inline bool operator<(const checked_shared_ptr<T, P> &r, std::nullptr_t) noexcept
+{
+    using RsT = typename checked_shared_ptr<T, P>::element_type;
     return std::less<RsT *>()(r.get(), nullptr);
 }
 
-template <typename T>
-inline bool operator<(std::nullptr_t, const checked_shared_ptr<T> &r) noexcept
+template <typename T, typename P>
+inline bool operator<(std::nullptr_t, const checked_shared_ptr<T, P> &r) noexcept
 {
-    using RsT = typename checked_shared_ptr<T>::element_type;
+    using RsT = typename checked_shared_ptr<T, P>::element_type;
     return std::less<RsT *>()(r.get(), nullptr);
 }
 
-template <typename T, typename U>
-inline bool operator<=(const checked_shared_ptr<T> &lhs, const checked_shared_ptr<U> &rhs) noexcept
+template <typename T, typename P, typename U, typename Q>
+inline bool operator<=(const checked_shared_ptr<T, P> &lhs, const checked_shared_ptr<U, Q> &rhs) noexcept
 {
     return !(rhs < lhs);
 }
 
-template <typename T>
-inline bool operator<=(const checked_shared_ptr<T> &r, std::nullptr_t) noexcept
+template <typename T, typename P>
+inline bool operator<=(const checked_shared_ptr<T, P> &r, std::nullptr_t) noexcept
 {
     return !(nullptr < r);
 }
 
-template <typename T>
-inline bool operator<=(std::nullptr_t, const checked_shared_ptr<T> &r) noexcept
+template <typename T, typename P>
+inline bool operator<=(std::nullptr_t, const checked_shared_ptr<T, P> &r) noexcept
 {
     return !(r < nullptr);
 }
 
-template <typename T, typename U>
-inline bool operator>(const checked_shared_ptr<T> &lhs, const checked_shared_ptr<U> &rhs) noexcept
+template <typename T, typename P, typename U, typename Q>
+inline bool operator>(const checked_shared_ptr<T, P> &lhs, const checked_shared_ptr<U, Q> &rhs) noexcept
 {
     return rhs < lhs;
 }
 
-template <typename T>
-inline bool operator>(const checked_shared_ptr<T> &r, std::nullptr_t) noexcept
+template <typename T, typename P>
+inline bool operator>(const checked_shared_ptr<T, P> &r, std::nullptr_t) noexcept
 {
     return nullptr < r;
 }
 
-template <typename T>
-inline bool operator>(std::nullptr_t, const checked_shared_ptr<T> &r) noexcept
+template <typename T, typename P>
+inline bool operator>(std::nullptr_t, const checked_shared_ptr<T, P> &r) noexcept
 {
     return r < nullptr;
 }
 
-template <typename T, typename U>
-inline bool operator>=(const checked_shared_ptr<T> &lhs, const checked_shared_ptr<U> &rhs) noexcept
+template <typename T, typename P, typename U, typename Q>
+inline bool operator>=(const checked_shared_ptr<T, P> &lhs, const checked_shared_ptr<U, Q> &rhs) noexcept
 {
     return !(lhs < rhs);
 }
 
-template <typename T>
-inline bool operator>=(const checked_shared_ptr<T> &r, std::nullptr_t) noexcept
+template <typename T, typename P>
+inline bool operator>=(const checked_shared_ptr<T, P> &r, std::nullptr_t) noexcept
 {
     return !(r < nullptr);
 }
 
-template <typename T>
-inline bool operator>=(std::nullptr_t, const checked_shared_ptr<T> &r) noexcept
+template <typename T, typename P>
+inline bool operator>=(std::nullptr_t, const checked_shared_ptr<T, P> &r) noexcept
 {
     return !(nullptr < r);
 }
 
+template <typename T, typename P>
+inline void swap(checked_shared_ptr<T, P> &a, checked_shared_ptr<T, P> &b) noexcept
+{
+    a.swap(b);
+}
+
+template <typename T, typename P, typename U, typename Q>
+inline bool operator==(const not_null_checked_shared_ptr<T, P> &lhs, const not_null_checked_shared_ptr<U, Q> &rhs) noexcept
+{
+    return lhs.get() == rhs.get();
+}
+
+template <typename T, typename P, typename U, typename Q>
+inline bool operator!=(const not_null_checked_shared_ptr<T, P> &lhs, const not_null_checked_shared_ptr<U, Q> &rhs) noexcept
+{
+    return lhs.get() != rhs.get();
+}
+
+template <typename T, typename P, typename U, typename Q>
+inline bool operator<(const not_null_checked_shared_ptr<T, P> &lhs, const not_null_checked_shared_ptr<U, Q> &rhs) noexcept
+{
+    return lhs.nullable() < rhs.nullable();
+}
+
+template <typename T, typename P>
+inline void swap(not_null_checked_shared_ptr<T, P> &a, not_null_checked_shared_ptr<T, P> &b) noexcept
+{
+    a.swap(b);
+}
+
+namespace detail
+{
+
+template <typename T>
+struct is_unbounded_array : std::false_type //NOLINT(readability-identifier-naming)
+{
+};
+
+template <typename T>
+struct is_unbounded_array<T[]> : std::true_type
+{
+};
+
+// Where allocate_shared has to put the control block and the object, followed by the trailing elements.
+//
+struct trailing_storage //NOLINT(readability-identifier-naming)
+{
+    std::size_t m_size;
+    void **m_data;
+};
+
+// Allocator for allocate_shared which appends room for trailing elements to the control block it allocates, so that
+// both end up in a single allocation. The address of that room is written to *m_data, from where the constructor of
+// the object picks it up.
+//
+template <typename T>
+struct trailing_allocator //NOLINT(readability-identifier-naming)
+{
+    using value_type = T;
+
+    trailing_allocator(std::size_t bytes, std::size_t alignment, void **data) noexcept
+        : m_bytes(bytes), m_alignment(alignment), m_data(data)
+    {
+    }
+
+    template <typename U>
+    trailing_allocator(const trailing_allocator<U> &r) noexcept //NOLINT(google-explicit-constructor)
+        : m_bytes(r.m_bytes), m_alignment(r.m_alignment), m_data(r.m_data)
+    {
+    }
+
+    T *allocate(std::size_t n)
+    {
+        if (m_bytes > std::numeric_limits<std::size_t>::max() - offset(n))
+            throw std::bad_array_new_length();
+
+        void *block = alignment() > __STDCPP_DEFAULT_NEW_ALIGNMENT__
+                          ? ::operator new(size(n), std::align_val_t(alignment()))
+                          : ::operator new(size(n));
+
+        *m_data = static_cast<unsigned char *>(block) + offset(n);
+        return static_cast<T *>(block);
+    }
+
+    void deallocate(T *block, std::size_t n) noexcept
+    {
+        if (alignment() > __STDCPP_DEFAULT_NEW_ALIGNMENT__)
+            ::operator delete(block, size(n), std::align_val_t(alignment()));
+        else
+            ::operator delete(block, size(n));
+    }
+
+    template <typename U>
+    bool operator==(const trailing_allocator<U> &r) const noexcept
+    {
+        return m_bytes == r.m_bytes && m_alignment == r.m_alignment;
+    }
+
+    template <typename U>
+    bool operator!=(const trailing_allocator<U> &r) const noexcept
+    {
+        return !(*this == r);
+    }
+
+    [[nodiscard]] std::size_t alignment() const noexcept
+    {
+        return alignof(T) > m_alignment ? alignof(T) : m_alignment;
+    }
+
+    [[nodiscard]] std::size_t offset(std::size_t n) const noexcept
+    {
+        return (sizeof(T) * n + m_alignment - 1) / m_alignment * m_alignment;
+    }
+
+    [[nodiscard]] std::size_t size(std::size_t n) const noexcept
+    {
+        return offset(n) + m_bytes;
+    }
+
+    std::size_t m_bytes;
+    std::size_t m_alignment;
+    void **m_data;
+};
+
+// Bytes taken by size trailing elements behind a header of header_bytes. Throws std::bad_array_new_length, like
+// new T[size], when they do not fit into the address space, instead of wrapping around to a small allocation.
+//
+template <typename Element>
+std::size_t trailingBytes(std::size_t size, std::size_t header_bytes)
+{
+    if (size > (std::numeric_limits<std::size_t>::max() - header_bytes) / sizeof(Element))
+        throw std::bad_array_new_length();
+
+    return sizeof(Element) * size;
+}
+
+// Constructs size objects of type T at data, destroys the ones already constructed if one of them throws.
+//
+template <typename T, bool ValueInit>
+T *constructTrailing(void *data, std::size_t size)
+{
+    static_assert(!std::is_array_v<T>, "Arrays of arrays are not supported");
+
+    T *first = static_cast<T *>(data);
+    std::size_t constructed = 0;
+
+    try
+    {
+        for (; constructed < size; ++constructed)
+        {
+            if constexpr (ValueInit)
+                ::new (static_cast<void *>(first + constructed)) T();
+            else
+                ::new (static_cast<void *>(first + constructed)) T;
+        }
+    }
+    catch (...)
+    {
+        while (constructed > 0)
+            first[--constructed].~T();
+        throw;
+    }
+
+    return first;
+}
+
 template <typename T>
-inline void swap(checked_shared_ptr<T> &a, checked_shared_ptr<T> &b)
+void destroyTrailing(T *first, std::size_t size) noexcept
 {
-    a.m_ptr.swap(b.m_ptr);
+    if constexpr (!std::is_trivially_destructible_v<T>)
+    {
+        while (size > 0)
+            first[--size].~T();
+    }
 }
 
-template<typename T, typename... Args>
-sia::checked_shared_ptr<T> make_checked_shared(Args&&... args)
+// Owner of the elements of make_checked_shared<T[]>(size), which live right behind the control block.
+//
+template <typename T>
+class unbounded_array_block //NOLINT(readability-identifier-naming)
+{
+    public:
+    explicit unbounded_array_block(trailing_storage storage)
+        : m_data(constructTrailing<T, true>(*storage.m_data, storage.m_size)), m_size(storage.m_size)
+    {
+    }
+
+    unbounded_array_block(const unbounded_array_block &) = delete;
+    unbounded_array_block &operator=(const unbounded_array_block &) = delete;
+
+    ~unbounded_array_block()
+    {
+        destroyTrailing(m_data, m_size);
+    }
+
+    [[nodiscard]] T *data() const noexcept
+    {
+        return m_data;
+    }
+
+    private:
+    T *m_data;
+    std::size_t m_size;
+};
+
+template <typename T, std::size_t N>
+struct bounded_array_block //NOLINT(readability-identifier-naming)
+{
+    T m_values[N]{}; //NOLINT(modernize-avoid-c-arrays)
+};
+
+}  // namespace detail
+
+// An object of type Header followed by a runtime sized array of T, created in a single allocation together with the
+// control block by make_checked_shared<with_trailing<Header, T>>(size, args...). Header is constructed from args and
+// the trailing elements are default initialized, so a buffer of bytes is left uninitialized just like with new[].
+// checked_shared_ptr::operator[] gives null and bounds checked access to the elements.
+//
+template <typename Header, typename T>
+class with_trailing final : public Header //NOLINT(readability-identifier-naming)
+{
+    public:
+    using header_type = Header;
+    using trailing_type = T;
+
+    template <typename... Args>
+    explicit with_trailing(detail::trailing_storage storage, Args &&...args)
+        : Header(std::forward<Args>(args)...),
+          m_data(detail::constructTrailing<T, false>(*storage.m_data, storage.m_size)),
+          m_size(storage.m_size)
+    {
+    }
+
+    with_trailing(const with_trailing &) = delete;
+    with_trailing &operator=(const with_trailing &) = delete;
+
+    ~with_trailing()
+    {
+        detail::destroyTrailing(m_data, m_size);
+    }
+
+    [[nodiscard]] T *trailingData() const noexcept
+    {
+        return m_data;
+    }
+
+    [[nodiscard]] std::size_t trailingSize() const noexcept
+    {
+        return m_size;
+    }
+
+    T *trailingBegin() const noexcept
+    {
+        return m_data;
+    }
+
+    T *trailingEnd() const noexcept
+    {
+        return m_data + m_size;
+    }
+
+    private:
+    T *m_data;
+    std::size_t m_size;
+};
+
+template <typename T, typename... Args>
+std::enable_if_t<!std::is_array_v<T> && !detail::is_with_trailing<T>::value, sia::checked_shared_ptr<T>>
+make_checked_shared(Args &&...args)
 {
     return std::make_shared<T>(std::forward<Args>(args)...);
 }
+
+// Value initialized array of size elements. The elements live in the same allocation as the control block and the
+// pointer knows the size, so operator[] is bounds checked.
+//
+template <typename T>
+std::enable_if_t<detail::is_unbounded_array<T>::value, sia::checked_shared_ptr<T>> make_checked_shared(std::size_t size)
+{
+    using Element = std::remove_extent_t<T>;
+    using Block = detail::unbounded_array_block<Element>;
+
+    void *data = nullptr;
+    auto block = std::allocate_shared<Block>(
+        detail::trailing_allocator<Block>(detail::trailingBytes<Element>(size, sizeof(Block) + alignof(Element)),
+                                          alignof(Element), &data),
+        detail::trailing_storage{size, &data});
+
+    sia::checked_shared_ptr<T> result{std::shared_ptr<T>(block, block->data())};
+    result.setExtent(size);
+    return result;
+}
+
+// Value initialized array of N elements.
+//
+template <typename T>
+std::enable_if_t<std::is_array_v<T> && std::extent_v<T> != 0, sia::checked_shared_ptr<T>> make_checked_shared()
+{
+    using Block = detail::bounded_array_block<std::remove_extent_t<T>, std::extent_v<T>>;
+
+    auto block = std::make_shared<Block>();
+    return std::shared_ptr<T>(block, block->m_values);
+}
+
+// A Header constructed from args followed by size default initialized elements, see with_trailing.
+//
+template <typename T, typename... Args>
+std::enable_if_t<detail::is_with_trailing<T>::value, sia::checked_shared_ptr<T>> make_checked_shared(std::size_t size,
+                                                                                                     Args &&...args)
+{
+    using Element = typename T::trailing_type;
+
+    void *data = nullptr;
+    const std::size_t bytes = detail::trailingBytes<Element>(size, sizeof(T) + alignof(Element));
+    return std::allocate_shared<T>(detail::trailing_allocator<T>(bytes, alignof(Element), &data),
+                                   detail::trailing_storage{size, &data}, std::forward<Args>(args)...);
+}
+
+// Same as make_checked_shared but the object and the control block are allocated together by alloc, e.g. a
+// std::pmr::polymorphic_allocator over a per-request arena.
+//
+template <typename T, typename Alloc, typename... Args>
+sia::checked_shared_ptr<T> allocate_checked_shared(const Alloc &alloc, Args &&...args)
+{
+    return std::allocate_shared<T>(alloc, std::forward<Args>(args)...);
+}
+
+// Same as make_checked_shared and allocate_checked_shared, but typed as non-null right away. The allocation either
+// succeeds or throws, so there is nothing to check, not even once.
+//
+template <typename T, typename... Args>
+std::enable_if_t<!std::is_array_v<T> && !detail::is_with_trailing<T>::value, sia::not_null_checked_shared_ptr<T>>
+make_not_null_checked_shared(Args &&...args)
+{
+    return detail::not_null_access::makeShared<T, SIA_CSP_DEFAULT_CHECK_POLICY>(std::forward<Args>(args)...);
+}
+
+template <typename T, typename Alloc, typename... Args>
+sia::not_null_checked_shared_ptr<T> allocate_not_null_checked_shared(const Alloc &alloc, Args &&...args)
+{
+    return detail::not_null_access::allocateShared<T, SIA_CSP_DEFAULT_CHECK_POLICY>(alloc, std::forward<Args>(args)...);
+}
+
+// Weak counterpart of checked_shared_ptr. It observes the managed std::shared_ptr directly, so creating one from a
+// checked_shared_ptr only touches the weak count.
+//
+template <typename T, typename CheckPolicy>
+class checked_weak_ptr final //NOLINT(readability-identifier-naming)
+{
+    template <typename U, typename Q>
+    friend class checked_weak_ptr;
+
+    template <typename U>
+    using Convertible = std::enable_if_t<std::is_convertible_v<U *, T *>>;
+
+    public:
+    using element_type = typename std::weak_ptr<T>::element_type;
+
+    // Default contructor.
+    //
+    constexpr checked_weak_ptr() noexcept = default;
+
+    // Constructor observing a checked_shared_ptr.
+    //
+    template <typename U, typename Q, typename = Convertible<U>>
+    checked_weak_ptr(const checked_shared_ptr<U, Q> &r) noexcept : m_ptr(r.m_ptr) //NOLINT(google-explicit-constructor)
+    {
+    }
+
+    // Conversion constructor.
+    //
+    template <typename U, typename = Convertible<U>>
+    checked_weak_ptr(const std::shared_ptr<U> &r) noexcept : m_ptr(r) //NOLINT(google-explicit-constructor)
+    {
+    }
+
+    // Conversion constructor.
+    //
+    template <typename U, typename = Convertible<U>>
+    checked_weak_ptr(const std::weak_ptr<U> &r) noexcept : m_ptr(r) //NOLINT(google-explicit-constructor)
+    {
+    }
+
+    // Default copy constructor.
+    //
+    checked_weak_ptr(const checked_weak_ptr &r) noexcept = default;
+
+    // Conversion copy constructor.
+    //
+    template <typename U, typename Q, typename = Convertible<U>>
+    checked_weak_ptr(const checked_weak_ptr<U, Q> &r) noexcept : m_ptr(r.m_ptr) //NOLINT(google-explicit-constructor)
+    {
+    }
+
+    // Default move constructor.
+    //
+    checked_weak_ptr(checked_weak_ptr &&r) noexcept = default;
+
+    // Conversion move constructor.
+    //
+    template <typename U, typename Q, typename = Convertible<U>>
+    checked_weak_ptr(checked_weak_ptr<U, Q> &&r) noexcept : m_ptr(std::move(r.m_ptr)) //NOLINT(google-explicit-constructor)
+    {
+    }
+
+    // Default copy assignment operator.
+    //
+    checked_weak_ptr &operator=(const checked_weak_ptr &) noexcept = default;
+
+    // Default move assignment operator.
+    //
+    checked_weak_ptr &operator=(checked_weak_ptr &&) noexcept = default;
+
+    // Assignment operator observing a checked_shared_ptr.
+    //
+    template <typename U, typename Q, typename = Convertible<U>>
+    checked_weak_ptr &operator=(const checked_shared_ptr<U, Q> &r) noexcept
+    {
+        m_ptr = r.m_ptr;
+        return *this;
+    }
+
+    void reset() noexcept
+    {
+        m_ptr.reset();
+    }
+
+    void swap(checked_weak_ptr &r) noexcept
+    {
+        m_ptr.swap(r.m_ptr);
+    }
+
+    [[nodiscard]] std::int64_t use_count() const noexcept //NOLINT(readability-identifier-naming)
+    {
+        return m_ptr.use_count();
+    }
+
+    // A single relaxed load of the use count.
+    //
+    [[nodiscard]] bool expired() const noexcept
+    {
+        return m_ptr.expired();
+    }
+
+    // Returns an empty pointer if the object is already gone.
+    //
+    checked_shared_ptr<T, CheckPolicy> lock() const noexcept
+    {
+        return m_ptr.lock();
+    }
+
+    // Promotes and applies the null check of the policy in one step, an expired object is treated like a nullptr
+    // access.
+    //
+    checked_shared_ptr<T, CheckPolicy> lock_or_throw() const noexcept(CheckPolicy::is_noexcept) //NOLINT(readability-identifier-naming)
+    {
+        checked_shared_ptr<T, CheckPolicy> ptr = m_ptr.lock();
+        detail::checkNullPtr<CheckPolicy>(ptr.get());
+        return ptr;
+    }
+
+    template <typename U, typename Q>
+    [[nodiscard]] bool owner_before(const checked_weak_ptr<U, Q> &r) const noexcept //NOLINT(readability-identifier-naming)
+    {
+        return m_ptr.owner_before(r.m_ptr);
+    }
+
+    template <typename U, typename Q>
+    [[nodiscard]] bool owner_before(const checked_shared_ptr<U, Q> &r) const noexcept //NOLINT(readability-identifier-naming)
+    {
+        return m_ptr.owner_before(r.m_ptr);
+    }
+
+    auto managedWeakPointer() const noexcept
+    {
+        return m_ptr;
+    }
+
+    private:
+    std::weak_ptr<T> m_ptr{};
+};
+
+template <typename T, typename P>
+inline void swap(checked_weak_ptr<T, P> &a, checked_weak_ptr<T, P> &b) noexcept
+{
+    a.swap(b);
+}
+
+namespace detail
+{
+
+// LLVM style type tag: To declares static bool classof(const From *) which tells whether the object is a To.
+//
+template <typename To, typename From, typename = void>
+struct has_classof : std::false_type //NOLINT(readability-identifier-naming)
+{
+};
+
+template <typename To, typename From>
+struct has_classof<To, From, std::void_t<decltype(bool(To::classof(std::declval<const From *>())))>>
+    : std::true_type
+{
+};
+
+template <typename To, typename From, typename = void>
+struct is_static_castable : std::false_type //NOLINT(readability-identifier-naming)
+{
+};
+
+template <typename To, typename From>
+struct is_static_castable<To, From, std::void_t<decltype(static_cast<To *>(std::declval<From *>()))>>
+    : std::true_type
+{
+};
+
+// Nothing derives from a final class, so an object is one exactly when its dynamic type is. Comparing the type_info
+// is a lot cheaper than the hierarchy walk of dynamic_cast.
+//
+template <typename To, typename From>
+inline constexpr bool is_final_downcast = std::is_final_v<std::remove_cv_t<To>> && std::is_polymorphic_v<From> &&
+                                          !std::is_convertible_v<From *, To *> && is_static_castable<To, From>::value;
+
+// Same result as dynamic_cast<To *>(ptr), but downcasts which can be decided without RTTI use a static_cast.
+//
+template <typename To, typename From>
+SIA_CSP_ALWAYS_INLINE To *dynamicCast(From *ptr) noexcept
+{
+    if constexpr (std::is_convertible_v<From *, To *>)
+    {
+        return ptr;
+    }
+    else if constexpr (has_classof<std::remove_cv_t<To>, std::remove_cv_t<From>>::value &&
+                       is_static_castable<To, From>::value)
+    {
+        return ptr != nullptr && std::remove_cv_t<To>::classof(ptr) ? static_cast<To *>(ptr) : nullptr;
+    }
+    else if constexpr (is_final_downcast<To, From>)
+    {
+        return ptr != nullptr && typeid(*ptr) == typeid(To) ? static_cast<To *>(ptr) : nullptr;
+    }
+    else
+    {
+        return dynamic_cast<To *>(ptr);
+    }
+}
+
+// Hands the ownership of r over to a pointer to ptr and leaves r empty. Conversions std::shared_ptr can do on its own
+// move the control block along. Everything else goes through the aliasing constructor, which only steals from an
+// rvalue since C++20, before that it costs one increment and one decrement.
+//
+template <typename T, typename U, typename P>
+checked_shared_ptr<T, P> moveAliased(checked_shared_ptr<U, P> &&r,
+                                     typename checked_shared_ptr<T, P>::element_type *ptr) noexcept
+{
+    using Ptr = checked_shared_ptr<T, P>;
+
+    if constexpr (std::is_convertible_v<typename checked_shared_ptr<U, P>::element_type *, typename Ptr::element_type *>)
+    {
+        if (ptr == r.get())
+            return Ptr(std::move(r));
+    }
+
+    Ptr result(std::move(r), ptr);
+    r.reset();
+    return result;
+}
+
+}  // namespace detail
+
+// Same as std::dynamic_pointer_cast but a failed cast throws CheckedNullPtrException instead of returning nullptr,
+// so is a nullptr source.
+//
+template <typename T, typename U, typename P>
+checked_shared_ptr<T, P> checked_pointer_cast(const checked_shared_ptr<U, P> &r) //NOLINT(readability-identifier-naming)
+{
+    using Ptr = checked_shared_ptr<T, P>;
+    auto *ptr = detail::dynamicCast<typename Ptr::element_type>(r.get());
+
+    if (SIA_CSP_UNLIKELY(ptr == nullptr))
+        throw_on_null::onNullPtr();
+
+    return Ptr(r, ptr);
+}
+
+// Steals the reference of r. r is left untouched when the cast fails.
+//
+template <typename T, typename U, typename P>
+checked_shared_ptr<T, P> checked_pointer_cast(checked_shared_ptr<U, P> &&r) //NOLINT(readability-identifier-naming)
+{
+    using Ptr = checked_shared_ptr<T, P>;
+    auto *ptr = detail::dynamicCast<typename Ptr::element_type>(r.get());
+
+    if (SIA_CSP_UNLIKELY(ptr == nullptr))
+        throw_on_null::onNullPtr();
+
+    return detail::moveAliased<T>(std::move(r), ptr);
+}
+
+namespace detail
+{
+
+// Hash of an address. Heap addresses are multiples of 16, so hashing them unchanged leaves the low bits empty and
+// open addressing tables, which take the bucket from the low bits, cluster badly. This is the 64-bit finalizer of
+// MurmurHash3, every bit of the address affects every bit of the result.
+//
+inline std::size_t hashPointer(const void *ptr) noexcept
+{
+    auto hash = static_cast<std::uint64_t>(reinterpret_cast<std::uintptr_t>(ptr));
+    hash ^= hash >> 33U;
+    hash *= 0xFF51AFD7ED558CCDULL;
+    hash ^= hash >> 33U;
+    hash *= 0xC4CEB9FE1A85EC53ULL;
+    hash ^= hash >> 33U;
+    return static_cast<std::size_t>(hash);
+}
+
+template <typename T>
+const void *keyAddress(T *ptr) noexcept
+{
+    return ptr;
+}
+
+inline const void *keyAddress(std::nullptr_t) noexcept
+{
+    return nullptr;
+}
+
+template <typename Ptr>
+auto keyAddress(const Ptr &ptr) noexcept -> decltype(static_cast<const void *>(ptr.get()))
+{
+    return ptr.get();
+}
+
+}  // namespace detail
+
+// Transparent hash, equality and ordering for hash tables and ordered containers keyed by checked pointers. All of
+// them accept checked_shared_ptr, the other checked pointers, std::shared_ptr, std::unique_ptr and raw pointers, and
+// compare by address. This way e.g. a std::set<checked_shared_ptr<T>, checked_ptr_less> can be searched by T *
+// without building a temporary checked_shared_ptr, which costs a refcount increment and decrement. Unordered
+// containers support this since C++20. Probes must point to the element type of the keys, the addresses of base
+// class subobjects are not adjusted.
+//
+struct checked_ptr_hash //NOLINT(readability-identifier-naming)
+{
+    using is_transparent = void; //NOLINT(readability-identifier-naming)
+
+    template <typename Ptr>
+    std::size_t operator()(const Ptr &ptr) const noexcept
+    {
+        return detail::hashPointer(detail::keyAddress(ptr));
+    }
+};
+
+struct checked_ptr_equal //NOLINT(readability-identifier-naming)
+{
+    using is_transparent = void; //NOLINT(readability-identifier-naming)
+
+    template <typename Lhs, typename Rhs>
+    bool operator()(const Lhs &lhs, const Rhs &rhs) const noexcept
+    {
+        return detail::keyAddress(lhs) == detail::keyAddress(rhs);
+    }
+};
+
+struct checked_ptr_less //NOLINT(readability-identifier-naming)
+{
+    using is_transparent = void; //NOLINT(readability-identifier-naming)
+
+    template <typename Lhs, typename Rhs>
+    bool operator()(const Lhs &lhs, const Rhs &rhs) const noexcept
+    {
+        return std::less<const void *>()(detail::keyAddress(lhs), detail::keyAddress(rhs));
+    }
+};
 }  // namespace sia
 
 namespace std
 {
-template <typename _Tp>
-struct hash<sia::checked_shared_ptr<_Tp>> : public __hash_base<size_t, shared_ptr<_Tp>>
+template <typename _Tp, typename _Pp>
+struct hash<sia::checked_shared_ptr<_Tp, _Pp>>
+{
+    size_t operator()(const sia::checked_shared_ptr<_Tp, _Pp> &__s) const noexcept
+    {
+        return sia::detail::hashPointer(__s.get());
+    }
+};
+
+template <typename _Tp, typename _Pp>
+struct hash<sia::not_null_checked_shared_ptr<_Tp, _Pp>>
 {
-    size_t operator()(const sia::checked_shared_ptr<_Tp> &__s) const noexcept
+    size_t operator()(const sia::not_null_checked_shared_ptr<_Tp, _Pp> &__s) const noexcept
     {
-        return std::hash<typename sia::checked_shared_ptr<_Tp>::element_type *>()(__s.get());
+        return sia::detail::hashPointer(__s.get());
     }
 };
 
-template <typename T, typename U>
-inline ::sia::checked_shared_ptr<T> static_pointer_cast(const ::sia::checked_shared_ptr<U> &__r) noexcept
+template <typename T, typename U, typename P>
+inline ::sia::checked_shared_ptr<T, P> static_pointer_cast(const ::sia::checked_shared_ptr<U, P> &__r) noexcept
 {
-    using _Sp = ::sia::checked_shared_ptr<T>;
+    using _Sp = ::sia::checked_shared_ptr<T, P>;
     return _Sp(__r, static_cast<typename _Sp::element_type *>(
-                        const_cast<typename ::sia::checked_shared_ptr<U>::element_type *>(__r.get())));
+                        const_cast<typename ::sia::checked_shared_ptr<U, P>::element_type *>(__r.get())));
 }
 
-template <typename T, typename U>
-inline ::sia::checked_shared_ptr<T> dynamic_pointer_cast(const ::sia::checked_shared_ptr<U> &__r) noexcept
+template <typename T, typename U, typename P>
+inline ::sia::checked_shared_ptr<T, P> static_pointer_cast(::sia::checked_shared_ptr<U, P> &&__r) noexcept
 {
-    using _Sp = ::sia::checked_shared_ptr<T>;
-    return _Sp(__r, dynamic_cast<typename _Sp::element_type *>(
-                        const_cast<typename ::sia::checked_shared_ptr<U>::element_type *>(__r.get())));
+    using _Sp = ::sia::checked_shared_ptr<T, P>;
+    auto *__p = static_cast<typename _Sp::element_type *>(
+        const_cast<typename ::sia::checked_shared_ptr<U, P>::element_type *>(__r.get()));
+    return ::sia::detail::moveAliased<T>(std::move(__r), __p);
 }
 
-template <typename T, typename U>
-inline ::sia::checked_shared_ptr<T> const_pointer_cast(const ::sia::checked_shared_ptr<U> &__r) noexcept
+template <typename T, typename U, typename P>
+inline ::sia::checked_shared_ptr<T, P> dynamic_pointer_cast(const ::sia::checked_shared_ptr<U, P> &__r) noexcept
 {
-    using _Sp = ::sia::checked_shared_ptr<T>;
-    return _Sp(__r, static_cast<typename _Sp::element_type *>(
-                        const_cast<typename ::sia::checked_shared_ptr<U>::element_type *>(__r.get())));
+    using _Sp = ::sia::checked_shared_ptr<T, P>;
+    return _Sp(__r, ::sia::detail::dynamicCast<typename _Sp::element_type>(
+                        const_cast<typename ::sia::checked_shared_ptr<U, P>::element_type *>(__r.get())));
 }
 
-template <typename T, typename U>
-inline ::sia::checked_shared_ptr<T> reinterpret_pointer_cast(const ::sia::checked_shared_ptr<U> &__r) noexcept
+// Leaves __r untouched when the cast fails.
+//
+template <typename T, typename U, typename P>
+inline ::sia::checked_shared_ptr<T, P> dynamic_pointer_cast(::sia::checked_shared_ptr<U, P> &&__r) noexcept
 {
-    using Sp = ::sia::checked_shared_ptr<T>;
-    returnSp(__r, reinterpret_cast<typename Sp::element_type *>(
-                        const_cast<typename ::sia::checked_shared_ptr<U>::element_type *>(__r.get())));
+    using _Sp = ::sia::checked_shared_ptr<T, P>;
+    auto *__p = ::sia::detail::dynamicCast<typename _Sp::element_type>(
+        const_cast<typename ::sia::checked_shared_ptr<U, P>::element_type *>(__r.get()));
+
+    if (__p == nullptr)
+        return _Sp();
+
+    return ::sia::detail::moveAliased<T>(std::move(__r), __p);
 }
-}  // namespace std
\ No newline at end of file
+
+template <typename T, typename U, typename P>
+inline ::sia::checked_shared_ptr<T, P> const_pointer_cast(const ::sia::checked_shared_ptr<U, P> &__r) noexcept
+{
+    using _Sp = ::sia::checked_shared_ptr<T, P>;
+    return _Sp(__r, const_cast<typename _Sp::element_type *>(__r.get()));
+}
+
+template <typename T, typename U, typename P>
+inline ::sia::checked_shared_ptr<T, P> const_pointer_cast(::sia::checked_shared_ptr<U, P> &&__r) noexcept
+{
+    using _Sp = ::sia::checked_shared_ptr<T, P>;
+    auto *__p = const_cast<typename _Sp::element_type *>(__r.get());
+    return ::sia::detail::moveAliased<T>(std::move(__r), __p);
+}
+
+template <typename T, typename U, typename P>
+inline ::sia::checked_shared_ptr<T, P> reinterpret_pointer_cast(const ::sia::checked_shared_ptr<U, P> &__r) noexcept
+{
+    using _Sp = ::sia::checked_shared_ptr<T, P>;
+    return _Sp(__r, reinterpret_cast<typename _Sp::element_type *>(
+                        const_cast<typename ::sia::checked_shared_ptr<U, P>::element_type *>(__r.get())));
+}
+
+template <typename T, typename U, typename P>
+inline ::sia::checked_shared_ptr<T, P> reinterpret_pointer_cast(::sia::checked_shared_ptr<U, P> &&__r) noexcept
+{
+    using _Sp = ::sia::checked_shared_ptr<T, P>;
+    auto *__p = reinterpret_cast<typename _Sp::element_type *>(
+        const_cast<typename ::sia::checked_shared_ptr<U, P>::element_type *>(__r.get()));
+    return ::sia::detail::moveAliased<T>(std::move(__r), __p);
+}
+}  // namespace std
+
+#if SIA_CSP_NULL_TELEMETRY
+#include "checked_null_telemetry.hpp"
+#endif
+
+#if SIA_CSP_PROFILE_REFCOUNT
+#include "checked_refcount_profiler.hpp"
+#endif
@@ -0,0 +1,226 @@
+#pragma once
+
+#include "atomic_checked_shared_ptr.hpp"
+#include "checked_shared_ptr.hpp"
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+
+namespace sia
+{
+
+namespace detail
+{
+
+constexpr unsigned log2Of(std::size_t value) noexcept
+{
+    unsigned bits = 0;
+    while (value > 1)
+    {
+        value >>= 1;
+        ++bits;
+    }
+
+    return bits;
+}
+
+}  // namespace detail
+
+// A checked_shared_ptr which carries a few bits of user metadata, e.g. a dirty flag, a color or a version, in the
+// stored pointer itself, so that it takes no more room than a std::shared_ptr. The tag lives in the low bits which
+// are always zero due to the alignment of T and in the upper 16 bits of the address. Like atomic_checked_shared_ptr
+// this assumes user space addresses of at most 48 bits, which holds on x86-64 and AArch64 without pointer tagging.
+//
+// The stored pointer of the std::shared_ptr inside is the encoded word, it is never dereferenced and get() masks the
+// tag off. Null checks look at the address only, so a null pointer with a tag is still null.
+//
+// set_tag() rebuilds the stored pointer with the aliasing constructor, which costs an increment and a decrement of
+// the reference count in C++17. Keep the tag in sync with the pointer by assigning both at once where it matters.
+//
+template <typename T, typename CheckPolicy = SIA_CSP_DEFAULT_CHECK_POLICY>
+class tagged_checked_shared_ptr final //NOLINT(readability-identifier-naming)
+{
+    static_assert(!std::is_array_v<T> && !std::is_void_v<T>, "tagged_checked_shared_ptr requires an object type");
+    static_assert(sizeof(void *) == sizeof(std::uint64_t), "tagged_checked_shared_ptr requires 64-bit pointers");
+
+    template <typename U, typename Q>
+    friend class tagged_checked_shared_ptr;
+
+    public:
+    using element_type = T;
+    using tag_type = std::uintptr_t;
+
+    static constexpr unsigned kLowTagBits = detail::log2Of(alignof(T));
+    static constexpr unsigned kHighTagBits = 16;
+    static constexpr unsigned kTagBits = kLowTagBits + kHighTagBits;
+    static constexpr tag_type kMaxTag = (tag_type{1} << kTagBits) - 1;
+
+    constexpr tagged_checked_shared_ptr() noexcept = default;
+
+    constexpr tagged_checked_shared_ptr(std::nullptr_t) noexcept //NOLINT(google-explicit-constructor)
+    {
+    }
+
+    // Takes over the reference of ptr.
+    //
+    tagged_checked_shared_ptr(checked_shared_ptr<T, CheckPolicy> ptr, tag_type tag = 0) noexcept //NOLINT(google-explicit-constructor)
+        : m_ptr(std::move(ptr.m_ptr))
+    {
+        if (tag != 0)
+            set_tag(tag);
+    }
+
+    tagged_checked_shared_ptr(const tagged_checked_shared_ptr &) noexcept = default;
+    tagged_checked_shared_ptr(tagged_checked_shared_ptr &&) noexcept = default;
+    tagged_checked_shared_ptr &operator=(const tagged_checked_shared_ptr &) noexcept = default;
+    tagged_checked_shared_ptr &operator=(tagged_checked_shared_ptr &&) noexcept = default;
+
+    element_type *get() const noexcept
+    {
+        return reinterpret_cast<element_type *>(word() & kAddressMask); //NOLINT(performance-no-int-to-ptr)
+    }
+
+    [[nodiscard]] tag_type tag() const noexcept
+    {
+        const tag_type word = this->word();
+        return (word & kLowMask) | ((word >> kAddressBits) << kLowTagBits);
+    }
+
+    void set_tag(tag_type tag) noexcept //NOLINT(readability-identifier-naming)
+    {
+        assert(tag <= kMaxTag);
+        m_ptr = std::shared_ptr<T>(m_ptr, encode(get(), tag));
+    }
+
+    // The pointer without the tag, sharing ownership.
+    //
+    [[nodiscard]] checked_shared_ptr<T, CheckPolicy> untagged() const
+    {
+        return checked_shared_ptr<T, CheckPolicy>(std::shared_ptr<T>(m_ptr, get()));
+    }
+
+    void reset() noexcept
+    {
+        m_ptr.reset();
+    }
+
+    void swap(tagged_checked_shared_ptr &r) noexcept
+    {
+        m_ptr.swap(r.m_ptr);
+    }
+
+    [[nodiscard]] std::int64_t use_count() const noexcept //NOLINT(readability-identifier-naming)
+    {
+        return m_ptr.use_count();
+    }
+
+    SIA_CSP_ALWAYS_INLINE element_type &operator*() const noexcept(CheckPolicy::is_noexcept)
+    {
+        detail::checkNullPtr<CheckPolicy>(get());
+        return *get();
+    }
+
+    SIA_CSP_ALWAYS_INLINE element_type *operator->() const noexcept(CheckPolicy::is_noexcept)
+    {
+        detail::checkNullPtr<CheckPolicy>(get());
+        return get();
+    }
+
+    explicit operator bool() const noexcept
+    {
+        return get() != nullptr;
+    }
+
+    template <typename U, typename Q>
+    [[nodiscard]] bool owner_before(const tagged_checked_shared_ptr<U, Q> &r) const noexcept //NOLINT(readability-identifier-naming)
+    {
+        return m_ptr.owner_before(r.m_ptr);
+    }
+
+    private:
+    static constexpr unsigned kAddressBits = 48;
+    static constexpr tag_type kLowMask = (tag_type{1} << kLowTagBits) - 1;
+    static constexpr tag_type kAddressMask = ((tag_type{1} << kAddressBits) - 1) & ~kLowMask;
+
+    tag_type word() const noexcept
+    {
+        return reinterpret_cast<tag_type>(m_ptr.get());
+    }
+
+    static element_type *encode(element_type *ptr, tag_type tag) noexcept
+    {
+        const auto address = reinterpret_cast<tag_type>(ptr);
+        assert((address & ~kAddressMask) == 0);
+        return reinterpret_cast<element_type *>(address | (tag & kLowMask) | //NOLINT(performance-no-int-to-ptr)
+                                                ((tag >> kLowTagBits) << kAddressBits));
+    }
+
+    std::shared_ptr<T> m_ptr{nullptr};
+};
+
+// Equal if both the pointer and the tag are.
+//
+template <typename T, typename P, typename U, typename Q>
+inline bool operator==(const tagged_checked_shared_ptr<T, P> &lhs, const tagged_checked_shared_ptr<U, Q> &rhs) noexcept
+{
+    return lhs.get() == rhs.get() && lhs.tag() == rhs.tag();
+}
+
+template <typename T, typename P, typename U, typename Q>
+inline bool operator!=(const tagged_checked_shared_ptr<T, P> &lhs, const tagged_checked_shared_ptr<U, Q> &rhs) noexcept
+{
+    return !(lhs == rhs);
+}
+
+template <typename T, typename P>
+inline bool operator==(const tagged_checked_shared_ptr<T, P> &lhs, std::nullptr_t) noexcept
+{
+    return lhs.get() == nullptr;
+}
+
+template <typename T, typename P>
+inline bool operator!=(const tagged_checked_shared_ptr<T, P> &lhs, std::nullptr_t) noexcept
+{
+    return lhs.get() != nullptr;
+}
+
+namespace detail
+{
+
+// A null pointer with a tag is a value of its own and needs a node.
+//
+template <typename T, typename P>
+struct atomic_slot_traits<tagged_checked_shared_ptr<T, P>> //NOLINT(readability-identifier-naming)
+{
+    static bool isEmpty(const tagged_checked_shared_ptr<T, P> &value) noexcept
+    {
+        return value.get() == nullptr && value.tag() == 0;
+    }
+};
+
+}  // namespace detail
+
+// Lock-free atomic slot for tagged_checked_shared_ptr. compare_exchange succeeds only if both the pointer and the tag
+// match, so a writer can e.g. flip a dirty flag or bump a version of the current object without a lock.
+//
+template <typename T, typename CheckPolicy = SIA_CSP_DEFAULT_CHECK_POLICY>
+class atomic_tagged_checked_shared_ptr final //NOLINT(readability-identifier-naming)
+    : public detail::atomic_shared_slot<tagged_checked_shared_ptr<T, CheckPolicy>>
+{
+    using Slot = detail::atomic_shared_slot<tagged_checked_shared_ptr<T, CheckPolicy>>;
+
+    public:
+    using Slot::Slot;
+
+    constexpr atomic_tagged_checked_shared_ptr() noexcept = default;
+
+    atomic_tagged_checked_shared_ptr &operator=(tagged_checked_shared_ptr<T, CheckPolicy> desired)
+    {
+        this->store(std::move(desired));
+        return *this;
+    }
+};
+
+}  // namespace sia
@@ -0,0 +1,193 @@
+#pragma once
+
+#include "checked_shared_ptr.hpp"
+#include <cassert>
+#include <functional>
+#include <ostream>
+#include <type_traits>
+
+// When enabled a view made from a checked_shared_ptr remembers its owner weakly and asserts on every access that the
+// owner is still alive. This doubles the size of the view and it is no longer trivially copyable, so it is meant for
+// debug builds only.
+//
+#ifndef SIA_CSP_CHECK_VIEW_LIFETIME
+#define SIA_CSP_CHECK_VIEW_LIFETIME 0
+#endif
+
+namespace sia
+{
+
+// Non-owning, borrowed pointer with the same null checking as checked_shared_ptr. Pass it instead of a
+// checked_shared_ptr to functions which do not keep ownership, creating and copying it never touches the reference
+// count. The owner has to outlive the view.
+//
+template <typename T, typename CheckPolicy = SIA_CSP_DEFAULT_CHECK_POLICY>
+class checked_view final //NOLINT(readability-identifier-naming)
+{
+    template <typename U, typename Q>
+    friend class checked_view;
+
+    template <typename U>
+    using Convertible = std::enable_if_t<std::is_convertible_v<U *, T *>>;
+
+    public:
+    using element_type = T;
+
+    // Default contructor.
+    //
+    constexpr checked_view() noexcept = default;
+
+    // Contructor accepting nullptr.
+    //
+    constexpr checked_view(std::nullptr_t) noexcept //NOLINT(google-explicit-constructor)
+    {
+    }
+
+    // Constructor accepting raw pointer.
+    //
+    template <typename U, typename = Convertible<U>>
+    constexpr explicit checked_view(U *ptr) noexcept : m_ptr(ptr)
+    {
+    }
+
+    // Constructor borrowing from a checked_shared_ptr.
+    //
+    template <typename U, typename Q, typename = Convertible<U>>
+    checked_view(const checked_shared_ptr<U, Q> &r) noexcept //NOLINT(google-explicit-constructor)
+        : m_ptr(r.get())
+#if SIA_CSP_CHECK_VIEW_LIFETIME
+        , m_owner(r.m_ptr)
+#endif
+    {
+    }
+
+    // A view on a temporary would dangle right away.
+    //
+    template <typename U, typename Q, typename = Convertible<U>>
+    checked_view(checked_shared_ptr<U, Q> &&r) = delete;
+
+    // Conversion copy constructor.
+    //
+    template <typename U, typename Q, typename = Convertible<U>>
+    checked_view(const checked_view<U, Q> &r) noexcept //NOLINT(google-explicit-constructor)
+        : m_ptr(r.m_ptr)
+#if SIA_CSP_CHECK_VIEW_LIFETIME
+        , m_owner(r.m_owner)
+#endif
+    {
+    }
+
+    element_type *get() const noexcept
+    {
+        assertOwnerAlive();
+        return m_ptr;
+    }
+
+    element_type &operator*() const noexcept(CheckPolicy::is_noexcept)
+    {
+        throwIfNullPtr();
+        return *m_ptr;
+    }
+
+    element_type *operator->() const noexcept(CheckPolicy::is_noexcept)
+    {
+        throwIfNullPtr();
+        return m_ptr;
+    }
+
+    explicit operator bool() const noexcept
+    {
+        return m_ptr != nullptr;
+    }
+
+    private:
+    void assertOwnerAlive() const noexcept
+    {
+#if SIA_CSP_CHECK_VIEW_LIFETIME
+        // Views made from raw pointers have no owner to check against.
+        //
+        const std::weak_ptr<const void> untracked{};
+        const bool tracked = m_owner.owner_before(untracked) || untracked.owner_before(m_owner);
+        assert((!tracked || !m_owner.expired()) && "checked_view outlived its owner");
+#endif
+    }
+
+    inline void throwIfNullPtr() const noexcept(CheckPolicy::is_noexcept)
+    {
+        assertOwnerAlive();
+        detail::checkNullPtr<CheckPolicy>(m_ptr);
+    }
+
+    element_type *m_ptr{nullptr};
+#if SIA_CSP_CHECK_VIEW_LIFETIME
+    std::weak_ptr<const void> m_owner{};
+#endif
+};
+
+#if !SIA_CSP_CHECK_VIEW_LIFETIME
+static_assert(std::is_trivially_copyable_v<checked_view<int>>);
+static_assert(sizeof(checked_view<int>) == sizeof(int *));
+#endif
+
+template <typename T, typename P>
+inline bool operator==(const checked_view<T, P> &lhs, std::nullptr_t) noexcept
+{
+    return !lhs;
+}
+
+template <typename T, typename P>
+inline bool operator==(std::nullptr_t, const checked_view<T, P> &lhs) noexcept
+{
+    return !lhs;
+}
+
+template <typename T, typename P, typename U, typename Q>
+inline bool operator==(const checked_view<T, P> &lhs, const checked_view<U, Q> &rhs) noexcept
+{
+    return lhs.get() == rhs.get();
+}
+
+template <typename T, typename P>
+inline bool operator!=(const checked_view<T, P> &lhs, std::nullptr_t) noexcept
+{
+    return static_cast<bool>(lhs);
+}
+
+template <typename T, typename P>
+inline bool operator!=(std::nullptr_t, const checked_view<T, P> &lhs) noexcept
+{
+    return static_cast<bool>(lhs);
+}
+
+template <typename T, typename P, typename U, typename Q>
+inline bool operator!=(const checked_view<T, P> &lhs, const checked_view<U, Q> &rhs) noexcept
+{
+    return lhs.get() != rhs.get();
+}
+
+template <typename T, typename P, typename U, typename Q>
+inline bool operator<(const checked_view<T, P> &lhs, const checked_view<U, Q> &rhs) noexcept
+{
+    using RsT = std::common_type_t<T *, U *>;
+    return std::less<RsT>()(lhs.get(), rhs.get());
+}
+
+template <typename Ch, typename Tr, typename Tp, typename P>
+inline std::basic_ostream<Ch, Tr> &operator<<(std::basic_ostream<Ch, Tr> &os, const checked_view<Tp, P> &p)
+{
+    os << p.get();
+    return os;
+}
+}  // namespace sia
+
+namespace std
+{
+template <typename _Tp, typename _Pp>
+struct hash<sia::checked_view<_Tp, _Pp>>
+{
+    size_t operator()(const sia::checked_view<_Tp, _Pp> &__s) const noexcept
+    {
+        return sia::detail::hashPointer(__s.get());
+    }
+};
+}  // namespace std
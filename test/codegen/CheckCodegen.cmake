@@ -0,0 +1,45 @@
+# Compiles NotNullCodegen.cpp to assembly and checks what became of the null checks. Run by ctest with COMPILER,
+# INCLUDE_DIR, SOURCE and PROCESSOR set.
+#
+execute_process(COMMAND ${COMPILER} -std=c++17 -O2 -S -I${INCLUDE_DIR} ${SOURCE} -o -
+                OUTPUT_VARIABLE ASSEMBLY
+                ERROR_VARIABLE ERRORS
+                RESULT_VARIABLE RESULT)
+
+if(NOT RESULT EQUAL 0)
+    message(FATAL_ERROR "Compiling ${SOURCE} failed:\n${ERRORS}")
+endif()
+
+# From the label of the function up to its .size directive, which also covers a .cold part split off by GCC.
+#
+function(function_body NAME OUT)
+    string(FIND "${ASSEMBLY}" "\n${NAME}:\n" BEGIN)
+    if(BEGIN EQUAL -1)
+        message(FATAL_ERROR "${NAME} is missing from the assembly")
+    endif()
+
+    string(SUBSTRING "${ASSEMBLY}" ${BEGIN} -1 REST)
+    string(FIND "${REST}" "\t.size\t${NAME}," END)
+    string(SUBSTRING "${REST}" 0 ${END} BODY)
+    set(${OUT} "${BODY}" PARENT_SCOPE)
+endfunction()
+
+function_body(readNullable NULLABLE)
+function_body(readNotNull NOT_NULL)
+function_body(readTested TESTED)
+
+# Makes sure the checks below would see a null check at all.
+#
+if(NOT NULLABLE MATCHES "onNullPtr")
+    message(FATAL_ERROR "The nullable pointer lost its null check, the codegen test cannot tell anything:\n${NULLABLE}")
+endif()
+
+foreach(BODY NOT_NULL TESTED)
+    if(${BODY} MATCHES "onNullPtr|__cxa_throw|CheckedNullPtrException")
+        message(FATAL_ERROR "Null check left in a not-null access:\n${${BODY}}")
+    endif()
+endforeach()
+
+if(PROCESSOR MATCHES "x86_64|AMD64" AND NOT_NULL MATCHES "\n\tj")
+    message(FATAL_ERROR "Branch left in the not-null operator->:\n${NOT_NULL}")
+endif()
@@ -0,0 +1,28 @@
+#include "checked_shared_ptr.hpp"
+
+// Compiled to assembly only, see CheckCodegen.cmake. The not-null accessors must come out as plain loads, while the
+// nullable one keeps its null check, which shows that the check would be visible.
+//
+
+struct Particle
+{
+    int m_x;
+};
+
+extern "C" int readNotNull(const sia::not_null_checked_shared_ptr<Particle, sia::throw_on_null> &particle)
+{
+    return particle->m_x;
+}
+
+extern "C" int readTested(const sia::checked_shared_ptr<Particle, sia::throw_on_null> &particle)
+{
+    if (auto tested = particle.try_non_null())
+        return (*tested)->m_x + (**tested).m_x;
+
+    return 0;
+}
+
+extern "C" int readNullable(const sia::checked_shared_ptr<Particle, sia::throw_on_null> &particle)
+{
+    return particle->m_x;
+}
@@ -0,0 +1,129 @@
+#include "atomic_checked_shared_ptr.hpp"
+#include <gtest/gtest.h>
+#include <thread>
+#include <vector>
+
+namespace
+{
+
+// Tracks the number of live instances so that the stress test can detect leaks and double frees.
+//
+struct Snapshot
+{
+    static inline std::atomic<std::int64_t> s_live{0};
+
+    explicit Snapshot(std::int64_t version) : m_version(version)
+    {
+        ++s_live;
+    }
+
+    ~Snapshot()
+    {
+        --s_live;
+    }
+
+    std::int64_t m_version{};
+};
+
+}  // namespace
+
+TEST(AtomicCheckedSharedPtr, LockFree)
+{
+    sia::atomic_checked_shared_ptr<Snapshot> slot{};
+    EXPECT_TRUE(slot.is_lock_free());
+}
+
+TEST(AtomicCheckedSharedPtr, LoadAndStore)
+{
+    sia::atomic_checked_shared_ptr<Snapshot> slot{};
+    EXPECT_TRUE(slot.load() == nullptr);
+
+    auto snapshot = sia::make_checked_shared<Snapshot>(1);
+    slot.store(snapshot);
+    EXPECT_EQ(slot.load(), snapshot);
+    EXPECT_EQ(snapshot.use_count(), 2);
+
+    slot = nullptr;
+    EXPECT_TRUE(slot.load() == nullptr);
+    EXPECT_EQ(snapshot.use_count(), 1);
+}
+
+TEST(AtomicCheckedSharedPtr, Exchange)
+{
+    auto snapshot1 = sia::make_checked_shared<Snapshot>(1);
+    auto snapshot2 = sia::make_checked_shared<Snapshot>(2);
+    sia::atomic_checked_shared_ptr<Snapshot> slot{snapshot1};
+
+    auto previous = slot.exchange(snapshot2);
+    EXPECT_EQ(previous, snapshot1);
+    EXPECT_EQ(snapshot1.use_count(), 2);
+
+    sia::checked_shared_ptr<Snapshot> current = slot;
+    EXPECT_EQ(current->m_version, 2);
+}
+
+TEST(AtomicCheckedSharedPtr, CompareExchange)
+{
+    auto snapshot1 = sia::make_checked_shared<Snapshot>(1);
+    auto snapshot2 = sia::make_checked_shared<Snapshot>(2);
+    sia::atomic_checked_shared_ptr<Snapshot> slot{snapshot1};
+
+    auto expected = snapshot2;
+    EXPECT_FALSE(slot.compare_exchange_strong(expected, sia::make_checked_shared<Snapshot>(3)));
+    EXPECT_EQ(expected, snapshot1);
+
+    EXPECT_TRUE(slot.compare_exchange_strong(expected, snapshot2));
+    EXPECT_EQ(slot.load(), snapshot2);
+
+    // Same address but a different owner is not equivalent.
+    //
+    sia::checked_shared_ptr<Snapshot> alias{std::shared_ptr<Snapshot>(std::shared_ptr<void>{}, snapshot2.get())};
+    EXPECT_FALSE(slot.compare_exchange_weak(alias, nullptr));
+    EXPECT_EQ(alias, snapshot2);
+    EXPECT_EQ(alias.use_count(), snapshot2.use_count());
+}
+
+TEST(AtomicCheckedSharedPtr, ManyReadersOneWriter)
+{
+    constexpr std::int64_t kVersions = 20000;
+
+    {
+        sia::atomic_checked_shared_ptr<Snapshot> slot{sia::make_checked_shared<Snapshot>(0)};
+        std::atomic<bool> done{false};
+        std::vector<std::thread> readers{};
+
+        for (int i = 0; i < 4; ++i)
+        {
+            readers.emplace_back([&slot, &done] {
+                std::int64_t last{};
+                while (!done.load())
+                {
+                    auto snapshot = slot.load();
+                    EXPECT_GE(snapshot->m_version, last);
+                    last = snapshot->m_version;
+                }
+            });
+        }
+
+        for (std::int64_t version = 1; version <= kVersions; ++version)
+        {
+            if (version % 2 == 0)
+            {
+                slot.store(sia::make_checked_shared<Snapshot>(version));
+            }
+            else
+            {
+                auto expected = slot.load();
+                EXPECT_TRUE(slot.compare_exchange_strong(expected, sia::make_checked_shared<Snapshot>(version)));
+            }
+        }
+
+        done = true;
+        for (auto &reader : readers)
+            reader.join();
+
+        EXPECT_EQ(slot.load()->m_version, kVersions);
+    }
+
+    EXPECT_EQ(Snapshot::s_live.load(), 0);
+}
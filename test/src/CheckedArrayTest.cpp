@@ -0,0 +1,240 @@
+#include "checked_shared_ptr.hpp"
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <limits>
+#include <new>
+#include <numeric>
+#include <string>
+
+namespace
+{
+
+struct Counted
+{
+    Counted()
+    {
+        ++s_alive;
+        if (s_throw_at != 0 && s_alive == s_throw_at)
+        {
+            --s_alive;
+            throw std::runtime_error("Counted");
+        }
+    }
+
+    Counted(const Counted &) = delete;
+    Counted &operator=(const Counted &) = delete;
+
+    ~Counted()
+    {
+        --s_alive;
+    }
+
+    std::int32_t m_value{7};
+
+    static inline std::int32_t s_alive{0};
+    static inline std::int32_t s_throw_at{0};
+};
+
+struct MessageHeader
+{
+    MessageHeader(std::uint32_t id, std::string topic) : m_id(id), m_topic(std::move(topic))
+    {
+    }
+
+    std::uint32_t m_id;
+    std::string m_topic;
+};
+
+struct alignas(64) Line
+{
+    std::uint8_t m_bytes[64]; //NOLINT(modernize-avoid-c-arrays)
+};
+
+using Message = sia::with_trailing<MessageHeader, std::uint8_t>;
+
+}  // namespace
+
+static_assert(sizeof(sia::checked_shared_ptr<std::int32_t[4]>) == sizeof(std::shared_ptr<std::int32_t[4]>));
+static_assert(sizeof(sia::checked_shared_ptr<std::int32_t[]>) ==
+              sizeof(std::shared_ptr<std::int32_t[]>) + sizeof(std::size_t));
+static_assert(noexcept(std::declval<sia::checked_shared_ptr<std::int32_t[], sia::abort_on_null> &>()[0]));
+
+TEST(CheckedArray, UnboundedIsValueInitialized)
+{
+    auto values = sia::make_checked_shared<std::int32_t[]>(16);
+
+    ASSERT_EQ(values.extent(), 16);
+    EXPECT_EQ(values.use_count(), 1);
+
+    for (std::ptrdiff_t i = 0; i < 16; ++i)
+        EXPECT_EQ(values[i], 0);
+
+    values[15] = 3;
+    EXPECT_EQ(values.get()[15], 3);
+}
+
+TEST(CheckedArray, UnboundedOutOfRange)
+{
+    auto values = sia::make_checked_shared<std::int32_t[]>(4);
+
+    EXPECT_THROW(values[4], sia::CheckedOutOfRangeException);
+    EXPECT_THROW(values[-1], sia::CheckedOutOfRangeException);
+    EXPECT_NO_THROW(values[3]);
+}
+
+TEST(CheckedArray, NullIndexIsNullCheck)
+{
+    sia::checked_shared_ptr<std::int32_t[]> values{};
+    EXPECT_THROW(values[0], sia::CheckedNullPtrException);
+
+    auto fixed = sia::make_checked_shared<std::int32_t[2]>();
+    fixed.reset();
+    EXPECT_THROW(fixed[0], sia::CheckedNullPtrException);
+}
+
+TEST(CheckedArray, Bounded)
+{
+    auto values = sia::make_checked_shared<std::int32_t[8]>();
+
+    static_assert(decltype(values)::extent() == 8);
+    for (std::ptrdiff_t i = 0; i < 8; ++i)
+        EXPECT_EQ(values[i], 0);
+
+    EXPECT_THROW(values[8], sia::CheckedOutOfRangeException);
+}
+
+TEST(CheckedArray, ExtentFollowsTheOwner)
+{
+    auto values = sia::make_checked_shared<std::int32_t[]>(3);
+
+    sia::checked_shared_ptr<std::int32_t[]> copy{values};
+    EXPECT_EQ(copy.extent(), 3);
+    EXPECT_THROW(copy[3], sia::CheckedOutOfRangeException);
+
+    sia::checked_shared_ptr<const std::int32_t[]> const_values{values};
+    EXPECT_EQ(const_values.extent(), 3);
+
+    sia::checked_shared_ptr<std::int32_t[]> other = sia::make_checked_shared<std::int32_t[]>(5);
+    other.swap(copy);
+    EXPECT_EQ(other.extent(), 3);
+    EXPECT_EQ(copy.extent(), 5);
+
+    sia::checked_shared_ptr<std::int32_t[]> moved{std::move(copy)};
+    EXPECT_EQ(moved.extent(), 5);
+
+    sia::checked_shared_ptr<const std::int32_t[]> assigned{};
+    assigned = moved;
+    EXPECT_EQ(assigned.extent(), 5);
+
+    sia::checked_shared_ptr<std::int32_t[]> from_fixed{sia::make_checked_shared<std::int32_t[4]>()};
+    EXPECT_EQ(from_fixed.extent(), 4);
+}
+
+TEST(CheckedArray, FreeSwapExchangesExtents)
+{
+    auto small = sia::make_checked_shared<std::int32_t[]>(2);
+    auto large = sia::make_checked_shared<std::int32_t[]>(100);
+    auto *small_data = small.get();
+
+    using std::swap;
+    swap(small, large);
+
+    EXPECT_EQ(large.get(), small_data);
+    EXPECT_EQ(small.extent(), 100);
+    EXPECT_EQ(large.extent(), 2);
+    EXPECT_NO_THROW(small[50] = 1);
+    EXPECT_THROW(large[50], sia::CheckedOutOfRangeException);
+}
+
+TEST(CheckedArray, UnknownExtent)
+{
+    sia::checked_shared_ptr<std::int32_t[]> values{std::shared_ptr<std::int32_t[]>(new std::int32_t[4]{1, 2, 3, 4})};
+
+    EXPECT_EQ(values.extent(), sia::detail::kUnknownExtent);
+    EXPECT_EQ(values[3], 4);
+    EXPECT_THROW(values[-1], sia::CheckedOutOfRangeException);
+}
+
+TEST(CheckedArray, ElementsAreDestroyed)
+{
+    {
+        auto values = sia::make_checked_shared<Counted[]>(5);
+        EXPECT_EQ(Counted::s_alive, 5);
+        EXPECT_EQ(values[4].m_value, 7);
+    }
+
+    EXPECT_EQ(Counted::s_alive, 0);
+
+    {
+        auto values = sia::make_checked_shared<Counted[3]>();
+        EXPECT_EQ(Counted::s_alive, 3);
+    }
+
+    EXPECT_EQ(Counted::s_alive, 0);
+}
+
+TEST(CheckedArray, ThrowingElementRollsBack)
+{
+    Counted::s_throw_at = 3;
+    EXPECT_THROW(sia::make_checked_shared<Counted[]>(5), std::runtime_error);
+    Counted::s_throw_at = 0;
+
+    EXPECT_EQ(Counted::s_alive, 0);
+}
+
+TEST(CheckedArray, SizeOverflowThrows)
+{
+    const std::size_t max = std::numeric_limits<std::size_t>::max();
+
+    // Both would wrap around to a small allocation if the byte count were computed unchecked.
+    //
+    EXPECT_THROW(sia::make_checked_shared<Counted[]>(max / sizeof(Counted) + 2), std::bad_array_new_length);
+    EXPECT_THROW(sia::make_checked_shared<Line[]>(max / sizeof(Line)), std::bad_array_new_length);
+    EXPECT_THROW((sia::make_checked_shared<sia::with_trailing<MessageHeader, Counted>>(max / 2, 1U, "huge")),
+                 std::bad_array_new_length);
+    EXPECT_EQ(Counted::s_alive, 0);
+}
+
+TEST(CheckedArray, OverAligned)
+{
+    auto lines = sia::make_checked_shared<Line[]>(3);
+
+    for (std::ptrdiff_t i = 0; i < 3; ++i)
+        EXPECT_EQ(reinterpret_cast<std::uintptr_t>(&lines[i]) % alignof(Line), 0);
+}
+
+TEST(CheckedArray, WithTrailing)
+{
+    auto message = sia::make_checked_shared<Message>(32, 9U, "orders");
+
+    EXPECT_EQ(message->m_id, 9U);
+    EXPECT_EQ(message->m_topic, "orders");
+    ASSERT_EQ(message->trailingSize(), 32);
+
+    std::iota(message->trailingBegin(), message->trailingEnd(), std::uint8_t{0});
+    EXPECT_EQ(message[31], 31);
+    EXPECT_THROW(message[32], sia::CheckedOutOfRangeException);
+
+    sia::checked_shared_ptr<MessageHeader> header{message};
+    EXPECT_EQ(header->m_topic, "orders");
+    EXPECT_EQ(message.use_count(), 2);
+}
+
+TEST(CheckedArray, WithTrailingDestroysElements)
+{
+    {
+        auto message = sia::make_checked_shared<sia::with_trailing<MessageHeader, Counted>>(4, 1U, "counted");
+        EXPECT_EQ(Counted::s_alive, 4);
+        EXPECT_EQ(message[0].m_value, 7);
+    }
+
+    EXPECT_EQ(Counted::s_alive, 0);
+}
+
+TEST(CheckedArray, OutOfRangePolicy)
+{
+    auto values = sia::make_checked_shared<std::int32_t[]>(1);
+    sia::checked_shared_ptr<std::int32_t[], sia::abort_on_null> aborting{values};
+
+    EXPECT_DEATH(aborting[1] = 0, "");
+}
@@ -0,0 +1,199 @@
+#include "checked_biased_ref_counter.hpp"
+#include <gtest/gtest.h>
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+namespace
+{
+
+struct Document : sia::checked_biased_ref_counter<Document>
+{
+    explicit Document(std::int32_t id = 0) : m_id(id)
+    {
+        s_alive.fetch_add(1);
+    }
+
+    Document(const Document &r) : sia::checked_biased_ref_counter<Document>(r), m_id(r.m_id)
+    {
+        s_alive.fetch_add(1);
+    }
+
+    ~Document()
+    {
+        s_alive.fetch_sub(1);
+    }
+
+    std::int32_t m_id;
+
+    static inline std::atomic<std::int32_t> s_alive{0};
+};
+
+using DocumentPtr = sia::checked_intrusive_ptr<Document>;
+
+}  // namespace
+
+TEST(CheckedBiasedRefCounter, OwnerThread)
+{
+    {
+        auto document = sia::make_checked_intrusive<Document>(1);
+        EXPECT_EQ(document.use_count(), 1);
+
+        {
+            DocumentPtr copy = document;
+            EXPECT_EQ(document.use_count(), 2);
+        }
+
+        EXPECT_EQ(document.use_count(), 1);
+
+        // A copied object has a count of its own.
+        //
+        auto clone = sia::make_checked_intrusive<Document>(*document);
+        EXPECT_EQ(clone.use_count(), 1);
+        EXPECT_EQ(Document::s_alive.load(), 2);
+    }
+
+    EXPECT_EQ(Document::s_alive.load(), 0);
+}
+
+TEST(CheckedBiasedRefCounter, NullCheck)
+{
+    DocumentPtr document{};
+    EXPECT_THROW((void)document->m_id, sia::CheckedNullPtrException);
+}
+
+TEST(CheckedBiasedRefCounter, ForeignCopies)
+{
+    auto document = sia::make_checked_intrusive<Document>(1);
+
+    std::thread(
+        [&document]
+        {
+            DocumentPtr copy = document;
+            EXPECT_EQ(copy.use_count(), 2);
+        })
+        .join();
+
+    EXPECT_EQ(document.use_count(), 1);
+    document.reset();
+    EXPECT_EQ(Document::s_alive.load(), 0);
+}
+
+TEST(CheckedBiasedRefCounter, LastReferenceDroppedByAnotherThread)
+{
+    auto document = sia::make_checked_intrusive<Document>(1);
+
+    // The owner's reference is released elsewhere, only the owner can tell that it was the last one.
+    //
+    std::thread([moved = std::move(document)]() mutable { moved.reset(); }).join();
+    EXPECT_EQ(Document::s_alive.load(), 1);
+
+    sia::merge_biased_refcounts();
+    EXPECT_EQ(Document::s_alive.load(), 0);
+}
+
+TEST(CheckedBiasedRefCounter, HandedBackWhileTheOwnerStillHoldsOne)
+{
+    auto document = sia::make_checked_intrusive<Document>(1);
+    DocumentPtr moved = document;
+
+    std::thread([moved = std::move(moved)]() mutable { moved.reset(); }).join();
+    EXPECT_EQ(document.use_count(), 2);
+
+    // Creating another object releases the handed back reference as well.
+    //
+    auto other = sia::make_checked_intrusive<Document>(2);
+    EXPECT_EQ(document.use_count(), 1);
+
+    document.reset();
+    other.reset();
+    EXPECT_EQ(Document::s_alive.load(), 0);
+}
+
+TEST(CheckedBiasedRefCounter, OwnerExits)
+{
+    DocumentPtr document{};
+
+    std::thread(
+        [&document]
+        {
+            document = sia::make_checked_intrusive<Document>(1);
+            DocumentPtr keep = document;
+        })
+        .join();
+
+    EXPECT_EQ(document.use_count(), 1);
+    DocumentPtr copy = document;
+    EXPECT_EQ(document.use_count(), 2);
+
+    document.reset();
+    copy.reset();
+    EXPECT_EQ(Document::s_alive.load(), 0);
+}
+
+TEST(CheckedBiasedRefCounter, QueuedReferenceReleasedOnExit)
+{
+    std::atomic<bool> released{false};
+    std::atomic<bool> handed_back{false};
+    DocumentPtr shared{};
+
+    std::thread owner(
+        [&]
+        {
+            shared = sia::make_checked_intrusive<Document>(1);
+            released.store(true);
+
+            while (!handed_back.load())
+                std::this_thread::yield();
+        });
+
+    while (!released.load())
+        std::this_thread::yield();
+
+    shared.reset();
+    handed_back.store(true);
+    owner.join();
+
+    EXPECT_EQ(Document::s_alive.load(), 0);
+}
+
+TEST(CheckedBiasedRefCounter, ManyThreads)
+{
+    constexpr std::int32_t kCopies = 20000;
+
+    {
+        auto document = sia::make_checked_intrusive<Document>(1);
+        std::vector<std::thread> threads{};
+
+        for (int t = 0; t < 4; ++t)
+        {
+            threads.emplace_back(
+                [document]
+                {
+                    std::vector<DocumentPtr> copies{};
+                    for (std::int32_t i = 0; i < kCopies; ++i)
+                    {
+                        copies.push_back(document);
+                        if (copies.size() == 16)
+                            copies.clear();
+                    }
+                });
+        }
+
+        for (std::int32_t i = 0; i < kCopies; ++i)
+        {
+            DocumentPtr copy = document;
+            EXPECT_EQ(copy->m_id, 1);
+        }
+
+        for (auto &thread : threads)
+            thread.join();
+
+        sia::merge_biased_refcounts();
+        EXPECT_EQ(document.use_count(), 1);
+    }
+
+    sia::merge_biased_refcounts();
+    EXPECT_EQ(Document::s_alive.load(), 0);
+}
@@ -0,0 +1,104 @@
+#include "checked_block_resource.hpp"
+#include "checked_shared_ptr.hpp"
+#include <gtest/gtest.h>
+#include <array>
+#include <vector>
+
+namespace
+{
+
+// Counts the allocations which reach the upstream resource.
+//
+class CountingResource : public std::pmr::memory_resource
+{
+    public:
+    std::size_t m_allocations{};
+    std::size_t m_deallocations{};
+
+    protected:
+    void *do_allocate(std::size_t bytes, std::size_t alignment) override
+    {
+        ++m_allocations;
+        return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+    }
+
+    void do_deallocate(void *ptr, std::size_t bytes, std::size_t alignment) override
+    {
+        ++m_deallocations;
+        std::pmr::new_delete_resource()->deallocate(ptr, bytes, alignment);
+    }
+
+    [[nodiscard]] bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override
+    {
+        return this == &other;
+    }
+};
+
+struct Request
+{
+    std::int64_t m_id{};
+    std::array<char, 40> m_payload{};
+};
+
+}  // namespace
+
+TEST(FixedBlockResource, ChunkedAllocation)
+{
+    CountingResource upstream{};
+    std::vector<sia::checked_shared_ptr<Request>> requests{};
+
+    {
+        sia::fixed_block_resource resource{16, &upstream};
+        std::pmr::polymorphic_allocator<Request> alloc{&resource};
+
+        for (std::int64_t i = 0; i < 32; ++i)
+            requests.push_back(sia::allocate_checked_shared<Request>(alloc, Request{i, {}}));
+
+        EXPECT_GE(resource.blockSize(), sizeof(Request));
+        EXPECT_EQ(upstream.m_allocations, 2);
+
+        for (std::int64_t i = 0; i < 32; ++i)
+            EXPECT_EQ(requests[static_cast<std::size_t>(i)]->m_id, i);
+
+        requests.clear();
+        EXPECT_EQ(upstream.m_deallocations, 0);
+    }
+
+    EXPECT_EQ(upstream.m_deallocations, 2);
+}
+
+TEST(FixedBlockResource, BlocksAreRecycled)
+{
+    CountingResource upstream{};
+    sia::fixed_block_resource resource{4, &upstream};
+    std::pmr::polymorphic_allocator<Request> alloc{&resource};
+
+    auto c_ptr = sia::allocate_checked_shared<Request>(alloc);
+    auto *raw = c_ptr.get();
+    c_ptr = nullptr;
+
+    c_ptr = sia::allocate_checked_shared<Request>(alloc);
+    EXPECT_EQ(c_ptr.get(), raw);
+    EXPECT_EQ(upstream.m_allocations, 1);
+}
+
+TEST(FixedBlockResource, OtherSizesGoUpstream)
+{
+    CountingResource upstream{};
+    sia::fixed_block_resource resource{4, &upstream};
+
+    void *block = resource.allocate(64, alignof(std::max_align_t));
+    EXPECT_EQ(upstream.m_allocations, 1);
+
+    void *large = resource.allocate(4096, alignof(std::max_align_t));
+    EXPECT_EQ(upstream.m_allocations, 2);
+
+    resource.deallocate(large, 4096, alignof(std::max_align_t));
+    EXPECT_EQ(upstream.m_deallocations, 1);
+
+    resource.deallocate(block, 64, alignof(std::max_align_t));
+    EXPECT_EQ(upstream.m_deallocations, 1);
+
+    resource.release();
+    EXPECT_EQ(upstream.m_deallocations, 2);
+}
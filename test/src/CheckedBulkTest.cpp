@@ -0,0 +1,208 @@
+#include "checked_bulk.hpp"
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+struct Node : sia::checked_intrusive_ref_counter<Node>
+{
+    explicit Node(std::int32_t id = 0) : m_id(id)
+    {
+        ++s_alive;
+    }
+
+    ~Node()
+    {
+        --s_alive;
+    }
+
+    std::int32_t m_id;
+
+    static inline std::int32_t s_alive{0};
+};
+
+// Counted through the single reference ADL hooks only, the bulk operations have to fall back to them.
+//
+struct Legacy
+{
+    std::int64_t m_count{0};
+    std::int64_t m_calls{0};
+};
+
+void checkedIntrusiveAddRef(const Legacy *ptr) noexcept
+{
+    auto *legacy = const_cast<Legacy *>(ptr);
+    ++legacy->m_count;
+    ++legacy->m_calls;
+}
+
+void checkedIntrusiveRelease(const Legacy *ptr) noexcept
+{
+    auto *legacy = const_cast<Legacy *>(ptr);
+    --legacy->m_count;
+    ++legacy->m_calls;
+}
+
+// Raw storage for n objects of type T.
+//
+template <typename T>
+struct Storage
+{
+    explicit Storage(std::size_t n) : m_bytes(std::make_unique<std::byte[]>(n * sizeof(T))) //NOLINT(modernize-avoid-c-arrays)
+    {
+    }
+
+    T *data() noexcept
+    {
+        return reinterpret_cast<T *>(m_bytes.get());
+    }
+
+    std::unique_ptr<std::byte[]> m_bytes; //NOLINT(modernize-avoid-c-arrays)
+};
+
+}  // namespace
+
+static_assert(sia::is_trivially_relocatable_v<sia::checked_shared_ptr<std::string>>);
+static_assert(sia::is_trivially_relocatable_v<sia::checked_intrusive_ptr<Node>>);
+static_assert(sia::is_trivially_relocatable_v<std::int32_t>);
+static_assert(!sia::is_trivially_relocatable_v<std::string>);
+static_assert(!sia::detail::has_intrusive_bulk_refs<Legacy>::value);
+static_assert(sia::detail::has_intrusive_bulk_refs<Node>::value);
+
+TEST(CheckedBulk, FindFirstNull)
+{
+    std::vector<sia::checked_shared_ptr<std::int32_t>> values{};
+    for (std::int32_t i = 0; i < 37; ++i)
+        values.push_back(sia::make_checked_shared<std::int32_t>(i));
+
+    const auto *first = values.data();
+    const auto *last = values.data() + values.size();
+
+    EXPECT_EQ(sia::find_first_null(first, last), last);
+    EXPECT_TRUE(sia::all_non_null(first, last));
+    EXPECT_TRUE(sia::all_non_null(first, first));
+
+    for (std::size_t null_at : {std::size_t{36}, std::size_t{17}, std::size_t{8}, std::size_t{0}})
+    {
+        values[null_at] = nullptr;
+        EXPECT_EQ(sia::find_first_null(first, last), first + null_at);
+        EXPECT_FALSE(sia::all_non_null(first, last));
+    }
+}
+
+TEST(CheckedBulk, FindFirstNullIntrusive)
+{
+    std::vector<sia::checked_intrusive_ptr<Node>> nodes(20, sia::make_checked_intrusive<Node>());
+    nodes[13].reset();
+
+    EXPECT_EQ(sia::find_first_null(nodes.data(), nodes.data() + nodes.size()), nodes.data() + 13);
+}
+
+TEST(CheckedBulk, RelocateCheckedSharedPtr)
+{
+    constexpr std::size_t kCount = 16;
+    auto shared = sia::make_checked_shared<std::string>("shared");
+    auto extent = sia::make_checked_shared<std::int32_t[]>(3);
+
+    Storage<sia::checked_shared_ptr<std::string>> from{kCount};
+    Storage<sia::checked_shared_ptr<std::string>> to{kCount};
+    std::uninitialized_fill_n(from.data(), kCount, shared);
+    EXPECT_EQ(shared.use_count(), kCount + 1);
+
+    auto *end = sia::uninitialized_relocate(from.data(), from.data() + kCount, to.data());
+    EXPECT_EQ(end, to.data() + kCount);
+    EXPECT_EQ(shared.use_count(), kCount + 1);
+    EXPECT_EQ(*to.data()[kCount - 1], "shared");
+
+    std::destroy(to.data(), end);
+    EXPECT_EQ(shared.use_count(), 1);
+
+    Storage<sia::checked_shared_ptr<std::int32_t[]>> array_from{1};
+    Storage<sia::checked_shared_ptr<std::int32_t[]>> array_to{1};
+    ::new (static_cast<void *>(array_from.data())) sia::checked_shared_ptr<std::int32_t[]>(extent);
+    sia::uninitialized_relocate(array_from.data(), array_from.data() + 1, array_to.data());
+    EXPECT_EQ(array_to.data()->extent(), 3);
+    std::destroy_at(array_to.data());
+}
+
+TEST(CheckedBulk, RelocateFallsBackToMove)
+{
+    Storage<std::string> from{2};
+    Storage<std::string> to{2};
+    ::new (static_cast<void *>(from.data())) std::string(64, 'a');
+    ::new (static_cast<void *>(from.data() + 1)) std::string("b");
+
+    sia::uninitialized_relocate(from.data(), from.data() + 2, to.data());
+    EXPECT_EQ(to.data()[0], std::string(64, 'a'));
+    EXPECT_EQ(to.data()[1], "b");
+    std::destroy(to.data(), to.data() + 2);
+}
+
+TEST(CheckedBulk, CoalescedCopyAndDestroy)
+{
+    auto first = sia::make_checked_intrusive<Node>(1);
+    auto second = sia::make_checked_intrusive<Node>(2);
+
+    std::vector<sia::checked_intrusive_ptr<Node>> nodes{first, first, first, nullptr, second, second, first};
+    EXPECT_EQ(first.use_count(), 5);
+
+    Storage<sia::checked_intrusive_ptr<Node>> copies{nodes.size()};
+    auto *end = sia::uninitialized_copy_coalesced(nodes.data(), nodes.data() + nodes.size(), copies.data());
+
+    ASSERT_EQ(end, copies.data() + nodes.size());
+    EXPECT_EQ(first.use_count(), 9);
+    EXPECT_EQ(second.use_count(), 5);
+    for (std::size_t i = 0; i < nodes.size(); ++i)
+        EXPECT_EQ(copies.data()[i], nodes[i]);
+
+    sia::destroy_coalesced(copies.data(), end);
+    EXPECT_EQ(first.use_count(), 5);
+    EXPECT_EQ(second.use_count(), 3);
+
+    nodes.clear();
+    first.reset();
+    second.reset();
+    EXPECT_EQ(Node::s_alive, 0);
+}
+
+TEST(CheckedBulk, CoalescedDestroyReleasesTheLastReference)
+{
+    Storage<sia::checked_intrusive_ptr<Node>> nodes{8};
+    std::uninitialized_fill_n(nodes.data(), 8, sia::make_checked_intrusive<Node>());
+    EXPECT_EQ(nodes.data()->use_count(), 8);
+
+    sia::destroy_coalesced(nodes.data(), nodes.data() + 8);
+    EXPECT_EQ(Node::s_alive, 0);
+}
+
+TEST(CheckedBulk, CoalescedFallsBackToSingleReferences)
+{
+    Legacy legacy{};
+    std::vector<sia::checked_intrusive_ptr<Legacy>> handles(4, sia::checked_intrusive_ptr<Legacy>(&legacy));
+    legacy.m_calls = 0;
+
+    Storage<sia::checked_intrusive_ptr<Legacy>> copies{4};
+    sia::uninitialized_copy_coalesced(handles.data(), handles.data() + 4, copies.data());
+    EXPECT_EQ(legacy.m_count, 8);
+    EXPECT_EQ(legacy.m_calls, 4);
+
+    sia::destroy_coalesced(copies.data(), copies.data() + 4);
+    EXPECT_EQ(legacy.m_count, 4);
+}
+
+TEST(CheckedBulk, CoalescedCheckedSharedPtrCopiesOneByOne)
+{
+    auto shared = sia::make_checked_shared<std::int32_t>(1);
+    std::vector<sia::checked_shared_ptr<std::int32_t>> handles(4, shared);
+
+    Storage<sia::checked_shared_ptr<std::int32_t>> copies{4};
+    sia::uninitialized_copy_coalesced(handles.data(), handles.data() + 4, copies.data());
+    EXPECT_EQ(shared.use_count(), 9);
+
+    sia::destroy_coalesced(copies.data(), copies.data() + 4);
+    EXPECT_EQ(shared.use_count(), 5);
+}
@@ -0,0 +1,307 @@
+#include "checked_coroutine.hpp"
+#include <gtest/gtest.h>
+
+// Built as C++20, see test/CMakeLists.txt.
+//
+#if defined(__cpp_impl_coroutine) && __has_include(<coroutine>)
+
+#include <cstdint>
+#include <exception>
+#include <memory_resource>
+#include <string>
+
+namespace
+{
+
+// Starts eagerly and keeps its frame until destroyed, so that the tests can look at the outcome.
+//
+struct Task
+{
+    struct promise_type : sia::checked_frame_allocation //NOLINT(readability-identifier-naming)
+    {
+        Task get_return_object() noexcept //NOLINT(readability-identifier-naming)
+        {
+            return Task{std::coroutine_handle<promise_type>::from_promise(*this)};
+        }
+
+        std::suspend_never initial_suspend() noexcept //NOLINT(readability-identifier-naming)
+        {
+            return {};
+        }
+
+        std::suspend_always final_suspend() noexcept //NOLINT(readability-identifier-naming)
+        {
+            return {};
+        }
+
+        void return_void() noexcept //NOLINT(readability-identifier-naming)
+        {
+        }
+
+        void unhandled_exception() noexcept //NOLINT(readability-identifier-naming)
+        {
+            m_exception = std::current_exception();
+        }
+
+        std::exception_ptr m_exception{};
+    };
+
+    explicit Task(std::coroutine_handle<promise_type> handle) noexcept : m_handle(handle)
+    {
+    }
+
+    Task(Task &&r) noexcept : m_handle(std::exchange(r.m_handle, nullptr))
+    {
+    }
+
+    ~Task()
+    {
+        if (m_handle)
+            m_handle.destroy();
+    }
+
+    [[nodiscard]] bool done() const noexcept
+    {
+        return m_handle.done();
+    }
+
+    [[nodiscard]] std::exception_ptr exception() const noexcept
+    {
+        return m_handle.promise().m_exception;
+    }
+
+    std::coroutine_handle<promise_type> m_handle;
+};
+
+// Suspends until fire() is called.
+//
+struct Event
+{
+    bool await_ready() const noexcept //NOLINT(readability-identifier-naming)
+    {
+        return false;
+    }
+
+    void await_suspend(std::coroutine_handle<> handle) noexcept //NOLINT(readability-identifier-naming)
+    {
+        m_waiter = handle;
+    }
+
+    std::int32_t await_resume() const noexcept //NOLINT(readability-identifier-naming)
+    {
+        return m_value;
+    }
+
+    void fire(std::int32_t value = 0)
+    {
+        m_value = value;
+        std::exchange(m_waiter, nullptr).resume();
+    }
+
+    std::coroutine_handle<> m_waiter{};
+    std::int32_t m_value{};
+};
+
+// Awaitable with an operator co_await, checked_resume must use the awaiter it returns.
+//
+struct Deferred
+{
+    Event &m_event;
+
+    Event &operator co_await() const noexcept
+    {
+        return m_event;
+    }
+};
+
+// GCC 12 pairs the templated operator new of checked_frame_allocation with its usual operator delete and warns at
+// every coroutine below.
+//
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+struct Session : std::enable_shared_from_this<Session>
+{
+    Task run(Event &event)
+    {
+        auto self = co_await sia::keep_alive(this);
+        m_use_count_inside = self.use_count();
+
+        co_await event;
+        m_messages += 1;
+    }
+
+    std::int64_t m_use_count_inside{};
+    std::int32_t m_messages{};
+};
+
+struct Connection
+{
+    std::string m_peer{"peer"};
+};
+
+Task receive(const sia::checked_shared_ptr<Connection> &connection, Event &event, std::int32_t &received)
+{
+    received = co_await sia::checked_resume(connection, event);
+    received += static_cast<std::int32_t>(connection->m_peer.size());
+}
+
+Task receiveDeferred(const sia::checked_shared_ptr<Connection> &connection, Event &event, std::int32_t &received)
+{
+    received = co_await sia::checked_resume(connection, Deferred{event});
+}
+
+Task inArena(std::allocator_arg_t /*tag*/, std::pmr::memory_resource * /*resource*/,
+             sia::checked_shared_ptr<Connection> connection, Event &event)
+{
+    co_await event;
+    connection->m_peer = "done";
+}
+
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+// Counts the bytes which are currently allocated from it.
+//
+class CountingResource : public std::pmr::memory_resource
+{
+    public:
+    std::size_t m_in_use{0};
+    std::size_t m_allocations{0};
+
+    protected:
+    void *do_allocate(std::size_t bytes, std::size_t alignment) override
+    {
+        m_in_use += bytes;
+        ++m_allocations;
+        return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+    }
+
+    void do_deallocate(void *ptr, std::size_t bytes, std::size_t alignment) override
+    {
+        m_in_use -= bytes;
+        std::pmr::new_delete_resource()->deallocate(ptr, bytes, alignment);
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override
+    {
+        return this == &other;
+    }
+};
+
+}  // namespace
+
+TEST(CheckedCoroutine, KeepAlivePinsTheObject)
+{
+    Event event{};
+    auto session = sia::make_checked_shared<Session>();
+    std::weak_ptr<Session> observer = session.managedSharedPointer();
+
+    {
+        Task task = session->run(event);
+        EXPECT_EQ(session->m_use_count_inside, 2);
+        EXPECT_EQ(session.use_count(), 2);
+
+        // The last outside owner is gone, the coroutine still keeps the session alive.
+        //
+        session = nullptr;
+        EXPECT_FALSE(observer.expired());
+        EXPECT_EQ(observer.lock()->m_messages, 0);
+
+        // The pin goes away with the locals of the coroutine, before its final suspend point.
+        //
+        event.fire();
+        EXPECT_TRUE(task.done());
+        EXPECT_TRUE(observer.expired());
+    }
+}
+
+TEST(CheckedCoroutine, KeepAliveOfAnOwner)
+{
+    auto session = sia::make_checked_shared<Session>();
+
+    auto awaiter = sia::keep_alive(session);
+    EXPECT_TRUE(awaiter.await_ready());
+    EXPECT_EQ(session.use_count(), 2);
+
+    auto moved = sia::keep_alive(std::move(session)).await_resume();
+    EXPECT_EQ(moved.use_count(), 2);
+
+    Session *null_session = nullptr;
+    EXPECT_THROW((void)sia::keep_alive(null_session), sia::CheckedNullPtrException);
+}
+
+TEST(CheckedCoroutine, CheckedResume)
+{
+    Event event{};
+    std::int32_t received = 0;
+    auto connection = sia::make_checked_shared<Connection>();
+
+    {
+        Task task = receive(connection, event, received);
+        EXPECT_FALSE(task.done());
+
+        event.fire(10);
+        EXPECT_TRUE(task.done());
+        EXPECT_EQ(task.exception(), nullptr);
+        EXPECT_EQ(received, 14);
+    }
+
+    {
+        Task task = receive(connection, event, received);
+        connection = nullptr;
+
+        event.fire(20);
+        ASSERT_TRUE(task.done());
+        EXPECT_THROW(std::rethrow_exception(task.exception()), sia::CheckedNullPtrException);
+    }
+
+    {
+        connection = sia::make_checked_shared<Connection>();
+        Task task = receiveDeferred(connection, event, received);
+
+        event.fire(30);
+        EXPECT_TRUE(task.done());
+        EXPECT_EQ(received, 30);
+    }
+}
+
+TEST(CheckedCoroutine, FrameFromArena)
+{
+    CountingResource arena{};
+    Event event{};
+    std::pmr::polymorphic_allocator<Connection> alloc{&arena};
+
+    auto connection = sia::allocate_checked_shared<Connection>(alloc);
+    const std::size_t object_bytes = arena.m_in_use;
+
+    {
+        Task task = inArena(std::allocator_arg, &arena, connection, event);
+        EXPECT_EQ(arena.m_allocations, 2);
+        EXPECT_GT(arena.m_in_use, object_bytes);
+
+        event.fire();
+        EXPECT_EQ(connection->m_peer, "done");
+    }
+
+    EXPECT_EQ(arena.m_in_use, object_bytes);
+
+    connection = nullptr;
+    EXPECT_EQ(arena.m_in_use, 0);
+}
+
+TEST(CheckedCoroutine, FrameFromGlobalNew)
+{
+    Event event{};
+    std::int32_t received = 0;
+    auto connection = sia::make_checked_shared<Connection>();
+
+    Task task = receive(connection, event, received);
+    event.fire(1);
+    EXPECT_TRUE(task.done());
+}
+
+#endif
@@ -0,0 +1,229 @@
+#include "checked_deferred_reclaim.hpp"
+#include <gtest/gtest.h>
+#include <thread>
+#include <vector>
+
+namespace
+{
+
+std::atomic<std::int32_t> g_destroyed{0};
+
+struct TreeNode
+{
+    explicit TreeNode(std::int32_t id = 0) : m_id(id)
+    {
+    }
+
+    TreeNode(const TreeNode &) = delete;
+    TreeNode &operator=(const TreeNode &) = delete;
+
+    ~TreeNode()
+    {
+        ++g_destroyed;
+    }
+
+    std::int32_t m_id;
+    std::vector<sia::checked_shared_ptr<TreeNode>> m_children{};
+};
+
+// Stops the queue it is reclaimed by, from the background thread of that queue.
+//
+struct QueueStopper
+{
+    explicit QueueStopper(sia::reclamation_queue &queue) : m_queue(queue)
+    {
+    }
+
+    QueueStopper(const QueueStopper &) = delete;
+    QueueStopper &operator=(const QueueStopper &) = delete;
+
+    ~QueueStopper()
+    {
+        m_queue.stop();
+        ++g_destroyed;
+    }
+
+    sia::reclamation_queue &m_queue;
+};
+
+sia::checked_shared_ptr<TreeNode> makeTree(sia::deferred_reclaim_t reclaim, std::int32_t depth)
+{
+    auto node = sia::make_checked_shared<TreeNode>(reclaim, depth);
+
+    if (depth > 0)
+    {
+        node->m_children.push_back(makeTree(reclaim, depth - 1));
+        node->m_children.push_back(makeTree(reclaim, depth - 1));
+    }
+
+    return node;
+}
+
+class CheckedDeferredReclaim : public ::testing::Test
+{
+    protected:
+    void SetUp() override
+    {
+        sia::reclamation_queue::threadBatch()->flush();
+        g_destroyed = 0;
+    }
+};
+
+}  // namespace
+
+TEST_F(CheckedDeferredReclaim, ThreadBatchDefersUntilFlush)
+{
+    auto c_ptr = sia::make_checked_shared<TreeNode>(sia::reclaim_at_safe_point, 7);
+    static_assert(std::is_same_v<decltype(c_ptr), sia::checked_shared_ptr<TreeNode>>);
+    EXPECT_EQ(c_ptr->m_id, 7);
+
+    sia::checked_weak_ptr<TreeNode> w_ptr{c_ptr};
+    c_ptr = nullptr;
+
+    EXPECT_TRUE(w_ptr.expired());
+    EXPECT_EQ(g_destroyed, 0);
+    EXPECT_EQ(sia::reclamation_queue::threadBatch()->size(), 1);
+
+    EXPECT_EQ(sia::reclamation_queue::threadBatch()->flush(), 1);
+    EXPECT_EQ(g_destroyed, 1);
+    EXPECT_EQ(sia::reclamation_queue::threadBatch()->size(), 0);
+}
+
+TEST_F(CheckedDeferredReclaim, FlushTearsDownWholeTree)
+{
+    auto root = makeTree(sia::reclaim_at_safe_point, 10);
+    root.reset();
+
+    // Only the root is queued, its children are retired while it is being destroyed.
+    //
+    EXPECT_EQ(sia::reclamation_queue::threadBatch()->size(), 1);
+    EXPECT_EQ(sia::reclamation_queue::threadBatch()->flush(), 2047);
+    EXPECT_EQ(g_destroyed, 2047);
+}
+
+TEST_F(CheckedDeferredReclaim, CapacityBoundsTheQueue)
+{
+    sia::reclamation_queue queue{2};
+
+    for (std::int32_t i = 0; i < 3; ++i)
+        sia::make_checked_shared<TreeNode>(sia::reclaim_on(queue), i);
+
+    EXPECT_EQ(queue.size(), 2);
+    EXPECT_EQ(queue.overflows(), 1);
+    EXPECT_EQ(g_destroyed, 1);
+
+    queue.setCapacity(8);
+    sia::make_checked_shared<TreeNode>(sia::reclaim_on(queue));
+    EXPECT_EQ(queue.size(), 3);
+
+    EXPECT_EQ(queue.flush(), 3);
+    EXPECT_EQ(g_destroyed, 4);
+}
+
+TEST_F(CheckedDeferredReclaim, DestructorFlushes)
+{
+    {
+        sia::reclamation_queue queue{};
+        sia::make_checked_shared<TreeNode>(sia::reclaim_on(queue));
+        EXPECT_EQ(g_destroyed, 0);
+    }
+
+    EXPECT_EQ(g_destroyed, 1);
+}
+
+TEST_F(CheckedDeferredReclaim, BackgroundThread)
+{
+    sia::reclamation_queue queue{};
+    queue.start(std::chrono::microseconds(100));
+
+    auto root = makeTree(sia::reclaim_on(queue), 6);
+    root = nullptr;
+
+    for (int i = 0; i < 1000 && g_destroyed != 127; ++i)
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+    EXPECT_EQ(g_destroyed, 127);
+
+    queue.stop();
+    sia::make_checked_shared<TreeNode>(sia::reclaim_on(queue));
+    EXPECT_EQ(g_destroyed, 128);
+}
+
+TEST_F(CheckedDeferredReclaim, StopFromTheBackgroundThread)
+{
+    sia::reclamation_queue queue{};
+
+    for (std::int32_t round = 1; round <= 2; ++round)
+    {
+        queue.start(std::chrono::microseconds(100));
+        sia::make_checked_shared<QueueStopper>(sia::reclaim_on(queue), queue);
+
+        for (int i = 0; i < 1000 && g_destroyed != round; ++i)
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+        EXPECT_EQ(g_destroyed, round);
+    }
+
+    // Stopped by the second stopper, objects are destroyed inline again.
+    //
+    sia::make_checked_shared<TreeNode>(sia::reclaim_on(queue));
+    EXPECT_EQ(g_destroyed, 3);
+}
+
+// A release which passed the closed check before stop() must not stay queued after it.
+//
+TEST_F(CheckedDeferredReclaim, RetireRacingStop)
+{
+    constexpr std::int32_t kThreads = 4;
+    constexpr std::int32_t kObjects = 1000;
+
+    sia::reclamation_queue queue{};
+    std::vector<std::thread> threads{};
+
+    for (std::int32_t t = 0; t < kThreads; ++t)
+    {
+        threads.emplace_back(
+            [&queue]
+            {
+                for (std::int32_t i = 0; i < kObjects; ++i)
+                    sia::make_checked_shared<TreeNode>(sia::reclaim_on(queue));
+            });
+    }
+
+    queue.stop();
+
+    for (auto &thread : threads)
+        thread.join();
+
+    EXPECT_EQ(queue.size(), 0);
+    EXPECT_EQ(g_destroyed, kThreads * kObjects);
+}
+
+TEST_F(CheckedDeferredReclaim, ProcessWideBackgroundQueue)
+{
+    sia::make_checked_shared<TreeNode>(sia::reclaim_in_background());
+
+    for (int i = 0; i < 1000 && g_destroyed != 1; ++i)
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+    EXPECT_EQ(g_destroyed, 1);
+}
+
+TEST_F(CheckedDeferredReclaim, ReleasingThreadOwnsTheBatch)
+{
+    auto c_ptr = sia::make_checked_shared<TreeNode>(sia::reclaim_at_safe_point);
+
+    std::thread(
+        [c_ptr = std::move(c_ptr)]() mutable
+        {
+            c_ptr.reset();
+            EXPECT_EQ(sia::reclamation_queue::threadBatch()->size(), 1);
+            EXPECT_EQ(g_destroyed, 0);
+        })
+        .join();
+
+    // Flushed when the thread exited.
+    //
+    EXPECT_EQ(g_destroyed, 1);
+    EXPECT_EQ(sia::reclamation_queue::threadBatch()->size(), 0);
+}
@@ -0,0 +1,122 @@
+#include "checked_intrusive_ptr.hpp"
+#include "checked_shared_ptr.hpp"
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <map>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace
+{
+
+struct Session
+{
+    std::string m_user{};
+};
+
+struct Node : sia::checked_intrusive_ref_counter<Node>
+{
+};
+
+}  // namespace
+
+TEST(CheckedHash, StdHashMixesTheAddress)
+{
+    auto session = sia::make_checked_shared<Session>();
+    const std::size_t hash = std::hash<sia::checked_shared_ptr<Session>>()(session);
+
+    EXPECT_EQ(hash, sia::detail::hashPointer(session.get()));
+    EXPECT_EQ(hash, std::hash<sia::not_null_checked_shared_ptr<Session>>()(session.non_null()));
+    EXPECT_NE(hash, std::hash<Session *>()(session.get()));
+}
+
+TEST(CheckedHash, LowBitsAreSpread)
+{
+    // 16-byte aligned addresses, which leave the low four bits of an identity hash at zero.
+    //
+    constexpr std::size_t kBuckets = 64;
+    std::set<std::size_t> buckets{};
+
+    for (std::uintptr_t i = 1; i <= kBuckets; ++i)
+        buckets.insert(sia::detail::hashPointer(reinterpret_cast<const void *>(i * 16)) % kBuckets); //NOLINT(performance-no-int-to-ptr)
+
+    EXPECT_GT(buckets.size(), kBuckets / 2);
+}
+
+TEST(CheckedHash, TransparentFunctorsAgree)
+{
+    auto session = sia::make_checked_shared<Session>();
+    std::shared_ptr<Session> shared = session.managedSharedPointer();
+    Session *raw = session.get();
+
+    const sia::checked_ptr_hash hash{};
+    EXPECT_EQ(hash(session), hash(raw));
+    EXPECT_EQ(hash(session), hash(shared));
+    EXPECT_EQ(hash(session), hash(static_cast<const Session *>(raw)));
+    EXPECT_EQ(hash(sia::checked_shared_ptr<Session>{}), hash(nullptr));
+
+    const sia::checked_ptr_equal equal{};
+    EXPECT_TRUE(equal(session, raw));
+    EXPECT_TRUE(equal(shared, session));
+    EXPECT_FALSE(equal(session, nullptr));
+    EXPECT_TRUE(equal(sia::checked_shared_ptr<Session>{}, nullptr));
+
+    auto node = sia::make_checked_intrusive<Node>();
+    EXPECT_EQ(hash(node), hash(node.get()));
+    EXPECT_TRUE(equal(node, node.get()));
+}
+
+TEST(CheckedHash, OrderedLookupWithoutRefcount)
+{
+    std::vector<sia::checked_shared_ptr<Session>> sessions{};
+    std::map<sia::checked_shared_ptr<Session>, std::int32_t, sia::checked_ptr_less> ids{};
+
+    for (std::int32_t i = 0; i < 16; ++i)
+    {
+        sessions.push_back(sia::make_checked_shared<Session>());
+        ids.emplace(sessions.back(), i);
+    }
+
+    for (std::int32_t i = 0; i < 16; ++i)
+    {
+        Session *raw = sessions[i].get();
+        auto found = ids.find(raw);
+
+        ASSERT_NE(found, ids.end());
+        EXPECT_EQ(found->second, i);
+        EXPECT_EQ(sessions[i].use_count(), 2);
+    }
+
+    Session other{};
+    EXPECT_EQ(ids.find(&other), ids.end());
+    EXPECT_EQ(ids.count(sessions[3].managedSharedPointer()), 1);
+}
+
+TEST(CheckedHash, UnorderedContainers)
+{
+    std::unordered_map<sia::checked_shared_ptr<Session>, std::int32_t, sia::checked_ptr_hash, sia::checked_ptr_equal>
+        ids{};
+    std::unordered_set<sia::checked_shared_ptr<Session>> plain{};
+    std::vector<sia::checked_shared_ptr<Session>> sessions{};
+
+    for (std::int32_t i = 0; i < 100; ++i)
+    {
+        sessions.push_back(sia::make_checked_shared<Session>());
+        ids.emplace(sessions.back(), i);
+        plain.insert(sessions.back());
+    }
+
+    for (std::int32_t i = 0; i < 100; ++i)
+    {
+        EXPECT_EQ(ids.at(sessions[i]), i);
+        EXPECT_EQ(plain.count(sessions[i]), 1);
+    }
+
+#if defined(__cpp_lib_generic_unordered_lookup)
+    EXPECT_EQ(ids.find(sessions[7].get())->second, 7);
+    EXPECT_EQ(sessions[7].use_count(), 3);
+#endif
+}
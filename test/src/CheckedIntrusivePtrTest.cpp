@@ -0,0 +1,192 @@
+#include "checked_intrusive_ptr.hpp"
+#include <gtest/gtest.h>
+#include <unordered_set>
+
+namespace
+{
+
+struct Node : sia::checked_intrusive_ref_counter<Node>
+{
+    Node() = default;
+
+    explicit Node(std::int32_t id) : m_id(id)
+    {
+    }
+
+    virtual ~Node() = default;
+
+    std::int32_t m_id{};
+};
+
+struct LeafNode final : Node
+{
+    using Node::Node;
+
+    std::string m_name{};
+};
+
+struct BranchNode final : Node
+{
+};
+
+struct DestructionCounter : sia::checked_intrusive_ref_counter<DestructionCounter>
+{
+    explicit DestructionCounter(std::int32_t &counter) : m_counter(counter)
+    {
+    }
+
+    ~DestructionCounter()
+    {
+        ++m_counter;
+    }
+
+    std::int32_t &m_counter;
+};
+
+}  // namespace
+
+TEST(CheckedIntrusivePtr, SingleWord)
+{
+    static_assert(sizeof(sia::checked_intrusive_ptr<Node>) == sizeof(void *));
+    static_assert(sizeof(sia::checked_intrusive_ptr<Node, sia::unchecked>) == sizeof(void *));
+}
+
+TEST(CheckedIntrusivePtr, DefaultCtor)
+{
+    sia::checked_intrusive_ptr<Node> c_ptr{};
+    EXPECT_TRUE(c_ptr.get() == nullptr);
+    EXPECT_EQ(c_ptr.use_count(), 0);
+}
+
+TEST(CheckedIntrusivePtr, CtorWithRawPtr)
+{
+    auto *raw = new Node(7);
+    sia::checked_intrusive_ptr<Node> c_ptr{raw};
+
+    EXPECT_TRUE(c_ptr.get() == raw);
+    EXPECT_EQ(c_ptr.use_count(), 1);
+
+    // The count lives in the object, so a second pointer made from the same raw pointer shares it.
+    //
+    sia::checked_intrusive_ptr<Node> c_ptr_other{raw};
+    EXPECT_EQ(c_ptr.use_count(), 2);
+}
+
+TEST(CheckedIntrusivePtr, CopyAndMove)
+{
+    auto c_ptr = sia::make_checked_intrusive<Node>(1);
+    auto c_ptr_copy = c_ptr;  // NOLINT(performance-unnecessary-copy-initialization)
+
+    EXPECT_EQ(c_ptr.use_count(), 2);
+    EXPECT_EQ(c_ptr, c_ptr_copy);
+
+    sia::checked_intrusive_ptr<Node> c_ptr_moved{std::move(c_ptr_copy)};
+    EXPECT_TRUE(c_ptr_copy == nullptr);
+    EXPECT_EQ(c_ptr.use_count(), 2);
+
+    c_ptr_copy = c_ptr_moved;
+    EXPECT_EQ(c_ptr.use_count(), 3);
+
+    c_ptr_copy = std::move(c_ptr_moved);
+    EXPECT_TRUE(c_ptr_moved == nullptr);
+    EXPECT_EQ(c_ptr.use_count(), 2);
+}
+
+TEST(CheckedIntrusivePtr, ConversionCtor)
+{
+    auto c_ptr_leaf = sia::make_checked_intrusive<LeafNode>(3);
+    sia::checked_intrusive_ptr<Node> c_ptr_node{c_ptr_leaf};
+
+    EXPECT_EQ(c_ptr_node.get(), c_ptr_leaf.get());
+    EXPECT_EQ(c_ptr_node->m_id, 3);
+    EXPECT_EQ(c_ptr_leaf.use_count(), 2);
+}
+
+TEST(CheckedIntrusivePtr, Destruction)
+{
+    std::int32_t destroyed{};
+
+    {
+        auto c_ptr = sia::make_checked_intrusive<DestructionCounter>(destroyed);
+        auto c_ptr_copy = c_ptr;
+        c_ptr.reset();
+        EXPECT_EQ(destroyed, 0);
+    }
+
+    EXPECT_EQ(destroyed, 1);
+}
+
+TEST(CheckedIntrusivePtr, DetachAndAdopt)
+{
+    std::int32_t destroyed{};
+    auto c_ptr = sia::make_checked_intrusive<DestructionCounter>(destroyed);
+
+    auto *raw = c_ptr.detach();
+    EXPECT_TRUE(c_ptr == nullptr);
+    EXPECT_EQ(destroyed, 0);
+
+    c_ptr.reset(raw, false);
+    EXPECT_EQ(c_ptr.use_count(), 1);
+    c_ptr = nullptr;
+    EXPECT_EQ(destroyed, 1);
+}
+
+TEST(CheckedIntrusivePtr, Comparison)
+{
+    auto c_ptr1 = sia::make_checked_intrusive<Node>();
+    auto c_ptr2 = sia::make_checked_intrusive<Node>();
+
+    EXPECT_NE(c_ptr1, c_ptr2);
+    EXPECT_EQ(c_ptr1 < c_ptr2, c_ptr1.get() < c_ptr2.get());
+    EXPECT_TRUE(c_ptr1 <= c_ptr1);
+    EXPECT_TRUE(c_ptr1 >= c_ptr1);
+    EXPECT_TRUE(c_ptr1 != nullptr);
+
+    c_ptr1 = nullptr;
+    EXPECT_TRUE(c_ptr1 == nullptr);
+    EXPECT_FALSE(c_ptr1 < nullptr);
+}
+
+TEST(CheckedIntrusivePtr, Hash)
+{
+    auto c_ptr1 = sia::make_checked_intrusive<Node>();
+    auto c_ptr2 = c_ptr1;
+
+    std::unordered_set<sia::checked_intrusive_ptr<Node>> set{};
+    set.insert(c_ptr1);
+    set.insert(c_ptr2);
+
+    EXPECT_EQ(set.size(), 1);
+    EXPECT_EQ(c_ptr1.use_count(), 3);
+}
+
+TEST(CheckedIntrusivePtr, PointerCasts)
+{
+    sia::checked_intrusive_ptr<Node> c_ptr{sia::make_checked_intrusive<LeafNode>(5)};
+
+    auto c_ptr_leaf = std::static_pointer_cast<LeafNode>(c_ptr);
+    EXPECT_EQ(c_ptr_leaf->m_id, 5);
+
+    auto valid_cast = std::dynamic_pointer_cast<LeafNode>(c_ptr);
+    auto invalid_cast = std::dynamic_pointer_cast<BranchNode>(c_ptr);
+    EXPECT_FALSE(valid_cast == nullptr);
+    EXPECT_TRUE(invalid_cast == nullptr);
+
+    sia::checked_intrusive_ptr<const Node> c_ptr_const{c_ptr};
+    auto c_ptr_mutable = std::const_pointer_cast<Node>(c_ptr_const);
+    EXPECT_EQ(c_ptr_mutable, c_ptr);
+
+    EXPECT_EQ(c_ptr.use_count(), 5);
+}
+
+TEST(CheckedIntrusivePtr, NullPtrAccess)
+{
+    sia::checked_intrusive_ptr<Node> c_ptr{};
+
+    EXPECT_THROW(c_ptr->m_id = 1, sia::CheckedNullPtrException);
+    EXPECT_THROW(*c_ptr, sia::CheckedNullPtrException);
+
+    sia::checked_intrusive_ptr<Node, sia::abort_on_null> c_ptr_abort{};
+    static_assert(noexcept(c_ptr_abort.operator->()));
+    EXPECT_DEATH(c_ptr_abort->m_id = 1, "");
+}
@@ -0,0 +1,35 @@
+#include "checked_local_ptr.hpp"
+#include <gtest/gtest.h>
+#include <thread>
+
+// Built as an executable of its own with SIA_CSP_CHECK_LOCAL_PTR_OWNER=1, see test/CMakeLists.txt.
+//
+namespace
+{
+
+struct Shape
+{
+    std::int32_t m_id{};
+};
+
+}  // namespace
+
+#ifndef NDEBUG
+TEST(CheckedLocalPtrOwner, OwnerThreadAccess)
+{
+    auto c_ptr = sia::make_checked_local<Shape>();
+    auto c_ptr_copy = c_ptr;
+
+    c_ptr_copy->m_id = 1;
+    EXPECT_EQ(c_ptr->m_id, 1);
+    EXPECT_EQ(c_ptr.use_count(), 2);
+}
+
+TEST(CheckedLocalPtrOwner, ForeignThreadAccess)
+{
+    auto c_ptr = sia::make_checked_local<Shape>();
+
+    EXPECT_DEATH(std::thread([&c_ptr] { auto c_ptr_copy = c_ptr; }).join(), "foreign thread");
+    EXPECT_DEATH(std::thread([&c_ptr] { c_ptr->m_id = 1; }).join(), "foreign thread");
+}
+#endif
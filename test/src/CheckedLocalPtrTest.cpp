@@ -0,0 +1,172 @@
+#include "checked_local_ptr.hpp"
+#include <gtest/gtest.h>
+#include <unordered_set>
+
+namespace
+{
+
+struct Shape
+{
+    virtual ~Shape() = default;
+
+    std::int32_t m_id{};
+};
+
+struct Circle final : Shape
+{
+    std::int32_t m_radius{};
+};
+
+struct Square final : Shape
+{
+};
+
+struct DestructionCounter
+{
+    explicit DestructionCounter(std::int32_t &counter) : m_counter(counter)
+    {
+    }
+
+    ~DestructionCounter()
+    {
+        ++m_counter;
+    }
+
+    std::int32_t &m_counter;
+};
+
+struct Pair
+{
+    std::int32_t m_first{};
+    std::int32_t m_second{};
+};
+
+}  // namespace
+
+TEST(CheckedLocalPtr, DefaultCtor)
+{
+    sia::checked_local_ptr<Shape> c_ptr{};
+    EXPECT_TRUE(c_ptr.get() == nullptr);
+    EXPECT_EQ(c_ptr.use_count(), 0);
+}
+
+TEST(CheckedLocalPtr, CtorWithRawPtr)
+{
+    std::int32_t destroyed{};
+
+    {
+        sia::checked_local_ptr<DestructionCounter> c_ptr{new DestructionCounter(destroyed)};
+        EXPECT_EQ(c_ptr.use_count(), 1);
+    }
+
+    EXPECT_EQ(destroyed, 1);
+}
+
+TEST(CheckedLocalPtr, MakeCheckedLocal)
+{
+    std::int32_t destroyed{};
+
+    {
+        auto c_ptr = sia::make_checked_local<DestructionCounter>(destroyed);
+        auto c_ptr_copy = c_ptr;  // NOLINT(performance-unnecessary-copy-initialization)
+        EXPECT_EQ(c_ptr.use_count(), 2);
+    }
+
+    EXPECT_EQ(destroyed, 1);
+}
+
+TEST(CheckedLocalPtr, CopyAndMove)
+{
+    auto c_ptr = sia::make_checked_local<Shape>();
+    sia::checked_local_ptr<Shape> c_ptr_copy{c_ptr};
+    EXPECT_EQ(c_ptr.use_count(), 2);
+
+    sia::checked_local_ptr<Shape> c_ptr_moved{std::move(c_ptr_copy)};
+    EXPECT_TRUE(c_ptr_copy == nullptr);
+    EXPECT_EQ(c_ptr.use_count(), 2);
+
+    c_ptr_copy = c_ptr_moved;
+    EXPECT_EQ(c_ptr.use_count(), 3);
+
+    c_ptr_copy = std::move(c_ptr_moved);
+    EXPECT_TRUE(c_ptr_moved == nullptr);
+    EXPECT_EQ(c_ptr.use_count(), 2);
+}
+
+TEST(CheckedLocalPtr, ConversionCtor)
+{
+    auto c_ptr_circle = sia::make_checked_local<Circle>();
+    sia::checked_local_ptr<Shape> c_ptr_shape{c_ptr_circle};
+
+    EXPECT_EQ(c_ptr_shape.get(), c_ptr_circle.get());
+    EXPECT_EQ(c_ptr_circle.use_count(), 2);
+}
+
+TEST(CheckedLocalPtr, AlisingCtor)
+{
+    auto c_ptr_pair = sia::make_checked_local<Pair>();
+    sia::checked_local_ptr<std::int32_t> c_ptr_second{c_ptr_pair, &c_ptr_pair->m_second};
+
+    *c_ptr_second = 7;
+    EXPECT_EQ(c_ptr_pair->m_second, 7);
+    EXPECT_EQ(c_ptr_pair.use_count(), 2);
+
+    sia::checked_local_ptr<std::int32_t> c_ptr_first{std::move(c_ptr_pair), &c_ptr_pair->m_first};
+    EXPECT_TRUE(c_ptr_pair == nullptr);
+    EXPECT_EQ(c_ptr_first.use_count(), 2);
+}
+
+TEST(CheckedLocalPtr, ResetAndSwap)
+{
+    auto c_ptr1 = sia::make_checked_local<Shape>();
+    auto c_ptr2 = sia::make_checked_local<Shape>();
+    auto *raw1 = c_ptr1.get();
+
+    sia::swap(c_ptr1, c_ptr2);
+    EXPECT_EQ(c_ptr2.get(), raw1);
+
+    c_ptr1.reset();
+    EXPECT_TRUE(c_ptr1 == nullptr);
+    c_ptr1.reset(new Circle());
+    EXPECT_TRUE(c_ptr1 != nullptr);
+    EXPECT_EQ(c_ptr1.use_count(), 1);
+}
+
+TEST(CheckedLocalPtr, PointerCasts)
+{
+    sia::checked_local_ptr<Shape> c_ptr{sia::make_checked_local<Circle>()};
+
+    auto c_ptr_circle = std::static_pointer_cast<Circle>(c_ptr);
+    c_ptr_circle->m_radius = 3;
+
+    auto valid_cast = std::dynamic_pointer_cast<Circle>(c_ptr);
+    auto invalid_cast = std::dynamic_pointer_cast<Square>(c_ptr);
+    EXPECT_EQ(valid_cast->m_radius, 3);
+    EXPECT_TRUE(invalid_cast == nullptr);
+    EXPECT_EQ(invalid_cast.use_count(), 0);
+
+    sia::checked_local_ptr<const Shape> c_ptr_const{c_ptr};
+    auto c_ptr_mutable = std::const_pointer_cast<Shape>(c_ptr_const);
+    EXPECT_EQ(c_ptr_mutable, c_ptr);
+    EXPECT_EQ(c_ptr.use_count(), 5);
+}
+
+TEST(CheckedLocalPtr, Hash)
+{
+    auto c_ptr = sia::make_checked_local<Shape>();
+
+    std::unordered_set<sia::checked_local_ptr<Shape>> set{};
+    set.insert(c_ptr);
+    set.insert(c_ptr);
+
+    EXPECT_EQ(set.size(), 1);
+    EXPECT_EQ(c_ptr.use_count(), 2);
+}
+
+TEST(CheckedLocalPtr, NullPtrAccess)
+{
+    sia::checked_local_ptr<Shape> c_ptr{};
+
+    EXPECT_THROW(c_ptr->m_id = 1, sia::CheckedNullPtrException);
+    EXPECT_THROW(*c_ptr, sia::CheckedNullPtrException);
+}
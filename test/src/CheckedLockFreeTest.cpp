@@ -0,0 +1,171 @@
+#include "checked_lock_free.hpp"
+#include <gtest/gtest.h>
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+namespace
+{
+
+struct Message
+{
+    explicit Message(std::int64_t id) : m_id(id)
+    {
+        s_alive.fetch_add(1);
+    }
+
+    ~Message()
+    {
+        s_alive.fetch_sub(1);
+    }
+
+    std::int64_t m_id;
+
+    static inline std::atomic<std::int64_t> s_alive{0};
+};
+
+// Every thread pushes its own ids and pops whatever it gets, all ids have to come out exactly once.
+//
+template <typename Push, typename Pop>
+void pushAndPopConcurrently(std::int64_t threads, std::int64_t per_thread, Push push, Pop pop)
+{
+    std::vector<std::atomic<std::int32_t>> seen(static_cast<std::size_t>(threads * per_thread));
+    std::vector<std::thread> workers{};
+
+    for (std::int64_t t = 0; t < threads; ++t)
+    {
+        workers.emplace_back(
+            [&, t]
+            {
+                sia::checked_shared_ptr<Message> message{};
+                for (std::int64_t i = 0; i < per_thread; ++i)
+                {
+                    push(sia::make_checked_shared<Message>(t * per_thread + i));
+                    while (!pop(message))
+                        std::this_thread::yield();
+
+                    seen[static_cast<std::size_t>(message->m_id)].fetch_add(1);
+                    message = nullptr;
+                }
+            });
+    }
+
+    for (auto &worker : workers)
+        worker.join();
+
+    for (const auto &count : seen)
+        EXPECT_EQ(count.load(), 1);
+}
+
+}  // namespace
+
+TEST(CheckedLockFree, QueueIsFifo)
+{
+    sia::checked_mpmc_queue<Message> queue{3};
+    EXPECT_EQ(queue.capacity(), 4);
+
+    for (std::int64_t i = 0; i < 4; ++i)
+        EXPECT_TRUE(queue.tryPush(sia::make_checked_shared<Message>(i)));
+
+    auto rejected = sia::make_checked_shared<Message>(4);
+    EXPECT_FALSE(queue.tryPush(std::move(rejected)));
+    ASSERT_NE(rejected, nullptr);
+
+    sia::checked_shared_ptr<Message> message{};
+    for (std::int64_t i = 0; i < 4; ++i)
+    {
+        ASSERT_TRUE(queue.tryPop(message));
+        EXPECT_EQ(message->m_id, i);
+    }
+
+    EXPECT_FALSE(queue.tryPop(message));
+    EXPECT_TRUE(queue.tryPush(std::move(rejected)));
+    EXPECT_TRUE(queue.tryPop(message));
+    EXPECT_EQ(message->m_id, 4);
+}
+
+TEST(CheckedLockFree, QueueMovesOwnership)
+{
+    auto message = sia::make_checked_shared<Message>(1);
+    Message *raw = message.get();
+
+    {
+        sia::checked_mpmc_queue<Message> queue{8};
+        EXPECT_TRUE(queue.tryPush(std::move(message)));
+        EXPECT_EQ(message, nullptr);
+
+        sia::checked_shared_ptr<Message> popped{};
+        ASSERT_TRUE(queue.tryPop(popped));
+        EXPECT_EQ(popped.get(), raw);
+        EXPECT_EQ(popped.use_count(), 1);
+
+        // Whatever is left is released with the queue.
+        //
+        EXPECT_TRUE(queue.tryPush(std::move(popped)));
+    }
+
+    EXPECT_EQ(Message::s_alive.load(), 0);
+}
+
+TEST(CheckedLockFree, StackIsLifo)
+{
+    sia::checked_lock_free_stack<Message> stack{};
+    EXPECT_TRUE(stack.empty());
+
+    for (std::int64_t i = 0; i < 3; ++i)
+        stack.push(sia::make_checked_shared<Message>(i));
+
+    sia::checked_shared_ptr<Message> message{};
+    for (std::int64_t i = 2; i >= 0; --i)
+    {
+        ASSERT_TRUE(stack.tryPop(message));
+        EXPECT_EQ(message->m_id, i);
+        EXPECT_EQ(message.use_count(), 1);
+    }
+
+    EXPECT_FALSE(stack.tryPop(message));
+    EXPECT_TRUE(stack.empty());
+
+    stack.push(std::move(message));
+    stack.push(nullptr);
+}
+
+TEST(CheckedLockFree, StackReleasesWhatIsLeft)
+{
+    {
+        sia::checked_lock_free_stack<Message> stack{};
+        for (std::int64_t i = 0; i < 10; ++i)
+            stack.push(sia::make_checked_shared<Message>(i));
+    }
+
+    EXPECT_EQ(Message::s_alive.load(), 0);
+}
+
+TEST(CheckedLockFree, QueueManyThreads)
+{
+    sia::checked_mpmc_queue<Message> queue{64};
+
+    pushAndPopConcurrently(
+        4, 5000,
+        [&queue](sia::checked_shared_ptr<Message> &&message)
+        {
+            while (!queue.tryPush(std::move(message)))
+                std::this_thread::yield();
+        },
+        [&queue](sia::checked_shared_ptr<Message> &message) { return queue.tryPop(message); });
+
+    EXPECT_EQ(Message::s_alive.load(), 0);
+}
+
+TEST(CheckedLockFree, StackManyThreads)
+{
+    sia::checked_lock_free_stack<Message> stack{};
+
+    pushAndPopConcurrently(
+        4, 5000, [&stack](sia::checked_shared_ptr<Message> &&message) { stack.push(std::move(message)); },
+        [&stack](sia::checked_shared_ptr<Message> &message) { return stack.tryPop(message); });
+
+    EXPECT_TRUE(stack.empty());
+    EXPECT_EQ(Message::s_alive.load(), 0);
+}
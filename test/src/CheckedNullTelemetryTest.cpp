@@ -0,0 +1,209 @@
+#include "checked_null_telemetry.hpp"
+#include <gtest/gtest.h>
+#include <cstring>
+#include <sstream>
+#include <string>
+#include <thread>
+
+namespace
+{
+
+struct Sensor
+{
+    std::int32_t m_reading{};
+};
+
+using RecordedSensor = sia::checked_shared_ptr<Sensor, sia::record_on_null<>>;
+
+// The two readers compile to the same code, GCC would fold them into one function at -O2 and with them their sites.
+//
+#if defined(__GNUC__) && !defined(__clang__)
+#define DISTINCT_SITE [[gnu::noipa]]
+#else
+#define DISTINCT_SITE [[gnu::noinline]]
+#endif
+
+DISTINCT_SITE std::int32_t readAtFirstSite(const RecordedSensor &sensor)
+{
+    return sensor->m_reading;
+}
+
+DISTINCT_SITE std::int32_t readAtSecondSite(const RecordedSensor &sensor)
+{
+    return (*sensor).m_reading;
+}
+
+// Identical as well, but keyed by their source location, which survives the folding.
+//
+[[gnu::noinline]] std::int32_t readCheckedAtFirstSite(const RecordedSensor &sensor)
+{
+    return sensor.getChecked()->m_reading;
+}
+
+[[gnu::noinline]] std::int32_t readCheckedAtSecondSite(const RecordedSensor &sensor)
+{
+    return sensor.getChecked()->m_reading;
+}
+
+class CheckedNullTelemetry : public ::testing::Test
+{
+    protected:
+    void SetUp() override
+    {
+        sia::null_telemetry::reset();
+        sia::null_telemetry::setSampleInterval(std::chrono::hours(1));
+    }
+
+    void TearDown() override
+    {
+        sia::null_telemetry::setSampleInterval(std::chrono::seconds(1));
+    }
+};
+
+}  // namespace
+
+static_assert(sia::record_on_null<>::is_checked);
+static_assert(!sia::record_on_null<>::is_noexcept);
+static_assert(sia::record_on_null<sia::abort_on_null>::is_noexcept);
+static_assert(noexcept(std::declval<sia::checked_shared_ptr<Sensor, sia::record_on_null<sia::abort_on_null>> &>()
+                           .operator->()));
+static_assert(noexcept(std::declval<sia::checked_shared_ptr<Sensor, sia::abort_on_null> &>().getChecked()));
+
+TEST_F(CheckedNullTelemetry, NothingRecordedWithoutNulls)
+{
+    RecordedSensor sensor{sia::make_checked_shared<Sensor>()};
+
+    EXPECT_EQ(readAtFirstSite(sensor), 0);
+    EXPECT_EQ(sensor.getChecked()->m_reading, 0);
+    EXPECT_TRUE(sia::null_telemetry::snapshot().m_sites.empty());
+}
+
+TEST_F(CheckedNullTelemetry, CountsPerSite)
+{
+    RecordedSensor sensor{};
+
+    for (int i = 0; i < 3; ++i)
+        EXPECT_THROW(readAtFirstSite(sensor), sia::CheckedNullPtrException);
+
+    EXPECT_THROW(readAtSecondSite(sensor), sia::CheckedNullPtrException);
+
+    const auto snap = sia::null_telemetry::snapshot();
+    ASSERT_EQ(snap.m_sites.size(), 2);
+    EXPECT_EQ(snap.m_sites[0].m_hits, 3);
+    EXPECT_EQ(snap.m_sites[1].m_hits, 1);
+    EXPECT_NE(snap.m_sites[0].m_address, nullptr);
+    EXPECT_NE(snap.m_sites[0].m_address, snap.m_sites[1].m_address);
+    EXPECT_EQ(snap.m_dropped_hits, 0);
+}
+
+TEST_F(CheckedNullTelemetry, SourceLocationSitesAreNotFolded)
+{
+    RecordedSensor sensor{};
+
+    EXPECT_THROW(readCheckedAtFirstSite(sensor), sia::CheckedNullPtrException);
+    EXPECT_THROW(readCheckedAtSecondSite(sensor), sia::CheckedNullPtrException);
+    EXPECT_THROW(readCheckedAtSecondSite(sensor), sia::CheckedNullPtrException);
+
+    const auto snap = sia::null_telemetry::snapshot();
+    ASSERT_EQ(snap.m_sites.size(), 2);
+    EXPECT_EQ(snap.m_sites[0].m_hits, 2);
+    EXPECT_EQ(snap.m_sites[1].m_hits, 1);
+    EXPECT_EQ(snap.m_sites[0].m_line, snap.m_sites[1].m_line + 5);
+}
+
+TEST_F(CheckedNullTelemetry, GetCheckedRecordsSourceLocation)
+{
+    RecordedSensor sensor{};
+
+    const std::uint32_t line = __LINE__ + 1;
+    EXPECT_THROW(sensor.getChecked(), sia::CheckedNullPtrException);
+
+    const auto snap = sia::null_telemetry::snapshot();
+    ASSERT_EQ(snap.m_sites.size(), 1);
+    EXPECT_STREQ(snap.m_sites[0].m_file, __FILE__);
+    EXPECT_EQ(snap.m_sites[0].m_line, line);
+    EXPECT_NE(std::strstr(snap.m_sites[0].m_function, "TestBody"), nullptr);
+}
+
+TEST_F(CheckedNullTelemetry, SamplesAreRateLimited)
+{
+    RecordedSensor sensor{};
+
+    for (int i = 0; i < 5; ++i)
+        EXPECT_THROW(readAtFirstSite(sensor), sia::CheckedNullPtrException);
+
+    auto snap = sia::null_telemetry::snapshot();
+    ASSERT_EQ(snap.m_samples.size(), 1);
+    EXPECT_EQ(snap.m_samples[0].m_site.m_address, snap.m_sites[0].m_address);
+#if SIA_CSP_HAS_BACKTRACE
+    EXPECT_FALSE(snap.m_samples[0].m_frames.empty());
+#endif
+
+    sia::null_telemetry::setSampleInterval(std::chrono::nanoseconds(0));
+
+    for (int i = 0; i < 2; ++i)
+        EXPECT_THROW(readAtFirstSite(sensor), sia::CheckedNullPtrException);
+
+    snap = sia::null_telemetry::snapshot();
+    EXPECT_EQ(snap.m_samples.size(), 3);
+    EXPECT_EQ(snap.m_sites[0].m_hits, 7);
+}
+
+TEST_F(CheckedNullTelemetry, SampleRingKeepsNewest)
+{
+    RecordedSensor sensor{};
+    sia::null_telemetry::setSampleInterval(std::chrono::nanoseconds(0));
+
+    for (std::size_t i = 0; i < sia::null_telemetry::kMaxSamples + 10; ++i)
+        EXPECT_THROW(sensor.getChecked(), sia::CheckedNullPtrException);
+
+    const auto snap = sia::null_telemetry::snapshot();
+    EXPECT_EQ(snap.m_samples.size(), sia::null_telemetry::kMaxSamples);
+    EXPECT_LE(snap.m_samples.front().m_timestamp_ns, snap.m_samples.back().m_timestamp_ns);
+}
+
+TEST_F(CheckedNullTelemetry, ConcurrentRecording)
+{
+    static const int kSite = 0;
+    std::vector<std::thread> threads{};
+
+    for (int t = 0; t < 4; ++t)
+    {
+        threads.emplace_back(
+            []
+            {
+                for (int i = 0; i < 1000; ++i)
+                    sia::null_telemetry::record(nullptr, 0, nullptr, &kSite);
+            });
+    }
+
+    for (auto &thread : threads)
+        thread.join();
+
+    const auto snap = sia::null_telemetry::snapshot();
+    ASSERT_EQ(snap.m_sites.size(), 1);
+    EXPECT_EQ(snap.m_sites[0].m_address, &kSite);
+    EXPECT_EQ(snap.m_sites[0].m_hits, 4000);
+    EXPECT_EQ(snap.m_samples.size(), 1);
+}
+
+TEST_F(CheckedNullTelemetry, Dump)
+{
+    RecordedSensor sensor{};
+    for (int i = 0; i < 2; ++i)
+        EXPECT_THROW(sensor.getChecked(), sia::CheckedNullPtrException);
+
+    std::ostringstream os{};
+    sia::null_telemetry::dump(os);
+
+    const std::string report = os.str();
+    EXPECT_NE(report.find("1 sites"), std::string::npos);
+    EXPECT_NE(report.find("2 hits at " __FILE__), std::string::npos);
+    EXPECT_NE(report.find("backtrace at"), std::string::npos);
+}
+
+TEST_F(CheckedNullTelemetry, InnerPolicyStillApplies)
+{
+    sia::checked_shared_ptr<Sensor, sia::record_on_null<sia::abort_on_null>> sensor{};
+    EXPECT_DEATH(sensor->m_reading++, "");
+}
@@ -0,0 +1,204 @@
+#include "checked_object_pool.hpp"
+#include <gtest/gtest.h>
+#include <array>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+// Every test uses a type of its own, the pools are process wide.
+//
+
+namespace
+{
+
+template <int Tag>
+struct Order
+{
+    explicit Order(std::int64_t id = 0) : m_id(id)
+    {
+        ++s_alive;
+    }
+
+    Order(const Order &) = delete;
+    Order &operator=(const Order &) = delete;
+
+    ~Order()
+    {
+        --s_alive;
+    }
+
+    std::int64_t m_id;
+    std::array<char, 48> m_payload{};
+
+    static inline std::atomic<std::int32_t> s_alive{0};
+};
+
+struct alignas(64) Aligned
+{
+    std::array<char, 64> m_line{};
+};
+
+}  // namespace
+
+TEST(ObjectPool, ReturnsOrdinaryCheckedSharedPtr)
+{
+    using Type = Order<0>;
+
+    sia::checked_shared_ptr<Type> order = sia::pooled_checked_shared<Type>(7);
+
+    EXPECT_EQ(order->m_id, 7);
+    EXPECT_EQ(order.use_count(), 1);
+    EXPECT_EQ(Type::s_alive, 1);
+    EXPECT_GT(sia::object_pool<Type>::slotSize(), sizeof(Type));
+
+    order = nullptr;
+    EXPECT_EQ(Type::s_alive, 0);
+}
+
+TEST(ObjectPool, RecyclesSlots)
+{
+    using Type = Order<1>;
+
+    const Type *first = sia::pooled_checked_shared<Type>().get();
+
+    for (int i = 0; i < 100; ++i)
+    {
+        auto order = sia::pooled_checked_shared<Type>(i);
+        EXPECT_EQ(order.get(), first);
+    }
+
+    EXPECT_EQ(sia::object_pool<Type>::stats().m_system_allocations, 1);
+}
+
+TEST(ObjectPool, WeakOwnerKeepsSlot)
+{
+    using Type = Order<2>;
+
+    auto order = sia::pooled_checked_shared<Type>();
+    sia::checked_weak_ptr<Type> weak{order};
+    const Type *first = order.get();
+
+    order = nullptr;
+    EXPECT_EQ(Type::s_alive, 0);
+    EXPECT_NE(sia::pooled_checked_shared<Type>().get(), first);
+
+    weak.reset();
+    EXPECT_EQ(sia::pooled_checked_shared<Type>().get(), first);
+}
+
+TEST(ObjectPool, ThreadCapSpillsToDepot)
+{
+    using Type = Order<3>;
+    sia::object_pool<Type>::setThreadCap(8);
+
+    std::vector<sia::checked_shared_ptr<Type>> orders{};
+    for (int i = 0; i < 32; ++i)
+        orders.push_back(sia::pooled_checked_shared<Type>(i));
+
+    orders.clear();
+
+    const auto stats = sia::object_pool<Type>::stats();
+    EXPECT_EQ(stats.m_system_allocations, 32);
+    EXPECT_GT(stats.m_depot_spills, 0);
+    EXPECT_GE(stats.m_depot_slots, 32 - 8);
+
+    for (int i = 0; i < 32; ++i)
+        orders.push_back(sia::pooled_checked_shared<Type>(i));
+
+    EXPECT_EQ(sia::object_pool<Type>::stats().m_system_allocations, 32);
+    EXPECT_GT(sia::object_pool<Type>::stats().m_depot_refills, 0);
+}
+
+TEST(ObjectPool, DepotCapReturnsToSystem)
+{
+    using Type = Order<4>;
+    sia::object_pool<Type>::setThreadCap(4);
+    sia::object_pool<Type>::setDepotCap(4);
+
+    std::vector<sia::checked_shared_ptr<Type>> orders{};
+    for (int i = 0; i < 32; ++i)
+        orders.push_back(sia::pooled_checked_shared<Type>(i));
+
+    orders.clear();
+
+    const auto stats = sia::object_pool<Type>::stats();
+    EXPECT_LE(stats.m_depot_slots, 4);
+    EXPECT_GE(stats.m_system_frees, 32 - 4 - 4);
+}
+
+TEST(ObjectPool, CrossThreadRelease)
+{
+    using Type = Order<5>;
+    constexpr int kRounds = 20;
+    constexpr int kBatch = 200;
+    sia::object_pool<Type>::setThreadCap(32);
+
+    for (int round = 0; round < kRounds; ++round)
+    {
+        std::vector<sia::checked_shared_ptr<Type>> orders{};
+        for (int i = 0; i < kBatch; ++i)
+            orders.push_back(sia::pooled_checked_shared<Type>(i));
+
+        std::thread consumer([&orders] { orders.clear(); });
+        consumer.join();
+    }
+
+    // Slots released by the consumers make it back through the depot, the producer does not keep allocating.
+    //
+    const auto stats = sia::object_pool<Type>::stats();
+    EXPECT_EQ(Type::s_alive, 0);
+    EXPECT_LT(stats.m_system_allocations, 2 * kBatch);
+    EXPECT_GT(stats.m_depot_refills, 0);
+}
+
+TEST(ObjectPool, ConcurrentChurn)
+{
+    using Type = Order<6>;
+    std::vector<std::thread> threads{};
+
+    for (int t = 0; t < 4; ++t)
+    {
+        threads.emplace_back(
+            [t]
+            {
+                std::vector<sia::checked_shared_ptr<Type>> orders{};
+                for (int i = 0; i < 10000; ++i)
+                {
+                    orders.push_back(sia::pooled_checked_shared<Type>(t * 10000 + i));
+                    if (orders.size() > 64)
+                        orders.erase(orders.begin(), orders.begin() + 32);
+                }
+            });
+    }
+
+    for (auto &thread : threads)
+        thread.join();
+
+    EXPECT_EQ(Type::s_alive, 0);
+}
+
+TEST(ObjectPool, Trim)
+{
+    using Type = Order<7>;
+
+    {
+        std::vector<sia::checked_shared_ptr<Type>> orders{};
+        for (int i = 0; i < 16; ++i)
+            orders.push_back(sia::pooled_checked_shared<Type>(i));
+    }
+
+    sia::object_pool<Type>::trim();
+
+    const auto stats = sia::object_pool<Type>::stats();
+    EXPECT_EQ(stats.m_system_frees, 16);
+    EXPECT_EQ(stats.m_depot_slots, 0);
+}
+
+TEST(ObjectPool, OverAligned)
+{
+    for (int i = 0; i < 8; ++i)
+    {
+        auto line = sia::pooled_checked_shared<Aligned>();
+        EXPECT_EQ(reinterpret_cast<std::uintptr_t>(line.get()) % alignof(Aligned), 0);
+    }
+}
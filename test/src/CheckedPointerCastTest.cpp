@@ -0,0 +1,212 @@
+#include "checked_shared_ptr.hpp"
+#include <gtest/gtest.h>
+#include <cstdint>
+
+namespace
+{
+
+struct Shape
+{
+    virtual ~Shape() = default;
+    std::int32_t m_id{};
+};
+
+struct Circle final : Shape
+{
+    double m_radius{1.0};
+};
+
+struct Polygon : Shape
+{
+    std::int32_t m_corners{};
+};
+
+struct Square final : Polygon
+{
+};
+
+// Decided by the tag, without RTTI.
+//
+struct Token
+{
+    enum class Kind
+    {
+        number,
+        name
+    };
+
+    explicit Token(Kind kind) : m_kind(kind)
+    {
+    }
+
+    Kind m_kind;
+};
+
+struct NumberToken : Token
+{
+    NumberToken() : Token(Kind::number)
+    {
+    }
+
+    static bool classof(const Token *token)
+    {
+        return token->m_kind == Kind::number;
+    }
+
+    std::int64_t m_value{42};
+};
+
+struct NameToken : Token
+{
+    NameToken() : Token(Kind::name)
+    {
+    }
+
+    static bool classof(const Token *token)
+    {
+        return token->m_kind == Kind::name;
+    }
+};
+
+struct Mixin
+{
+    virtual ~Mixin() = default;
+    std::int32_t m_mixin{};
+};
+
+struct Widget final : Shape, Mixin
+{
+};
+
+}  // namespace
+
+static_assert(sia::detail::is_final_downcast<Circle, Shape>);
+static_assert(sia::detail::is_final_downcast<const Square, const Shape>);
+static_assert(!sia::detail::is_final_downcast<Polygon, Shape>);
+static_assert(!sia::detail::is_final_downcast<Shape, Circle>);
+static_assert(sia::detail::has_classof<NumberToken, Token>::value);
+static_assert(!sia::detail::has_classof<Polygon, Shape>::value);
+
+TEST(CheckedPointerCast, ReinterpretPointerCast)
+{
+    auto value = sia::make_checked_shared<std::uint32_t>(0x01020304U);
+    auto bytes = std::reinterpret_pointer_cast<unsigned char>(value);
+
+    EXPECT_EQ(static_cast<void *>(bytes.get()), static_cast<void *>(value.get()));
+    EXPECT_EQ(value.use_count(), 2);
+}
+
+TEST(CheckedPointerCast, StaticPointerCastRvalueSteals)
+{
+    sia::checked_shared_ptr<Shape> shape{sia::make_checked_shared<Circle>()};
+    Shape *raw = shape.get();
+
+    auto circle = std::static_pointer_cast<Circle>(std::move(shape));
+
+    EXPECT_EQ(shape.get(), nullptr);  // NOLINT(bugprone-use-after-move)
+    EXPECT_EQ(circle.get(), raw);
+    EXPECT_EQ(circle.use_count(), 1);
+    EXPECT_EQ(circle->m_radius, 1.0);
+}
+
+TEST(CheckedPointerCast, StaticPointerCastRvalueUpcast)
+{
+    auto circle = sia::make_checked_shared<Circle>();
+    Circle *raw = circle.get();
+
+    auto shape = std::static_pointer_cast<Shape>(std::move(circle));
+
+    EXPECT_EQ(circle.get(), nullptr);  // NOLINT(bugprone-use-after-move)
+    EXPECT_EQ(shape.get(), raw);
+    EXPECT_EQ(shape.use_count(), 1);
+}
+
+TEST(CheckedPointerCast, ConstPointerCastRvalueSteals)
+{
+    sia::checked_shared_ptr<const Shape> shape{sia::make_checked_shared<Shape>()};
+    const Shape *raw = shape.get();
+
+    auto mutable_shape = std::const_pointer_cast<Shape>(std::move(shape));
+
+    EXPECT_EQ(shape.get(), nullptr);  // NOLINT(bugprone-use-after-move)
+    EXPECT_EQ(mutable_shape.get(), raw);
+    EXPECT_EQ(mutable_shape.use_count(), 1);
+}
+
+TEST(CheckedPointerCast, ReinterpretPointerCastRvalueKeepsAddress)
+{
+    sia::checked_shared_ptr<Widget> widget{sia::make_checked_shared<Widget>()};
+    void *raw = widget.get();
+
+    auto mixin = std::reinterpret_pointer_cast<Mixin>(std::move(widget));
+
+    EXPECT_EQ(widget.get(), nullptr);  // NOLINT(bugprone-use-after-move)
+    EXPECT_EQ(static_cast<void *>(mixin.get()), raw);
+    EXPECT_EQ(mixin.use_count(), 1);
+}
+
+TEST(CheckedPointerCast, DynamicPointerCastRvalue)
+{
+    sia::checked_shared_ptr<Shape> shape{sia::make_checked_shared<Circle>()};
+
+    auto square = std::dynamic_pointer_cast<Square>(std::move(shape));
+    EXPECT_EQ(square.get(), nullptr);
+    ASSERT_NE(shape.get(), nullptr);  // NOLINT(bugprone-use-after-move)
+    EXPECT_EQ(shape.use_count(), 1);
+
+    auto circle = std::dynamic_pointer_cast<Circle>(std::move(shape));
+    EXPECT_EQ(shape.get(), nullptr);  // NOLINT(bugprone-use-after-move)
+    ASSERT_NE(circle.get(), nullptr);
+    EXPECT_EQ(circle.use_count(), 1);
+}
+
+TEST(CheckedPointerCast, DynamicPointerCastFinalClass)
+{
+    sia::checked_shared_ptr<Shape> square{sia::make_checked_shared<Square>()};
+    sia::checked_shared_ptr<Shape> polygon{sia::make_checked_shared<Polygon>()};
+    sia::checked_shared_ptr<Shape> empty{};
+
+    EXPECT_NE(std::dynamic_pointer_cast<Square>(square).get(), nullptr);
+    EXPECT_EQ(std::dynamic_pointer_cast<Square>(polygon).get(), nullptr);
+    EXPECT_EQ(std::dynamic_pointer_cast<Circle>(square).get(), nullptr);
+    EXPECT_EQ(std::dynamic_pointer_cast<Square>(empty).get(), nullptr);
+
+    sia::checked_shared_ptr<const Polygon> const_polygon{std::dynamic_pointer_cast<const Polygon>(square)};
+    EXPECT_NE(std::dynamic_pointer_cast<const Square>(const_polygon).get(), nullptr);
+}
+
+TEST(CheckedPointerCast, DynamicPointerCastTypeTag)
+{
+    sia::checked_shared_ptr<Token> number{sia::make_checked_shared<NumberToken>()};
+    sia::checked_shared_ptr<Token> empty{};
+
+    auto as_number = std::dynamic_pointer_cast<NumberToken>(number);
+    ASSERT_NE(as_number.get(), nullptr);
+    EXPECT_EQ(as_number->m_value, 42);
+    EXPECT_EQ(std::dynamic_pointer_cast<NameToken>(number).get(), nullptr);
+    EXPECT_EQ(std::dynamic_pointer_cast<NumberToken>(empty).get(), nullptr);
+}
+
+TEST(CheckedPointerCast, CheckedPointerCast)
+{
+    sia::checked_shared_ptr<Shape> shape{sia::make_checked_shared<Circle>()};
+
+    auto circle = sia::checked_pointer_cast<Circle>(shape);
+    EXPECT_EQ(circle.get(), shape.get());
+    EXPECT_EQ(shape.use_count(), 2);
+
+    EXPECT_THROW(sia::checked_pointer_cast<Square>(shape), sia::CheckedNullPtrException);
+    EXPECT_THROW(sia::checked_pointer_cast<Circle>(sia::checked_shared_ptr<Shape>{}), sia::CheckedNullPtrException);
+}
+
+TEST(CheckedPointerCast, CheckedPointerCastRvalue)
+{
+    sia::checked_shared_ptr<Shape> shape{sia::make_checked_shared<Polygon>()};
+
+    EXPECT_THROW(sia::checked_pointer_cast<Square>(std::move(shape)), sia::CheckedNullPtrException);
+    ASSERT_NE(shape.get(), nullptr);  // NOLINT(bugprone-use-after-move)
+
+    auto polygon = sia::checked_pointer_cast<Polygon>(std::move(shape));
+    EXPECT_EQ(shape.get(), nullptr);  // NOLINT(bugprone-use-after-move)
+    EXPECT_EQ(polygon.use_count(), 1);
+}
@@ -0,0 +1,175 @@
+#include "checked_rcu.hpp"
+#include <gtest/gtest.h>
+#include <thread>
+#include <vector>
+
+namespace
+{
+
+struct RouteTable
+{
+    explicit RouteTable(std::int32_t version = 0) : m_version(version)
+    {
+    }
+
+    ~RouteTable()
+    {
+        m_alive = false;
+    }
+
+    std::int32_t m_version;
+    std::atomic<bool> m_alive{true};
+};
+
+}  // namespace
+
+TEST(CheckedRcu, ReadDoesNotTouchRefcount)
+{
+    auto owner = sia::make_checked_shared<RouteTable>(1);
+    sia::rcu_checked_shared_ptr<RouteTable> slot{owner};
+    EXPECT_EQ(owner.use_count(), 2);
+
+    {
+        sia::rcu_read_guard guard{};
+        auto view = slot.read(guard);
+
+        EXPECT_EQ(view.get(), owner.get());
+        EXPECT_EQ(view->m_version, 1);
+        EXPECT_EQ(owner.use_count(), 2);
+    }
+}
+
+TEST(CheckedRcu, ReadOfEmptySlotIsChecked)
+{
+    sia::rcu_checked_shared_ptr<RouteTable> slot{};
+    sia::rcu_read_guard guard{};
+
+    auto view = slot.read(guard);
+    EXPECT_TRUE(view == nullptr);
+    EXPECT_THROW(view->m_version, sia::CheckedNullPtrException);
+}
+
+TEST(CheckedRcu, LoadAndExchange)
+{
+    sia::rcu_checked_shared_ptr<RouteTable> slot{sia::make_checked_shared<RouteTable>(1)};
+
+    auto loaded = slot.load();
+    EXPECT_EQ(loaded->m_version, 1);
+    EXPECT_EQ(loaded.use_count(), 2);
+
+    auto previous = slot.exchange(sia::make_checked_shared<RouteTable>(2));
+    EXPECT_EQ(previous, loaded);
+    EXPECT_EQ(slot.load()->m_version, 2);
+
+    sia::rcu_domain::synchronize();
+    EXPECT_EQ(loaded.use_count(), 2);
+}
+
+TEST(CheckedRcu, NestedGuards)
+{
+    sia::rcu_checked_shared_ptr<RouteTable> slot{sia::make_checked_shared<RouteTable>(1)};
+    sia::checked_weak_ptr<RouteTable> weak{slot.load()};
+
+    {
+        sia::rcu_read_guard outer{};
+        auto view = slot.read(outer);
+
+        {
+            sia::rcu_read_guard inner{};
+        }
+
+        // Still inside the outer critical section.
+        //
+        slot.store(nullptr);
+        sia::rcu_domain::reclaim();
+        EXPECT_FALSE(weak.expired());
+        EXPECT_TRUE(view->m_alive);
+    }
+
+    sia::rcu_domain::reclaim();
+    EXPECT_TRUE(weak.expired());
+}
+
+TEST(CheckedRcu, OldObjectOutlivesReaders)
+{
+    sia::rcu_checked_shared_ptr<RouteTable> slot{sia::make_checked_shared<RouteTable>(1)};
+    sia::checked_weak_ptr<RouteTable> weak{slot.load()};
+
+    std::atomic<bool> reading{false};
+    std::atomic<bool> replaced{false};
+
+    std::thread reader(
+        [&]
+        {
+            sia::rcu_read_guard guard{};
+            auto view = slot.read(guard);
+
+            reading = true;
+            while (!replaced)
+                std::this_thread::yield();
+
+            EXPECT_EQ(view->m_version, 1);
+            EXPECT_TRUE(view->m_alive);
+        });
+
+    while (!reading)
+        std::this_thread::yield();
+
+    slot.store(sia::make_checked_shared<RouteTable>(2));
+    sia::rcu_domain::reclaim();
+    EXPECT_FALSE(weak.expired());
+
+    replaced = true;
+
+    reader.join();
+    sia::rcu_domain::synchronize();
+    EXPECT_TRUE(weak.expired());
+}
+
+TEST(CheckedRcu, SharedOwnersKeepObjectAlive)
+{
+    auto owner = sia::make_checked_shared<RouteTable>(1);
+    sia::rcu_checked_shared_ptr<RouteTable> slot{owner};
+
+    slot.store(sia::make_checked_shared<RouteTable>(2));
+    sia::rcu_domain::synchronize();
+
+    EXPECT_EQ(owner.use_count(), 1);
+    EXPECT_TRUE(owner->m_alive);
+}
+
+TEST(CheckedRcu, ConcurrentReadersAndWriter)
+{
+    sia::rcu_checked_shared_ptr<RouteTable> slot{sia::make_checked_shared<RouteTable>(0)};
+    std::atomic<bool> done{false};
+    std::vector<std::thread> readers{};
+
+    for (int t = 0; t < 3; ++t)
+    {
+        readers.emplace_back(
+            [&]
+            {
+                std::int32_t last = 0;
+
+                while (!done)
+                {
+                    sia::rcu_read_guard guard{};
+                    auto view = slot.read(guard);
+
+                    EXPECT_TRUE(view->m_alive);
+                    EXPECT_GE(view->m_version, last);
+                    last = view->m_version;
+                }
+            });
+    }
+
+    for (std::int32_t version = 1; version <= 1000; ++version)
+        slot.store(sia::make_checked_shared<RouteTable>(version));
+
+    done = true;
+    for (auto &reader : readers)
+        reader.join();
+
+    sia::rcu_domain::synchronize();
+    EXPECT_EQ(sia::rcu_domain::retiredCount(), 0);
+}
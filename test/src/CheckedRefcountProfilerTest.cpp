@@ -0,0 +1,252 @@
+#include "checked_shared_ptr.hpp"
+#include <gtest/gtest.h>
+#include <atomic>
+#include <sstream>
+#include <thread>
+
+// Built as an executable of its own with SIA_CSP_PROFILE_REFCOUNT=1, see test/CMakeLists.txt.
+//
+
+namespace
+{
+
+struct Widget
+{
+    std::int32_t m_id{};
+};
+
+struct Gadget
+{
+    std::int32_t m_id{};
+};
+
+const sia::refcount_object_stats *findObject(const sia::refcount_report &report, const void *object)
+{
+    for (const auto &stats : report.m_objects)
+    {
+        if (stats.m_object == object)
+            return &stats;
+    }
+
+    return nullptr;
+}
+
+class CheckedRefcountProfiler : public ::testing::Test
+{
+    protected:
+    void SetUp() override
+    {
+        sia::refcount_profiler::reset();
+        sia::refcount_profiler::setContentionThreshold(2);
+    }
+};
+
+}  // namespace
+
+static_assert(!std::is_trivially_copy_constructible_v<sia::detail::checked_shared_ptr_base<Widget>>);
+static_assert(sizeof(sia::checked_shared_ptr<Widget>) == sizeof(std::shared_ptr<Widget>));
+
+TEST_F(CheckedRefcountProfiler, CountsCopiesMovesAndReleases)
+{
+    auto c_ptr = sia::make_checked_shared<Widget>();
+    const void *object = c_ptr.get();
+
+    {
+        auto c_ptr_copy = c_ptr;
+        auto c_ptr_moved = std::move(c_ptr_copy);
+
+        sia::checked_shared_ptr<Widget> c_ptr_assigned{};
+        c_ptr_assigned = c_ptr_moved;
+        c_ptr_assigned.reset();
+    }
+
+    const auto report = sia::refcount_profiler::report();
+    const auto *stats = findObject(report, object);
+
+    ASSERT_NE(stats, nullptr);
+    EXPECT_EQ(stats->m_copies, 2);
+    EXPECT_EQ(stats->m_moves, 1);
+    EXPECT_EQ(stats->m_releases, 2);
+    EXPECT_EQ(stats->m_threads, 1);
+    EXPECT_FALSE(stats->m_contended);
+    EXPECT_NE(stats->m_type.find("Widget"), std::string::npos);
+}
+
+TEST_F(CheckedRefcountProfiler, NullPointersAreIgnored)
+{
+    sia::checked_shared_ptr<Widget> c_ptr{};
+    auto c_ptr_copy = c_ptr;
+    c_ptr_copy.reset();
+
+    EXPECT_TRUE(sia::refcount_profiler::report().m_objects.empty());
+}
+
+TEST_F(CheckedRefcountProfiler, AggregatesPerType)
+{
+    auto widget1 = sia::make_checked_shared<Widget>();
+    auto widget2 = sia::make_checked_shared<Widget>();
+    auto gadget = sia::make_checked_shared<Gadget>();
+
+    for (int i = 0; i < 3; ++i)
+    {
+        auto copy1 = widget1;
+        auto copy2 = widget2;
+    }
+
+    {
+        auto copy = gadget;
+    }
+
+    const auto report = sia::refcount_profiler::report();
+    ASSERT_EQ(report.m_types.size(), 2);
+    EXPECT_NE(report.m_types[0].m_type.find("Widget"), std::string::npos);
+    EXPECT_EQ(report.m_types[0].m_copies, 6);
+    EXPECT_EQ(report.m_types[0].m_releases, 6);
+    EXPECT_EQ(report.m_types[0].m_objects, 2);
+    EXPECT_NE(report.m_types[1].m_type.find("Gadget"), std::string::npos);
+    EXPECT_EQ(report.m_types[1].m_copies, 1);
+}
+
+TEST_F(CheckedRefcountProfiler, FlagsObjectsSharedAcrossThreads)
+{
+    auto shared = sia::make_checked_shared<Widget>();
+    auto local = sia::make_checked_shared<Widget>();
+    std::vector<std::thread> threads{};
+
+    for (int i = 0; i < 10; ++i)
+    {
+        auto copy = local;
+    }
+
+    for (int t = 0; t < 3; ++t)
+    {
+        threads.emplace_back(
+            [shared]
+            {
+                for (int i = 0; i < 100; ++i)
+                {
+                    auto copy = shared;
+                }
+            });
+    }
+
+    for (auto &thread : threads)
+        thread.join();
+
+    const auto report = sia::refcount_profiler::report();
+    ASSERT_EQ(report.m_objects.size(), 2);
+
+    // Contended objects are ranked first.
+    //
+    EXPECT_EQ(report.m_objects[0].m_object, shared.get());
+    EXPECT_TRUE(report.m_objects[0].m_contended);
+    EXPECT_EQ(report.m_objects[0].m_threads, 4);
+    EXPECT_EQ(report.m_objects[0].m_copies, 3 + 300);
+
+    EXPECT_EQ(report.m_objects[1].m_object, local.get());
+    EXPECT_FALSE(report.m_objects[1].m_contended);
+    EXPECT_EQ(report.m_objects[1].m_threads, 1);
+
+    sia::refcount_profiler::setContentionThreshold(5);
+    EXPECT_FALSE(sia::refcount_profiler::report().m_objects[0].m_contended);
+}
+
+TEST_F(CheckedRefcountProfiler, Dump)
+{
+    auto shared = sia::make_checked_shared<Gadget>();
+    std::thread([shared] { auto copy = shared; }).join();
+
+    std::ostringstream os{};
+    sia::refcount_profiler::dump(os);
+
+    const std::string report = os.str();
+    EXPECT_NE(report.find("1 objects, 1 types"), std::string::npos);
+    EXPECT_NE(report.find("Gadget: copies=2"), std::string::npos);
+    EXPECT_NE(report.find("CONTENDED"), std::string::npos);
+}
+
+TEST_F(CheckedRefcountProfiler, DestroyedObjectsMoveToTheirType)
+{
+    {
+        auto widget = sia::make_checked_shared<Widget>();
+        std::thread([widget] { auto copy = widget; }).join();
+
+        auto copy = widget;
+    }
+
+    const auto report = sia::refcount_profiler::report();
+    EXPECT_TRUE(report.m_objects.empty());
+
+    ASSERT_EQ(report.m_types.size(), 1);
+    EXPECT_EQ(report.m_types[0].m_objects, 1);
+    EXPECT_EQ(report.m_types[0].m_copies, 3);
+    EXPECT_EQ(report.m_types[0].m_releases, 4);
+    EXPECT_EQ(report.m_types[0].m_contended_objects, 1);
+    EXPECT_EQ(report.m_dropped_events, 0);
+}
+
+// The allocator usually hands the first address out again, the counts must not depend on it either way.
+//
+TEST_F(CheckedRefcountProfiler, ReusedAddressStartsFromZero)
+{
+    {
+        auto widget = sia::make_checked_shared<Widget>();
+
+        for (int i = 0; i < 5; ++i)
+        {
+            auto copy = widget;
+        }
+    }
+
+    auto widget = sia::make_checked_shared<Widget>();
+    auto copy = widget;
+
+    const auto report = sia::refcount_profiler::report();
+    ASSERT_EQ(report.m_objects.size(), 1);
+    EXPECT_EQ(report.m_objects[0].m_object, widget.get());
+    EXPECT_EQ(report.m_objects[0].m_copies, 1);
+    EXPECT_EQ(report.m_objects[0].m_releases, 0);
+
+    ASSERT_EQ(report.m_types.size(), 1);
+    EXPECT_EQ(report.m_types[0].m_objects, 2);
+    EXPECT_EQ(report.m_types[0].m_copies, 6);
+}
+
+// Two threads dropping the last two references at once cannot tell which one was last, the object must be collected
+// all the same.
+//
+TEST_F(CheckedRefcountProfiler, ConcurrentLastReleasesAreCollected)
+{
+    constexpr int kRounds = 50;
+
+    for (int round = 0; round < kRounds; ++round)
+    {
+        auto widget = sia::make_checked_shared<Widget>();
+        std::atomic<bool> go{false};
+        std::vector<std::thread> threads{};
+
+        for (int t = 0; t < 2; ++t)
+        {
+            threads.emplace_back(
+                [copy = widget, &go]() mutable
+                {
+                    while (!go.load())
+                        std::this_thread::yield();
+                    copy.reset();
+                });
+        }
+
+        widget.reset();
+        go = true;
+
+        for (auto &thread : threads)
+            thread.join();
+    }
+
+    const auto report = sia::refcount_profiler::report();
+    EXPECT_TRUE(report.m_objects.empty());
+
+    ASSERT_EQ(report.m_types.size(), 1);
+    EXPECT_EQ(report.m_types[0].m_objects, kRounds);
+    EXPECT_EQ(report.m_types[0].m_contended_objects, kRounds);
+}
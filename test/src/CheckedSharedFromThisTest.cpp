@@ -0,0 +1,115 @@
+#include "checked_shared_from_this.hpp"
+#include <gtest/gtest.h>
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+namespace
+{
+
+struct Widget : sia::enable_checked_shared_from_this<Widget>
+{
+    ~Widget()
+    {
+        m_self_in_destructor = checked_shared_from_this() == nullptr;
+    }
+
+    std::int32_t m_value{7};
+
+    static inline bool m_self_in_destructor{false};
+};
+
+struct Button : Widget
+{
+};
+
+}  // namespace
+
+TEST(CheckedSharedFromThis, SharesTheOwnership)
+{
+    auto widget = sia::make_checked_shared<Widget>();
+
+    {
+        sia::checked_shared_ptr<Widget> self = widget->checked_shared_from_this();
+        EXPECT_EQ(self, widget);
+        EXPECT_EQ(widget.use_count(), 2);
+
+        const Widget &const_widget = *widget;
+        sia::checked_shared_ptr<const Widget> const_self = const_widget.checked_shared_from_this();
+        EXPECT_EQ(const_self->m_value, 7);
+        EXPECT_EQ(widget.use_count(), 3);
+    }
+
+    EXPECT_EQ(widget.use_count(), 1);
+
+    // The std::enable_shared_from_this members still work on the same control block.
+    //
+    EXPECT_EQ(widget->shared_from_this().get(), widget.get());
+    EXPECT_EQ(widget->weak_from_this().use_count(), 1);
+    EXPECT_EQ(widget.shared_from_this().get(), widget.get());
+}
+
+TEST(CheckedSharedFromThis, DerivedTypes)
+{
+    std::shared_ptr<Widget> button = std::make_shared<Button>();
+    auto self = button->checked_shared_from_this();
+
+    EXPECT_EQ(self.get(), button.get());
+    EXPECT_EQ(button.use_count(), 2);
+}
+
+TEST(CheckedSharedFromThis, NotOwnedGivesNull)
+{
+    Widget on_stack;
+    auto self = on_stack.checked_shared_from_this();
+
+    EXPECT_EQ(self, nullptr);
+    EXPECT_THROW((void)self->m_value, sia::CheckedNullPtrException);
+}
+
+TEST(CheckedSharedFromThis, NullInTheDestructor)
+{
+    Widget::m_self_in_destructor = false;
+    sia::make_checked_shared<Widget>() = nullptr;
+    EXPECT_TRUE(Widget::m_self_in_destructor);
+}
+
+TEST(CheckedSharedFromThis, ViewDoesNotCount)
+{
+    auto widget = sia::make_checked_shared<Widget>();
+    sia::checked_view<Widget> view = widget->view_from_this();
+
+    EXPECT_EQ(view.get(), widget.get());
+    EXPECT_EQ(widget.use_count(), 1);
+    EXPECT_EQ(view->m_value, 7);
+
+    const Widget &const_widget = *widget;
+    sia::checked_view<const Widget> const_view = const_widget.view_from_this();
+    EXPECT_EQ(const_view.get(), widget.get());
+}
+
+TEST(CheckedSharedFromThis, ManyThreads)
+{
+    constexpr std::int32_t kCopies = 10000;
+    auto widget = sia::make_checked_shared<Widget>();
+    std::vector<std::thread> threads{};
+
+    for (int t = 0; t < 4; ++t)
+    {
+        threads.emplace_back(
+            [&widget]
+            {
+                for (std::int32_t i = 0; i < kCopies; ++i)
+                {
+                    auto self = widget->checked_shared_from_this();
+                    EXPECT_EQ(self->m_value, 7);
+                }
+            });
+    }
+
+    for (auto &thread : threads)
+        thread.join();
+
+    EXPECT_EQ(widget.use_count(), 1);
+}
@@ -1,6 +1,8 @@
 #include "checked_shared_ptr.hpp"
 #include <gtest/gtest.h>
+#include <array>
 #include <memory>
+#include <memory_resource>
 
 struct BasicClass
 {
@@ -261,14 +263,8 @@ TEST(CheckedSharedPtr, DefaultMoveAssignment)
 
     c_ptr_derived_other = std::move(c_ptr_derived);
 
-    // Rvalue overload of shared pointer is supported after C++17. As a result we do not have that support.
-    // So the following will be true.
-    //
-    EXPECT_TRUE(c_ptr_derived.get() == c_ptr_derived_other.get());
-
-    // Rvalue overload is not triggered because it is not supported by std::shared_ptr
-    //
-    EXPECT_TRUE(c_ptr_derived.get() != nullptr);
+    EXPECT_TRUE(c_ptr_derived.get() != c_ptr_derived_other.get());
+    EXPECT_TRUE(c_ptr_derived.get() == nullptr);
 }
 
 TEST(CheckedSharedPtr, ConversionMoveAssignment)
@@ -338,7 +334,9 @@ TEST(CheckedSharedPtr, LessOperator)
     c_ptr2->m_id = 100;
     c_ptr2->m_name = "sia";
 
-    EXPECT_FALSE(c_ptr1 < c_ptr2);
+    // The order of two allocations depends on the heap, compare against the raw pointers.
+    //
+    EXPECT_EQ(c_ptr1 < c_ptr2, std::less<PlainObject *>()(c_ptr1.get(), c_ptr2.get()));
     c_ptr1 = nullptr;
     EXPECT_FALSE(c_ptr1 < nullptr);
     EXPECT_FALSE(nullptr < c_ptr2);
@@ -355,7 +353,9 @@ TEST(CheckedSharedPtr, GreaterOperator)
     c_ptr2->m_id = 100;
     c_ptr2->m_name = "sia";
 
-    EXPECT_TRUE(c_ptr2 > c_ptr1);
+    // The order of two allocations depends on the heap, compare against the raw pointers.
+    //
+    EXPECT_EQ(c_ptr2 > c_ptr1, std::less<PlainObject *>()(c_ptr1.get(), c_ptr2.get()));
     c_ptr1 = nullptr;
     EXPECT_FALSE(c_ptr1 > nullptr);
     EXPECT_FALSE(nullptr > c_ptr2);
@@ -405,10 +405,98 @@ TEST(CheckedSharedPtr, Swap)
     EXPECT_TRUE(c_ptr2->m_name == "john");
 }
 
+TEST(CheckedSharedPtr, SameSizeAsSharedPtr)
+{
+    struct EnabledObject : public std::enable_shared_from_this<EnabledObject>
+    {
+    };
+
+    static_assert(sizeof(sia::checked_shared_ptr<Base>) == sizeof(std::shared_ptr<Base>));
+    static_assert(sizeof(sia::checked_shared_ptr<EnabledObject>) == sizeof(std::shared_ptr<EnabledObject>));
+    static_assert(!std::is_polymorphic_v<sia::checked_shared_ptr<Base>>);
+    static_assert(!std::is_polymorphic_v<sia::checked_shared_ptr<EnabledObject>>);
+}
+
+TEST(CheckedSharedPtr, AllocateCheckedShared)
+{
+    auto c_ptr1 = sia::allocate_checked_shared<PlainObject>(std::allocator<PlainObject>{});
+    EXPECT_TRUE(c_ptr1 != nullptr);
+    EXPECT_EQ(c_ptr1.use_count(), 1);
+
+    std::array<std::byte, 1024> buffer{};
+    std::pmr::monotonic_buffer_resource arena{buffer.data(), buffer.size(), std::pmr::null_memory_resource()};
+
+    auto c_ptr2 = sia::allocate_checked_shared<PlainObject>(std::pmr::polymorphic_allocator<PlainObject>{&arena});
+    c_ptr2->m_id = 100;
+
+    auto *raw = reinterpret_cast<std::byte *>(c_ptr2.get());
+    EXPECT_TRUE(raw >= buffer.data() && raw < buffer.data() + buffer.size());
+    EXPECT_EQ(c_ptr2->m_id, 100);
+}
+
 TEST(CheckedSharedPtr, NullPtrAccess)
 {
     auto c_ptr1 = sia::make_checked_shared<PlainObject>();
     c_ptr1 = nullptr;
     EXPECT_THROW(c_ptr1->m_name = "empty", sia::CheckedNullPtrException);
     EXPECT_THROW(*c_ptr1, sia::CheckedNullPtrException);
-}
\ No newline at end of file
+}
+
+struct CallbackException : std::exception
+{
+};
+
+void throwCallbackException()
+{
+    throw CallbackException();
+}
+
+TEST(CheckedSharedPtr, UncheckedPolicy)
+{
+    sia::checked_shared_ptr<PlainObject, sia::unchecked> c_ptr1{sia::make_checked_shared<PlainObject>()};
+
+    static_assert(noexcept(c_ptr1.operator->()));
+    static_assert(noexcept(*c_ptr1));
+    static_assert(sizeof(c_ptr1) == sizeof(std::shared_ptr<PlainObject>));
+
+    c_ptr1->m_id = 100;
+    EXPECT_EQ(c_ptr1->m_id, 100);
+}
+
+TEST(CheckedSharedPtr, CallbackPolicy)
+{
+    sia::checked_shared_ptr<PlainObject, sia::callback_on_null<throwCallbackException>> c_ptr1{};
+
+    static_assert(!noexcept(c_ptr1.operator->()));
+    EXPECT_THROW(c_ptr1->m_name = "empty", CallbackException);
+    EXPECT_THROW(*c_ptr1, CallbackException);
+}
+
+TEST(CheckedSharedPtr, AbortPolicy)
+{
+    sia::checked_shared_ptr<PlainObject, sia::abort_on_null> c_ptr1{};
+
+    static_assert(noexcept(c_ptr1.operator->()));
+    EXPECT_DEATH(c_ptr1->m_id = 100, "");
+}
+
+TEST(CheckedSharedPtr, TrapPolicy)
+{
+    sia::checked_shared_ptr<PlainObject, sia::trap_on_null> c_ptr1{};
+
+    static_assert(noexcept(*c_ptr1));
+    EXPECT_DEATH((*c_ptr1).m_id = 100, "");
+}
+
+TEST(CheckedSharedPtr, MixedPolicies)
+{
+    auto c_ptr1 = sia::make_checked_shared<PlainObject>();
+    sia::checked_shared_ptr<PlainObject, sia::abort_on_null> c_ptr2{c_ptr1};
+    sia::checked_shared_ptr<PlainObject, sia::unchecked> c_ptr3{};
+
+    c_ptr3 = c_ptr2;
+
+    EXPECT_EQ(c_ptr1, c_ptr2);
+    EXPECT_EQ(c_ptr2, c_ptr3);
+    EXPECT_EQ(c_ptr1.use_count(), 3);
+}
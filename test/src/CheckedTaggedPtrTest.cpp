@@ -0,0 +1,182 @@
+#include "checked_tagged_ptr.hpp"
+#include <gtest/gtest.h>
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+namespace
+{
+
+struct Entry
+{
+    explicit Entry(std::int64_t key = 0) : m_key(key)
+    {
+        ++s_live;
+    }
+
+    ~Entry()
+    {
+        --s_live;
+    }
+
+    std::int64_t m_key;
+
+    static inline std::atomic<std::int64_t> s_live{0};
+};
+
+struct alignas(16) Wide
+{
+    std::int64_t m_first{};
+    std::int64_t m_second{};
+};
+
+using TaggedEntry = sia::tagged_checked_shared_ptr<Entry>;
+
+}  // namespace
+
+static_assert(sizeof(TaggedEntry) == sizeof(std::shared_ptr<Entry>));
+static_assert(TaggedEntry::kLowTagBits == 3 && TaggedEntry::kTagBits == 19);
+static_assert(sia::tagged_checked_shared_ptr<Wide>::kLowTagBits == 4);
+static_assert(sia::tagged_checked_shared_ptr<char>::kMaxTag == 0xFFFF);
+static_assert(noexcept(*std::declval<sia::tagged_checked_shared_ptr<Entry, sia::abort_on_null> &>()));
+
+TEST(TaggedCheckedSharedPtr, TagDoesNotChangeThePointer)
+{
+    auto entry = sia::make_checked_shared<Entry>(5);
+    TaggedEntry tagged{entry};
+
+    EXPECT_EQ(tagged.tag(), 0);
+    EXPECT_EQ(tagged.get(), entry.get());
+
+    for (const TaggedEntry::tag_type tag : {TaggedEntry::tag_type{1}, TaggedEntry::tag_type{7},
+                                            TaggedEntry::tag_type{8}, TaggedEntry::tag_type{0x5BCDE},
+                                            TaggedEntry::kMaxTag})
+    {
+        tagged.set_tag(tag);
+        EXPECT_EQ(tagged.tag(), tag);
+        EXPECT_EQ(tagged.get(), entry.get());
+        EXPECT_EQ(tagged->m_key, 5);
+        EXPECT_EQ(tagged.use_count(), 2);
+    }
+}
+
+TEST(TaggedCheckedSharedPtr, SharesOwnership)
+{
+    {
+        TaggedEntry tagged{sia::make_checked_shared<Entry>(1), 3};
+        EXPECT_EQ(tagged.use_count(), 1);
+
+        TaggedEntry copy = tagged;
+        EXPECT_EQ(copy.tag(), 3);
+        EXPECT_EQ(tagged.use_count(), 2);
+
+        sia::checked_shared_ptr<Entry> plain = copy.untagged();
+        EXPECT_EQ(plain.get(), tagged.get());
+        EXPECT_EQ(plain.use_count(), 3);
+
+        copy.reset();
+        EXPECT_EQ(tagged.use_count(), 2);
+    }
+
+    EXPECT_EQ(Entry::s_live, 0);
+}
+
+TEST(TaggedCheckedSharedPtr, NullCheckIgnoresTheTag)
+{
+    TaggedEntry tagged{};
+    EXPECT_THROW(tagged->m_key, sia::CheckedNullPtrException);
+
+    tagged.set_tag(1);
+    EXPECT_EQ(tagged.tag(), 1);
+    EXPECT_FALSE(tagged);
+    EXPECT_TRUE(tagged == nullptr);
+    EXPECT_THROW(*tagged, sia::CheckedNullPtrException);
+
+    TaggedEntry tagged_high{nullptr};
+    tagged_high.set_tag(TaggedEntry::kMaxTag);
+    EXPECT_EQ(tagged_high.get(), nullptr);
+    EXPECT_THROW(tagged_high->m_key, sia::CheckedNullPtrException);
+    EXPECT_TRUE(tagged_high.untagged() == nullptr);
+}
+
+TEST(TaggedCheckedSharedPtr, EqualityIncludesTheTag)
+{
+    auto entry = sia::make_checked_shared<Entry>(1);
+    TaggedEntry lhs{entry, 1};
+    TaggedEntry rhs{entry, 2};
+
+    EXPECT_NE(lhs, rhs);
+    rhs.set_tag(1);
+    EXPECT_EQ(lhs, rhs);
+    EXPECT_FALSE(lhs.owner_before(rhs) || rhs.owner_before(lhs));
+}
+
+TEST(AtomicTaggedCheckedSharedPtr, CompareExchangeOnPointerAndTag)
+{
+    auto entry = sia::make_checked_shared<Entry>(1);
+    sia::atomic_tagged_checked_shared_ptr<Entry> slot{TaggedEntry{entry, 1}};
+
+    // Same pointer, stale tag.
+    //
+    TaggedEntry expected{entry, 0};
+    EXPECT_FALSE(slot.compare_exchange_strong(expected, TaggedEntry{entry, 2}));
+    EXPECT_EQ(expected.tag(), 1);
+
+    EXPECT_TRUE(slot.compare_exchange_strong(expected, TaggedEntry{entry, 2}));
+    EXPECT_EQ(slot.load().tag(), 2);
+    EXPECT_EQ(slot.load().get(), entry.get());
+}
+
+TEST(AtomicTaggedCheckedSharedPtr, TaggedNullIsNotEmpty)
+{
+    sia::atomic_tagged_checked_shared_ptr<Entry> slot{};
+
+    TaggedEntry tagged_null{};
+    tagged_null.set_tag(4);
+    slot.store(tagged_null);
+    EXPECT_EQ(slot.load().tag(), 4);
+
+    TaggedEntry expected{};
+    EXPECT_FALSE(slot.compare_exchange_strong(expected, nullptr));
+    EXPECT_EQ(expected.tag(), 4);
+    EXPECT_TRUE(slot.compare_exchange_strong(expected, nullptr));
+    EXPECT_EQ(slot.load().tag(), 0);
+}
+
+TEST(AtomicTaggedCheckedSharedPtr, ConcurrentVersionBumps)
+{
+    constexpr int kThreads = 4;
+    constexpr int kBumps = 2000;
+
+    {
+        sia::atomic_tagged_checked_shared_ptr<Entry> slot{TaggedEntry{sia::make_checked_shared<Entry>(0)}};
+        std::vector<std::thread> threads{};
+
+        for (int t = 0; t < kThreads; ++t)
+        {
+            threads.emplace_back(
+                [&slot]
+                {
+                    for (int i = 0; i < kBumps; ++i)
+                    {
+                        TaggedEntry expected = slot.load();
+                        TaggedEntry desired{};
+                        do
+                        {
+                            desired = expected;
+                            desired.set_tag(expected.tag() + 1);
+                        } while (!slot.compare_exchange_weak(expected, desired));
+                    }
+                });
+        }
+
+        for (auto &thread : threads)
+            thread.join();
+
+        EXPECT_EQ(slot.load().tag(), kThreads * kBumps);
+        EXPECT_EQ(slot.load()->m_key, 0);
+    }
+
+    EXPECT_EQ(Entry::s_live, 0);
+}
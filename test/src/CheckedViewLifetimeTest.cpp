@@ -0,0 +1,39 @@
+#include "checked_view.hpp"
+#include <gtest/gtest.h>
+
+// Built as an executable of its own with SIA_CSP_CHECK_VIEW_LIFETIME=1, see test/CMakeLists.txt.
+//
+namespace
+{
+
+struct Session
+{
+    std::int32_t m_id{};
+};
+
+}  // namespace
+
+#ifndef NDEBUG
+TEST(CheckedViewLifetime, OwnerAlive)
+{
+    auto c_ptr = sia::make_checked_shared<Session>();
+    sia::checked_view<Session> view{c_ptr};
+
+    view->m_id = 1;
+    EXPECT_EQ(c_ptr->m_id, 1);
+
+    Session session{};
+    sia::checked_view<Session> untracked{&session};
+    untracked->m_id = 2;
+    EXPECT_EQ(session.m_id, 2);
+}
+
+TEST(CheckedViewLifetime, OwnerGone)
+{
+    auto c_ptr = sia::make_checked_shared<Session>();
+    sia::checked_view<Session> view{c_ptr};
+    c_ptr = nullptr;
+
+    EXPECT_DEATH(view->m_id = 1, "outlived its owner");
+}
+#endif
@@ -0,0 +1,80 @@
+#include "checked_view.hpp"
+#include <gtest/gtest.h>
+#include <unordered_set>
+
+namespace
+{
+
+struct Account
+{
+    std::int64_t m_balance{};
+};
+
+struct SavingsAccount final : Account
+{
+};
+
+std::int64_t balanceOf(sia::checked_view<const Account> account)
+{
+    return account->m_balance;
+}
+
+}  // namespace
+
+TEST(CheckedView, TriviallyCopyable)
+{
+    static_assert(std::is_trivially_copyable_v<sia::checked_view<Account>>);
+    static_assert(sizeof(sia::checked_view<Account>) == sizeof(void *));
+    static_assert(!std::is_constructible_v<sia::checked_view<Account>, sia::checked_shared_ptr<Account> &&>);
+}
+
+TEST(CheckedView, FromCheckedSharedPtr)
+{
+    auto c_ptr = sia::make_checked_shared<Account>();
+    c_ptr->m_balance = 100;
+
+    sia::checked_view<Account> view{c_ptr};
+    EXPECT_EQ(view.get(), c_ptr.get());
+    EXPECT_EQ(c_ptr.use_count(), 1);
+
+    view->m_balance = 200;
+    EXPECT_EQ(balanceOf(c_ptr), 200);
+    EXPECT_EQ(balanceOf(view), 200);
+    EXPECT_EQ(c_ptr.use_count(), 1);
+}
+
+TEST(CheckedView, Conversion)
+{
+    auto c_ptr = sia::make_checked_shared<SavingsAccount>();
+    sia::checked_view<SavingsAccount> view{c_ptr};
+    sia::checked_view<const Account> view_base = view;
+
+    EXPECT_EQ(view_base.get(), c_ptr.get());
+    EXPECT_EQ(view_base, view);
+}
+
+TEST(CheckedView, Comparison)
+{
+    Account account1{};
+    Account account2{};
+    sia::checked_view<Account> view1{&account1};
+    sia::checked_view<Account> view2{&account2};
+
+    EXPECT_NE(view1, view2);
+    EXPECT_EQ(view1 < view2, &account1 < &account2);
+    EXPECT_TRUE(view1 != nullptr);
+    EXPECT_TRUE(sia::checked_view<Account>{} == nullptr);
+
+    std::unordered_set<sia::checked_view<Account>> set{view1, view2, view1};
+    EXPECT_EQ(set.size(), 2);
+}
+
+TEST(CheckedView, NullPtrAccess)
+{
+    sia::checked_shared_ptr<Account> c_ptr{};
+    sia::checked_view<Account> view{c_ptr};
+
+    EXPECT_THROW(view->m_balance = 1, sia::CheckedNullPtrException);
+    EXPECT_THROW(*view, sia::CheckedNullPtrException);
+    EXPECT_THROW(balanceOf(c_ptr), sia::CheckedNullPtrException);
+}
@@ -0,0 +1,122 @@
+#include "checked_shared_ptr.hpp"
+#include <gtest/gtest.h>
+
+namespace
+{
+
+struct CacheEntry
+{
+    std::int32_t m_id{};
+};
+
+struct DerivedCacheEntry final : CacheEntry
+{
+};
+
+struct EnabledCacheEntry : public std::enable_shared_from_this<EnabledCacheEntry>
+{
+    std::int32_t m_id{};
+};
+
+}  // namespace
+
+TEST(CheckedWeakPtr, DefaultCtor)
+{
+    sia::checked_weak_ptr<CacheEntry> w_ptr{};
+
+    EXPECT_TRUE(w_ptr.expired());
+    EXPECT_EQ(w_ptr.use_count(), 0);
+    EXPECT_TRUE(w_ptr.lock() == nullptr);
+}
+
+TEST(CheckedWeakPtr, CtorFromCheckedSharedPtr)
+{
+    auto c_ptr = sia::make_checked_shared<CacheEntry>();
+    sia::checked_weak_ptr<CacheEntry> w_ptr{c_ptr};
+
+    // Observing must not bump the use count.
+    //
+    EXPECT_EQ(c_ptr.use_count(), 1);
+    EXPECT_FALSE(w_ptr.expired());
+    EXPECT_EQ(w_ptr.use_count(), 1);
+}
+
+TEST(CheckedWeakPtr, ConversionCtor)
+{
+    auto c_ptr = sia::make_checked_shared<DerivedCacheEntry>();
+    sia::checked_weak_ptr<CacheEntry> w_ptr{c_ptr};
+    sia::checked_weak_ptr<const CacheEntry> w_ptr_const{w_ptr};
+
+    EXPECT_EQ(w_ptr.lock().get(), c_ptr.get());
+    EXPECT_EQ(w_ptr_const.lock().get(), c_ptr.get());
+}
+
+TEST(CheckedWeakPtr, Lock)
+{
+    auto c_ptr = sia::make_checked_shared<CacheEntry>();
+    sia::checked_weak_ptr<CacheEntry> w_ptr{};
+    w_ptr = c_ptr;
+
+    {
+        auto locked = w_ptr.lock();
+        EXPECT_EQ(locked, c_ptr);
+        EXPECT_EQ(c_ptr.use_count(), 2);
+    }
+
+    c_ptr = nullptr;
+    EXPECT_TRUE(w_ptr.expired());
+    EXPECT_TRUE(w_ptr.lock() == nullptr);
+}
+
+TEST(CheckedWeakPtr, LockOrThrow)
+{
+    auto c_ptr = sia::make_checked_shared<CacheEntry>();
+    sia::checked_weak_ptr<CacheEntry> w_ptr{c_ptr};
+
+    EXPECT_EQ(w_ptr.lock_or_throw()->m_id, 0);
+
+    c_ptr.reset();
+    EXPECT_THROW(w_ptr.lock_or_throw(), sia::CheckedNullPtrException);
+
+    sia::checked_weak_ptr<CacheEntry, sia::abort_on_null> w_ptr_abort{w_ptr.managedWeakPointer()};
+    static_assert(noexcept(w_ptr_abort.lock_or_throw()));
+    EXPECT_DEATH(w_ptr_abort.lock_or_throw(), "");
+}
+
+TEST(CheckedWeakPtr, ResetAndSwap)
+{
+    auto c_ptr1 = sia::make_checked_shared<CacheEntry>();
+    auto c_ptr2 = sia::make_checked_shared<CacheEntry>();
+    sia::checked_weak_ptr<CacheEntry> w_ptr1{c_ptr1};
+    sia::checked_weak_ptr<CacheEntry> w_ptr2{c_ptr2};
+
+    sia::swap(w_ptr1, w_ptr2);
+    EXPECT_EQ(w_ptr1.lock(), c_ptr2);
+    EXPECT_EQ(w_ptr2.lock(), c_ptr1);
+
+    w_ptr1.reset();
+    EXPECT_TRUE(w_ptr1.expired());
+}
+
+TEST(CheckedWeakPtr, OwnerBefore)
+{
+    auto c_ptr = sia::make_checked_shared<CacheEntry>();
+    sia::checked_weak_ptr<CacheEntry> w_ptr1{c_ptr};
+    sia::checked_weak_ptr<CacheEntry> w_ptr2{c_ptr};
+
+    EXPECT_FALSE(w_ptr1.owner_before(w_ptr2));
+    EXPECT_FALSE(w_ptr2.owner_before(w_ptr1));
+    EXPECT_FALSE(w_ptr1.owner_before(c_ptr));
+}
+
+TEST(CheckedWeakPtr, WeakFromThis)
+{
+    sia::checked_shared_ptr<EnabledCacheEntry> c_ptr = std::make_shared<EnabledCacheEntry>();
+
+    auto w_ptr = c_ptr.weak_from_this();
+    EXPECT_EQ(c_ptr.use_count(), 1);
+    EXPECT_EQ(w_ptr.lock(), c_ptr);
+
+    sia::checked_shared_ptr<EnabledCacheEntry> c_ptr_null{};
+    EXPECT_TRUE(c_ptr_null.weak_from_this().expired());
+}
@@ -0,0 +1,167 @@
+#include "checked_shared_ptr.hpp"
+#include <gtest/gtest.h>
+#include <optional>
+#include <unordered_set>
+
+namespace
+{
+
+struct Particle
+{
+    std::int32_t m_x{};
+    std::int32_t m_y{};
+};
+
+struct ChargedParticle final : Particle
+{
+    std::int32_t m_charge{};
+};
+
+template <typename T, typename = void>
+struct HasReset : std::false_type
+{
+};
+
+template <typename T>
+struct HasReset<T, std::void_t<decltype(std::declval<T &>().reset())>> : std::true_type
+{
+};
+
+}  // namespace
+
+using NotNullParticle = sia::not_null_checked_shared_ptr<Particle>;
+
+static_assert(!std::is_default_constructible_v<NotNullParticle>);
+static_assert(!std::is_constructible_v<NotNullParticle, std::nullptr_t>);
+static_assert(!std::is_constructible_v<NotNullParticle, sia::checked_shared_ptr<Particle>>);
+static_assert(!std::is_default_constructible_v<sia::detail::not_null_access>);
+static_assert(!std::is_assignable_v<NotNullParticle &, std::nullptr_t>);
+static_assert(!HasReset<NotNullParticle>::value);
+static_assert(noexcept(std::declval<NotNullParticle &>().operator->()));
+static_assert(noexcept(*std::declval<NotNullParticle &>()));
+static_assert(sizeof(NotNullParticle) == sizeof(std::shared_ptr<Particle>));
+static_assert(std::is_same_v<decltype(sia::make_not_null_checked_shared<Particle>()), NotNullParticle>);
+static_assert(noexcept(std::declval<sia::checked_shared_ptr<Particle> &>().try_non_null()));
+static_assert(std::is_same_v<decltype(std::declval<sia::checked_shared_ptr<Particle> &>().try_non_null()),
+                             std::optional<NotNullParticle>>);
+
+TEST(NotNullCheckedSharedPtr, NonNullFromLvalue)
+{
+    auto c_ptr = sia::make_checked_shared<Particle>();
+    auto nn_ptr = c_ptr.non_null();
+
+    EXPECT_EQ(nn_ptr.get(), c_ptr.get());
+    EXPECT_EQ(c_ptr.use_count(), 2);
+    EXPECT_TRUE(static_cast<bool>(nn_ptr));
+
+    nn_ptr->m_x = 7;
+    EXPECT_EQ((*c_ptr).m_x, 7);
+}
+
+TEST(NotNullCheckedSharedPtr, NonNullFromRvalue)
+{
+    auto c_ptr = sia::make_checked_shared<Particle>();
+    Particle *raw = c_ptr.get();
+
+    auto nn_ptr = std::move(c_ptr).non_null();
+
+    EXPECT_EQ(nn_ptr.get(), raw);
+    EXPECT_EQ(nn_ptr.use_count(), 1);
+    EXPECT_TRUE(c_ptr == nullptr);  //NOLINT(bugprone-use-after-move)
+}
+
+TEST(NotNullCheckedSharedPtr, NonNullOnNullThrows)
+{
+    sia::checked_shared_ptr<Particle> c_ptr{};
+
+    EXPECT_THROW(c_ptr.non_null(), sia::CheckedNullPtrException);
+    EXPECT_THROW(std::move(c_ptr).non_null(), sia::CheckedNullPtrException);
+
+    sia::checked_shared_ptr<Particle, sia::abort_on_null> c_ptr_abort{};
+    EXPECT_DEATH(c_ptr_abort.non_null(), "");
+}
+
+TEST(NotNullCheckedSharedPtr, MoveLeavesSourceValid)
+{
+    auto nn_ptr = sia::make_checked_shared<Particle>().non_null();
+    auto nn_ptr_moved = std::move(nn_ptr);
+
+    EXPECT_EQ(nn_ptr.get(), nn_ptr_moved.get());  //NOLINT(bugprone-use-after-move)
+    EXPECT_EQ(nn_ptr.use_count(), 2);             //NOLINT(bugprone-use-after-move)
+
+    auto nn_ptr_other = sia::make_checked_shared<Particle>().non_null();
+    nn_ptr_other = std::move(nn_ptr_moved);
+    EXPECT_EQ(nn_ptr_moved.get(), nn_ptr_other.get());  //NOLINT(bugprone-use-after-move)
+}
+
+TEST(NotNullCheckedSharedPtr, ConversionAndDecay)
+{
+    auto nn_ptr = sia::make_checked_shared<ChargedParticle>().non_null();
+    sia::not_null_checked_shared_ptr<Particle> nn_ptr_base{nn_ptr};
+    EXPECT_EQ(nn_ptr_base.get(), nn_ptr.get());
+
+    const sia::checked_shared_ptr<Particle> &c_ptr = nn_ptr_base;
+    EXPECT_EQ(c_ptr.get(), nn_ptr.get());
+    EXPECT_EQ(nn_ptr_base.nullable(), c_ptr);
+}
+
+TEST(NotNullCheckedSharedPtr, ComparisonAndHash)
+{
+    auto nn_ptr1 = sia::make_checked_shared<Particle>().non_null();
+    auto nn_ptr2 = sia::make_checked_shared<Particle>().non_null();
+    auto nn_ptr1_copy = nn_ptr1;
+
+    EXPECT_TRUE(nn_ptr1 == nn_ptr1_copy);
+    EXPECT_TRUE(nn_ptr1 != nn_ptr2);
+    EXPECT_NE(nn_ptr1 < nn_ptr2, nn_ptr2 < nn_ptr1);
+
+    sia::swap(nn_ptr1, nn_ptr2);
+    EXPECT_TRUE(nn_ptr2 == nn_ptr1_copy);
+
+    std::unordered_set<NotNullParticle> set{nn_ptr1, nn_ptr2, nn_ptr1_copy};
+    EXPECT_EQ(set.size(), 2);
+}
+
+TEST(NotNullCheckedSharedPtr, MakeNotNull)
+{
+    auto nn_ptr = sia::make_not_null_checked_shared<Particle>(Particle{1, 2});
+    EXPECT_EQ(nn_ptr->m_y, 2);
+    EXPECT_EQ(nn_ptr.use_count(), 1);
+
+    auto nn_ptr_allocated = sia::allocate_not_null_checked_shared<ChargedParticle>(std::allocator<ChargedParticle>{});
+    EXPECT_EQ(nn_ptr_allocated->m_charge, 0);
+
+    // Decays on assignment to a nullable pointer, which may then be reset as usual.
+    //
+    sia::checked_shared_ptr<Particle> c_ptr = nn_ptr;
+    EXPECT_EQ(c_ptr.get(), nn_ptr.get());
+    EXPECT_EQ(nn_ptr.use_count(), 2);
+
+    c_ptr = nullptr;
+    EXPECT_EQ(nn_ptr.use_count(), 1);
+}
+
+TEST(NotNullCheckedSharedPtr, TryNonNull)
+{
+    auto c_ptr = sia::make_checked_shared<Particle>();
+
+    if (auto nn_ptr = c_ptr.try_non_null())
+    {
+        (*nn_ptr)->m_x = 3;
+        EXPECT_EQ(c_ptr.use_count(), 2);
+    }
+    else
+    {
+        ADD_FAILURE();
+    }
+
+    EXPECT_EQ(c_ptr->m_x, 3);
+
+    auto moved = std::move(c_ptr).try_non_null();
+    ASSERT_TRUE(moved.has_value());
+    EXPECT_EQ(moved->use_count(), 1);
+
+    sia::checked_shared_ptr<Particle> null_ptr{};
+    EXPECT_FALSE(null_ptr.try_non_null().has_value());
+    EXPECT_FALSE(std::move(null_ptr).try_non_null().has_value());
+}